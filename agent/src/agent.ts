@@ -1,4 +1,5 @@
 import { CModuleTracer, HookMode, type FunctionTarget } from './cmodule-tracer.js';
+import { ObjectSerializer } from './object-serializer.js';
 import { createPlatformAdapter, type PlatformAdapter } from './platform.js';
 import { RateTracker } from './rate-tracker.js';
 import { findGlobalExport } from './utils.js';
@@ -10,14 +11,17 @@ import { JscTracer } from './tracers/jsc-tracer.js';
 
 interface HookInstruction {
   action: 'add' | 'remove';
-  functions?: FunctionTarget[];  // Address-based targets (native)
+  // Address-based targets (native). Per-entry mode lets full and light
+  // hooks arrive in one bulk message (one interceptor pass per message).
+  functions?: Array<FunctionTarget & { mode?: HookMode }>;
   targets?: Array<{              // file:line-based targets (interpreted)
     file: string;
     line: number;
     name: string;
+    mode?: HookMode;
   }>;
   imageBase?: string;
-  mode?: HookMode;
+  mode?: HookMode;               // Fallback for entries without a mode
   serializationDepth?: number;
 }
 
@@ -57,6 +61,13 @@ interface CrashEvent {
   throwBacktrace?: BacktraceFrame[];
 }
 
+// Byte reads above this size stream out as binary frames (send()'s
+// out-of-band data payload) instead of hex-in-JSON — hex doubles the size
+// and the JSON channel re-parses the whole string on the daemon side.
+const LARGE_READ_STREAM_THRESHOLD = 256 * 1024;
+// Frame size for streamed reads. Bounds peak allocation on both sides.
+const READ_STREAM_CHUNK_BYTES = 4 * 1024 * 1024;
+
 interface ReadRecipe {
   label: string;
   address: string;  // hex
@@ -103,6 +114,15 @@ interface WatchInstruction {
     isGlobal: boolean;
     onPatterns?: string[];
   }>;
+  /** Timer-driven sampling interval for the CModule watch sampler (µs). Absent/0 disables. */
+  sampleIntervalUs?: number;
+}
+
+/** Lazy argument serialization request: sent by the daemon at query time for
+ * the captured pointers of events actually being inspected. */
+interface SerializeArgsMessage {
+  pointers: string[];
+  depth?: number;
 }
 
 // Phase 2: Breakpoint interfaces
@@ -387,20 +407,33 @@ class StrobeAgent {
     this.rateTracker = new RateTracker(
       this.funcIdToName,
       (funcId: number, enabled: boolean, rate: number) => {
+        // Hot functions degrade to in-CModule aggregation when available:
+        // complete statistics (count, min/max/mean, latency histogram) as
+        // periodic aggregate_summary events instead of a sampled trace.
+        // Without a CModule, fall back to the native sampling rule table.
+        const aggregating = this.cmoduleTracer.supportsAggregation();
+        if (aggregating) {
+          this.cmoduleTracer.setFuncAggregation(funcId, enabled);
+        } else {
+          this.cmoduleTracer.setFuncSampling(funcId, enabled ? Math.round(1 / rate) : 0);
+        }
         send({
           type: 'sampling_state_change',
           funcId,
           funcName: this.funcIdToName.get(funcId) || `func_${funcId}`,
           enabled,
           sampleRate: rate,
+          mode: aggregating ? 'aggregate' : 'sample',
         });
       },
       (message: string) => {
         send({ type: 'log', message });
-      }
+      },
+      // Per-call counting happens in the CModule; pull the counters per window
+      () => this.cmoduleTracer.collectFuncCounts()
     );
 
-    // Wire rate tracker into the CModule tracer drain loop
+    // JS fallback hooks (no CModule) still rate-check per event during drain
     const tracker = this.rateTracker;
     this.cmoduleTracer.setRateCheck((funcId: number) => tracker.recordCall(funcId));
 
@@ -449,7 +482,8 @@ class StrobeAgent {
               nameRaw: func.nameRaw,
               sourceFile: func.sourceFile,
               lineNumber: func.lineNumber,
-            }, mode);
+              predicate: func.predicate,
+            }, func.mode || mode);
             if (funcId !== null) {
               this.funcIdToName.set(funcId, func.name);
               this.funcIdToAddress.set(funcId, func.address);
@@ -468,7 +502,7 @@ class StrobeAgent {
               file: target.file,
               line: target.line,
               name: target.name,
-            }, mode);
+            }, target.mode || mode);
             if (funcId !== null) {
               this.funcIdToName.set(funcId, target.name);
               this.fileLineToFuncId.set(`${target.file}:${target.line}`, funcId);
@@ -529,6 +563,7 @@ class StrobeAgent {
       if (message.exprWatches) {
         this.cmoduleTracer.updateExprWatches(message.exprWatches);
       }
+      this.cmoduleTracer.setWatchSampling(message.sampleIntervalUs ?? 0);
       const totalCount = message.watches.length + (message.exprWatches ? message.exprWatches.length : 0);
       send({ type: 'watches_updated', activeCount: totalCount });
     } catch (e: any) {
@@ -537,6 +572,42 @@ class StrobeAgent {
     }
   }
 
+  /**
+   * Serialize captured argument pointers on demand. Capture stores raw hex
+   * only; this runs when an event is actually queried, so the hot path never
+   * pays for serialization. Pointers whose memory is no longer mapped (the
+   * allocation died since capture) report '<stale>'.
+   */
+  handleSerializeArgs(message: SerializeArgsMessage): void {
+    const depth = message.depth ?? (this.cmoduleTracer.getSerializationDepth() || 3);
+    const serializer = new ObjectSerializer(Math.max(1, Math.min(depth, 10)));
+    const results = message.pointers.map(hex => {
+      try {
+        const addr = ptr(hex);
+        if (addr.isNull()) {
+          return { label: hex, value: hex };
+        }
+        const range = Process.findRangeByAddress(addr);
+        if (!range || !range.protection.includes('r')) {
+          return { label: hex, value: '<stale>' };
+        }
+        // Without DWARF type info for arguments, treat as generic pointer —
+        // the same shape the old eager path produced.
+        const serialized = serializer.serialize(addr, {
+          typeKind: 'pointer', byteSize: 8, typeName: 'void*',
+        });
+        serializer.reset();
+        return {
+          label: hex,
+          value: typeof serialized === 'string' ? serialized : JSON.stringify(serialized),
+        };
+      } catch (_e) {
+        return { label: hex, value: '<stale>' };
+      }
+    });
+    send({ type: 'read_response', results });
+  }
+
   private bufferOutputEvent(event: OutputEvent): void {
     this.outputBuffer.push(event);
 
@@ -931,6 +1002,9 @@ class StrobeAgent {
 
       // Simple direct read
       if (recipe.typeKind === 'bytes') {
+        if (recipe.size > LARGE_READ_STREAM_THRESHOLD) {
+          return this.streamBytesRead(recipe.label, baseAddr, recipe.size);
+        }
         const bytes = baseAddr.readByteArray(recipe.size);
         if (!bytes) return { label: recipe.label, error: 'Failed to read bytes' };
         return { label: recipe.label, value: _arrayBufferToHex(bytes), isBytes: true };
@@ -943,6 +1017,26 @@ class StrobeAgent {
     }
   }
 
+  /**
+   * Stream a large byte read as binary frames. Chunks go out via send()'s
+   * data payload (never hex-encoded in the script), ordered before the
+   * read_response that carries this placeholder; the daemon reassembles
+   * them by label. Chunked reads keep peak allocation at one frame.
+   */
+  private streamBytesRead(label: string, baseAddr: NativePointer, size: number): any {
+    let offset = 0;
+    while (offset < size) {
+      const len = Math.min(READ_STREAM_CHUNK_BYTES, size - offset);
+      const chunk = baseAddr.add(offset).readByteArray(len);
+      if (!chunk) {
+        return { label, error: `Failed to read bytes at offset ${offset}` };
+      }
+      send({ type: 'read_chunk', label, offset, totalSize: size }, chunk);
+      offset += len;
+    }
+    return { label, chunked: true, totalSize: size, isBytes: true };
+  }
+
   private readTypedValue(addr: NativePointer, size: number, typeKind: string): any {
     // Note: Process.findRangeByAddress() can hang on large macOS binaries with
     // unmapped addresses — skip the pre-check and rely on try/catch in the caller.
@@ -1624,6 +1718,12 @@ function onWatchesMessage(message: WatchInstruction): void {
 }
 recv('watches', onWatchesMessage);
 
+function onSerializeArgsMessage(message: SerializeArgsMessage): void {
+  recv('serialize_args', onSerializeArgsMessage);
+  agent.handleSerializeArgs(message);
+}
+recv('serialize_args', onSerializeArgsMessage);
+
 function onReadMemoryMessage(message: ReadMemoryMessage): void {
   recv('read_memory', onReadMemoryMessage);
   // Delegate to tracer if it implements handleReadMemory (optional method)
@@ -7,8 +7,8 @@
  * daemon via send().
  */
 
-import { ObjectSerializer, TypeInfo } from './object-serializer.js';
 import { PlatformAdapter } from './platform.js';
+import { createShmRegion, ShmRegion } from './shm-transport.js';
 import { reinterpretAsFloat, signExtend } from './utils.js';
 
 // ---------------------------------------------------------------------------
@@ -20,12 +20,22 @@ export type HookMode = 'full' | 'light';
 /** Callback for per-function rate checking. Returns true if the event should be recorded. */
 export type RateCheckFn = (funcId: number) => boolean;
 
+/** Argument predicate compiled daemon-side from a trace pattern suffix.
+ *  `op` uses the CModule's func_pred_op codes (1 ==, 2 !=, 3 <, 4 >, 5 <=,
+ *  6 >=); `value` is a signed 64-bit integer as a decimal string. */
+export interface ArgPredicate {
+  arg: number;
+  op: number;
+  value: string;
+}
+
 export interface FunctionTarget {
   address: string;
   name: string;
   nameRaw?: string;
   sourceFile?: string;
   lineNumber?: number;
+  predicate?: ArgPredicate;
 }
 
 interface TraceEvent {
@@ -35,7 +45,7 @@ interface TraceEvent {
   threadId: number;
   threadName?: string | null;
   parentEventId: string | null;
-  eventType: 'function_enter' | 'function_exit';
+  eventType: 'function_enter' | 'function_exit' | 'variable_snapshot';
   functionName: string;
   functionNameRaw?: string;
   sourceFile?: string;
@@ -45,6 +55,31 @@ interface TraceEvent {
   durationNs?: number;
   sampled?: boolean;
   watchValues?: Record<string, number | string>;
+  /** Raw static return addresses from the native frame-pointer walk (hex). */
+  stack?: string[];
+}
+
+/** Periodic statistics flushed for functions degraded to aggregation mode. */
+interface AggregateSummaryEvent {
+  id: string;
+  sessionId: string;
+  timestampNs: number;
+  threadId: number;
+  eventType: 'aggregate_summary';
+  functionName: string;
+  functionNameRaw?: string;
+  sourceFile?: string;
+  lineNumber?: number;
+  data: {
+    callCount: number;
+    totalDurationNs: number;
+    minDurationNs: number;
+    maxDurationNs: number;
+    meanDurationNs: number;
+    /** Log-scale latency histogram: count of calls with duration <= leNs. */
+    histogram: Array<{ leNs: number; count: number }>;
+    windowMs: number;
+  };
 }
 
 interface WatchConfig {
@@ -60,10 +95,36 @@ interface WatchConfig {
 // ---------------------------------------------------------------------------
 
 const RING_CAPACITY = 16384;
-const ENTRY_SIZE = 80;
+const ENTRY_SIZE = 144;
 const HEADER_SIZE = 128;
+
+// Raw return-address slots per enter entry, filled by the CModule's native
+// frame-pointer walk. Addresses stay unsymbolized end-to-end — the daemon
+// resolves them from DWARF only when a query actually returns the event.
+const STACK_SLOTS = 8;
 const RING_BUFFER_SIZE = HEADER_SIZE + RING_CAPACITY * ENTRY_SIZE;
 
+// Per-function rule table size. Hook cap is 1000 per debug_trace call and
+// funcIds grow monotonically across add/remove cycles (reset on removeAll),
+// so 4x headroom keeps rules applying through typical churn; ids past the
+// table simply bypass per-function rules. Must match the C-side #define.
+const FUNC_RULE_SLOTS = 4096;
+
+// Per-function aggregation cell layout (see AGG_STRIDE in the C source):
+// lock(4) pad(4) count(8) sum(8) min(8) max(8) hist[32]×4 = 168 bytes.
+// Durations are stored in raw ticks; JS converts to ns on flush.
+const AGG_STRIDE = 168;
+const AGG_HIST_BUCKETS = 32;
+const AGG_FLUSH_INTERVAL_MS = 1000;
+
+// Shm handoff state (header offset 20). The ring starts agent-owned; the
+// daemon writes DAEMON_REQUEST after mapping the region, and we acknowledge
+// with AGENT_ACKED before ceasing to drain — exactly one side consumes.
+const SHM_STATE_OFFSET = 20;
+const SHM_STATE_AGENT_OWNED = 0;
+const SHM_STATE_DAEMON_REQUEST = 1;
+const SHM_STATE_AGENT_ACKED = 2;
+
 // Adaptive sampling thresholds
 const HIGH_THRESHOLD = Math.floor(RING_CAPACITY * 0.5);
 const LOW_THRESHOLD  = Math.floor(RING_CAPACITY * 0.1);
@@ -81,7 +142,7 @@ const DRAIN_INTERVAL_MS = 10;
 // encoded in the data pointer's low bit:
 //   data = (func_id << 1) | is_light
 // The shift limits func_id to 2^30 (1 billion) to prevent signed 32-bit overflow
-// (2^31 - 1 = 2,147,483,647). In practice, hook cap of 100 means we never approach this.
+// (2^31 - 1 = 2,147,483,647). In practice, the 1000-hook cap means we never approach this.
 // In onEnter: light hooks check sampling, full hooks don't.
 // In onLeave: both modes write exit events. Per-invocation data pairs enter/exit
 // so exits are only written when the corresponding enter passed sampling.
@@ -102,8 +163,51 @@ extern guint8 watch_sizes[4];
 extern guint8 watch_deref_depths[4];
 extern guint64 watch_deref_offsets[4];
 
+/* Per-function rate rules, compiled daemon/agent-side from trace patterns
+ * and hot-function detection. func_intervals[id]: 0/1 record all, N record
+ * 1-in-N, -1 drop all. func_counts[id] counts every call (read + reset by
+ * the JS rate timer). Both indexed by func_id. */
+extern volatile gint func_intervals[4096];
+extern volatile gint func_counts[4096];
+
+/* Argument predicates, compiled daemon-side from trace pattern suffixes
+ * like processBlock(arg1 != 512). func_pred_op[id]: 0 none, 1 ==, 2 !=,
+ * 3 <, 4 >, 5 <=, 6 >= — signed compare of the func_pred_arg[id]-th
+ * argument against func_pred_val[id] (null checks arrive as ==/!= 0).
+ * Rejected calls return before any other rule: no ring entry, no call
+ * count, no aggregation. */
+extern volatile gint func_pred_op[4096];
+extern guint8 func_pred_arg[4096];
+extern gint64 func_pred_val[4096];
+
+/* Aggregation mode: when func_agg_mode[id] is set, calls are folded into
+ * per-function statistics cells in agg_data instead of ring entries —
+ * count, duration sum/min/max and a log2 latency histogram, all in raw
+ * ticks. flush_agg() (called from JS on a timer) copies and resets a cell
+ * under the same per-cell spinlock the updaters take. */
+extern volatile gint func_agg_mode[4096];
+extern guint8 *agg_data;
+
+/* Frame-pointer stack capture toggle (default on). */
+extern volatile gint stack_capture;
+
+/* Timer-driven watch sampler: a dedicated GLib thread re-reads the watch
+ * table every sampler_interval_us microseconds and writes the values into
+ * the ring as event_type 2 entries (sentinel func_id 0), decoupling watch
+ * capture from function triggers. 0 parks the thread; a negative interval
+ * makes it exit (it runs CModule code, which is freed on script unload, so
+ * dispose() must be able to stop it and wait). sampler_started guards
+ * against spawning it twice; sampler_exited acknowledges the exit. */
+extern volatile gint sampler_interval_us;
+extern volatile gint sampler_started;
+extern volatile gint sampler_exited;
+
 #define RING_CAPACITY 16384
-#define ENTRY_SIZE 80
+#define ENTRY_SIZE 144
+#define STACK_SLOTS 8
+#define FUNC_RULE_SLOTS 4096
+#define AGG_STRIDE 168
+#define AGG_HIST_BUCKETS 32
 
 typedef struct {
   guint64 timestamp;
@@ -116,32 +220,17 @@ typedef struct {
   guint8  event_type;
   guint8  sampled;
   guint8  watch_entry_count;
-  guint8  _pad;
+  guint8  stack_count;
   guint64 watch0;
   guint64 watch1;
   guint64 watch2;
   guint64 watch3;
+  guint64 stack[8];
 } TraceEntry;
 
-static void write_entry(guint32 func_id, GumInvocationContext *ic,
-                         guint8 etype, guint8 samp,
-                         guint64 a0, guint64 a1, guint64 rv) {
-  gint pos = g_atomic_int_add(&write_idx, 1);
-  guint32 slot = ((guint32)pos) % RING_CAPACITY;
-  TraceEntry *e = (TraceEntry *)(ring_data + slot * ENTRY_SIZE);
-
-  e->timestamp  = strobe_timestamp();
-  e->func_id    = func_id;
-  e->thread_id  = gum_invocation_context_get_thread_id(ic);
-  e->depth      = gum_invocation_context_get_depth(ic);
-  e->event_type = etype;
-  e->sampled    = samp;
-  e->_pad       = 0;
-  e->arg0       = a0;
-  e->arg1       = a1;
-  e->retval     = rv;
-
-  /* Read watch values */
+/* Read the configured watch slots into an entry's watch fields. Shared by
+ * the per-call path (write_entry) and the timer-driven sampler thread. */
+static void read_watches(TraceEntry *e) {
   guint32 wc = (guint32)g_atomic_int_add(&watch_count, 0);
 
   // Early exit optimization: if no watches, zero out slots and skip
@@ -192,44 +281,245 @@ static void write_entry(guint32 func_id, GumInvocationContext *ic,
   }
 }
 
+static void write_entry(guint32 func_id, GumInvocationContext *ic,
+                         guint8 etype, guint8 samp,
+                         guint64 a0, guint64 a1, guint64 rv) {
+  gint pos = g_atomic_int_add(&write_idx, 1);
+  guint32 slot = ((guint32)pos) % RING_CAPACITY;
+  TraceEntry *e = (TraceEntry *)(ring_data + slot * ENTRY_SIZE);
+
+  e->timestamp  = strobe_timestamp();
+  e->func_id    = func_id;
+  e->thread_id  = gum_invocation_context_get_thread_id(ic);
+  e->depth      = gum_invocation_context_get_depth(ic);
+  e->event_type = etype;
+  e->sampled    = samp;
+  e->stack_count = 0;
+  e->arg0       = a0;
+  e->arg1       = a1;
+  e->retval     = rv;
+
+  /* Native frame-pointer unwind (enter events only): raw return addresses
+   * go straight into the entry — no Gum backtracer, no symbol lookup, no
+   * JS on the hot path. Symbolization is deferred to the daemon at query
+   * time. The walk stops at the first broken link (omitted frame pointer,
+   * misalignment, frame outside the stack window). */
+  if (etype == 0 && g_atomic_int_add(&stack_capture, 0) != 0) {
+    guint64 *out = (guint64 *)(((guint8*)e) + 80);
+    guint32 n = 0;
+    out[n++] = (guint64)gum_invocation_context_get_return_address(ic);
+#if defined(__aarch64__)
+    guint64 fp = ic->cpu_context->fp;
+    guint64 sp = ic->cpu_context->sp;
+#elif defined(__x86_64__)
+    guint64 fp = ic->cpu_context->rbp;
+    guint64 sp = ic->cpu_context->rsp;
+#else
+    guint64 fp = 0;
+    guint64 sp = 0;
+#endif
+    /* At function entry the prologue hasn't run, so fp still points at the
+     * caller's frame record: [fp] = next fp, [fp+8] = return address.
+     * Every dereference is constrained to (sp, sp + 1MB): a real frame
+     * chain lives just above the entry sp, and on x86-64 built without
+     * frame pointers (the -O1+ default) rbp is a general-purpose register
+     * whose stale pointer-like values would otherwise be dereferenced
+     * blind — one unmapped load here segfaults the traced process. The
+     * window is re-checked on every hop, so a bogus link can't escape it. */
+    while (n < STACK_SLOTS && fp > sp && fp - sp < 0x100000 && (fp % 8) == 0) {
+      guint64 next = *(volatile guint64*)(gpointer)fp;
+      guint64 ret  = *(volatile guint64*)(gpointer)(fp + 8);
+      if (ret < 0x1000) break;
+      out[n++] = ret;
+      if (next <= fp) break;
+      fp = next;
+    }
+    e->stack_count = (guint8)n;
+  }
+
+  /* Read watch values */
+  read_watches(e);
+}
+
+/* Sampler thread body: one ring entry per tick while an interval is set,
+ * parked at a 10ms poll otherwise. g_usleep bounds the achievable rate by
+ * scheduler granularity — comfortably enough for the 10kHz range the
+ * interval cap targets. A negative interval (written by dispose before
+ * script unload) exits the loop; sampler_exited flags that the thread has
+ * left CModule code for good. */
+static gpointer sampler_main(gpointer data) {
+  while (1) {
+    gint us = g_atomic_int_add(&sampler_interval_us, 0);
+    if (us < 0) break;
+    if (us == 0) {
+      g_usleep(10000);
+      continue;
+    }
+    if (g_atomic_int_add(&watch_count, 0) > 0) {
+      gint pos = g_atomic_int_add(&write_idx, 1);
+      guint32 slot = ((guint32)pos) % RING_CAPACITY;
+      TraceEntry *e = (TraceEntry *)(ring_data + slot * ENTRY_SIZE);
+      e->timestamp   = strobe_timestamp();
+      e->arg0        = 0;
+      e->arg1        = 0;
+      e->retval      = 0;
+      e->func_id     = 0;   /* sentinel: real funcIds start at 1 */
+      e->thread_id   = 0;
+      e->depth       = 0;
+      e->event_type  = 2;
+      e->sampled     = 0;
+      e->stack_count = 0;
+      read_watches(e);
+    }
+    g_usleep((gulong)us);
+  }
+  g_atomic_int_add(&sampler_exited, 1);
+  return NULL;
+}
+
+/* Called from JS via NativeFunction when sampling is first enabled. */
+void start_sampler(void) {
+  if (g_atomic_int_compare_and_exchange((gint *)&sampler_started, 0, 1)) {
+    g_thread_new("strobe-sampler", sampler_main, NULL);
+  }
+}
+
+/* Per-cell spinlock. g_atomic_int_get is a TinyCC casualty but the CAS and
+ * add primitives are real glib functions, so lock with CAS and release with
+ * an atomic decrement. The critical section is a handful of stores. */
+static void agg_lock(volatile gint *lock) {
+  while (!g_atomic_int_compare_and_exchange((gint *)lock, 0, 1)) { }
+}
+
+static void agg_unlock(volatile gint *lock) {
+  g_atomic_int_add((gint *)lock, -1);
+}
+
+static void agg_record(guint32 func_id, guint64 dur) {
+  guint8 *cell = agg_data + func_id * AGG_STRIDE;
+  volatile gint *lock = (volatile gint *)cell;
+  guint64 *count = (guint64 *)(cell + 8);
+  guint64 *sum   = (guint64 *)(cell + 16);
+  guint64 *min   = (guint64 *)(cell + 24);
+  guint64 *max   = (guint64 *)(cell + 32);
+  guint32 *hist  = (guint32 *)(cell + 40);
+
+  guint32 bucket = 0;
+  guint64 d = dur >> 1;
+  while (d != 0 && bucket < AGG_HIST_BUCKETS - 1) { d >>= 1; bucket++; }
+
+  agg_lock(lock);
+  if (*count == 0 || dur < *min) *min = dur;
+  if (dur > *max) *max = dur;
+  *count += 1;
+  *sum += dur;
+  hist[bucket] += 1;
+  agg_unlock(lock);
+}
+
+/* Called from JS via NativeFunction: copy a cell's payload (everything past
+ * the lock word) into out and reset it, atomically w.r.t. agg_record. */
+void flush_agg(guint32 func_id, guint8 *out) {
+  guint8 *cell = agg_data + func_id * AGG_STRIDE;
+  volatile gint *lock = (volatile gint *)cell;
+  guint32 i;
+
+  agg_lock(lock);
+  for (i = 8; i < AGG_STRIDE; i++) {
+    out[i - 8] = cell[i];
+    cell[i] = 0;
+  }
+  agg_unlock(lock);
+}
+
 void onEnter(GumInvocationContext *ic) {
   gsize raw = (gsize)gum_invocation_context_get_listener_function_data(ic);
   guint32 func_id = (guint32)(raw >> 1);
   guint8 is_light = (guint8)(raw & 1);
-  guint8 *inv = (guint8 *)gum_invocation_context_get_listener_invocation_data(ic, 1);
+  guint8 *inv = (guint8 *)gum_invocation_context_get_listener_invocation_data(ic, 16);
+  guint8 samp = 0;
+
+  /* Argument predicate: checked first so rejected calls cost this compare
+   * and nothing else — they don't even feed hot-function rate detection.
+   * JS writes val and arg before op, so a non-zero op guarantees the other
+   * two slots are consistent. */
+  if (func_id < FUNC_RULE_SLOTS) {
+    gint pop = g_atomic_int_add((gint *)&func_pred_op[func_id], 0);
+    if (pop != 0) {
+      gint64 av = (gint64)(gsize)gum_invocation_context_get_nth_argument(
+        ic, func_pred_arg[func_id]);
+      gint64 cv = func_pred_val[func_id];
+      guint8 pass = 0;
+      if (pop == 1) { if (av == cv) pass = 1; }
+      else if (pop == 2) { if (av != cv) pass = 1; }
+      else if (pop == 3) { if (av < cv) pass = 1; }
+      else if (pop == 4) { if (av > cv) pass = 1; }
+      else if (pop == 5) { if (av <= cv) pass = 1; }
+      else { if (av >= cv) pass = 1; }
+      if (!pass) { *inv = 0; return; }
+    }
+  }
+
+  /* Per-function rate rules: the record/skip decision never leaves native
+   * code. Skipped calls still count (func_counts feeds rate measurement)
+   * but never touch the ring. */
+  if (func_id < FUNC_RULE_SLOTS) {
+    gint n = g_atomic_int_add((gint *)&func_counts[func_id], 1);
+    if (g_atomic_int_add((gint *)&func_agg_mode[func_id], 0) != 0) {
+      /* Aggregation mode: stash the enter timestamp for onLeave and keep
+       * the call out of the ring entirely. */
+      *inv = 2;
+      *(guint64 *)(inv + 8) = strobe_timestamp();
+      return;
+    }
+    gint iv = g_atomic_int_add((gint *)&func_intervals[func_id], 0);
+    if (iv < 0) { *inv = 0; return; }
+    if (iv > 1) {
+      if ((n % iv) != 0) { *inv = 0; return; }
+      samp = 1;
+    }
+  }
 
   if (is_light) {
     gint interval = g_atomic_int_add(&sample_interval, 0);
     if (interval > 1) {
       gint count = g_atomic_int_add(&global_counter, 1);
       if ((count % interval) != 0) { *inv = 0; return; }
+      samp = 1;
     }
-    *inv = 1;
-    write_entry(func_id, ic, 0, interval > 1 ? 1 : 0,
-      (guint64)gum_invocation_context_get_nth_argument(ic, 0),
-      (guint64)gum_invocation_context_get_nth_argument(ic, 1),
-      0);
-  } else {
-    *inv = 1;
-    write_entry(func_id, ic, 0, 0,
-      (guint64)gum_invocation_context_get_nth_argument(ic, 0),
-      (guint64)gum_invocation_context_get_nth_argument(ic, 1),
-      0);
   }
+
+  *inv = 1;
+  write_entry(func_id, ic, 0, samp,
+    (guint64)gum_invocation_context_get_nth_argument(ic, 0),
+    (guint64)gum_invocation_context_get_nth_argument(ic, 1),
+    0);
 }
 
 void onLeave(GumInvocationContext *ic) {
-  guint8 *inv = (guint8 *)gum_invocation_context_get_listener_invocation_data(ic, 1);
+  guint8 *inv = (guint8 *)gum_invocation_context_get_listener_invocation_data(ic, 16);
   if (!*inv) return;
 
   gsize raw = (gsize)gum_invocation_context_get_listener_function_data(ic);
   guint32 func_id = (guint32)(raw >> 1);
+
+  if (*inv == 2) {
+    guint64 enter = *(guint64 *)(inv + 8);
+    guint64 now = strobe_timestamp();
+    agg_record(func_id, now > enter ? now - enter : 0);
+    return;
+  }
+
   guint8 is_light = (guint8)(raw & 1);
   guint8 sampled = 0;
   if (is_light) {
     gint interval = g_atomic_int_add(&sample_interval, 0);
     sampled = interval > 1 ? 1 : 0;
   }
+  if (func_id < FUNC_RULE_SLOTS &&
+      g_atomic_int_add((gint *)&func_intervals[func_id], 0) > 1) {
+    sampled = 1;
+  }
   write_entry(func_id, ic, 1, sampled, 0, 0,
     (guint64)gum_invocation_context_get_return_value(ic));
 }
@@ -258,6 +548,30 @@ export class CModuleTracer {
   private ringDataPtr: NativePointer;
   // Pointer-to-pointer for ring_data extern (CModule needs guint8 *)
   private ringDataPtrHolder: NativePointer;
+  // Per-function rule tables (intervals written by JS, counters by CModule)
+  private funcIntervalsPtr: NativePointer;
+  private funcCountsPtr: NativePointer;
+  // Argument predicate tables (op/arg/value per funcId, written by JS)
+  private funcPredOpPtr: NativePointer;
+  private funcPredArgPtr: NativePointer;
+  private funcPredValPtr: NativePointer;
+  // Aggregation mode: per-function flags, stats cells, and flush plumbing
+  private funcAggModePtr: NativePointer;
+  // Frame-pointer stack capture flag (CModule extern, default on)
+  private stackCapturePtr: NativePointer;
+  // Timer-driven watch sampler: interval cell + started flag (CModule
+  // externs) and the exported thread-spawn entry point
+  private samplerIntervalUsPtr: NativePointer;
+  private samplerStartedPtr: NativePointer;
+  private samplerExitedPtr: NativePointer;
+  private startSamplerFn: (() => void) | null = null;
+  private aggDataPtr: NativePointer;
+  private aggDataPtrHolder: NativePointer;
+  private aggScratch: NativePointer;
+  private flushAggFn: ((funcId: number, out: NativePointer) => void) | null = null;
+  private aggregatedFuncs: Set<number> = new Set();
+  private aggFlushTimer: ReturnType<typeof setInterval> | null = null;
+  private lastAggFlushMs: number = Date.now();
 
   // CModule instance
   private cm: CModule | null = null;
@@ -289,7 +603,7 @@ export class CModuleTracer {
   private drainTimer: ReturnType<typeof setInterval> | null = null;
 
   // Callback for emitting events to the daemon
-  private onEvents: (events: TraceEvent[]) => void;
+  private onEvents: (events: Array<TraceEvent | AggregateSummaryEvent>) => void;
 
   // Per-thread depth stacks for parent tracking during drain
   // Map<threadId, Array<{ eventId: string; depth: number; timestampNs: number }>>
@@ -306,8 +620,10 @@ export class CModuleTracer {
     onFuncIds: Set<number>;
   }> = [];
 
-  // Object serializer for deep argument inspection
-  private objectSerializer: ObjectSerializer | null = null;
+  // Requested depth for lazy argument serialization (0 = not requested).
+  // Capture always records raw pointers; the daemon sends a serialize_args
+  // message at query time for the few events actually inspected.
+  private serializationDepth: number = 0;
 
   // Rate check callback for hot function detection
   private rateCheck: RateCheckFn | null = null;
@@ -315,11 +631,19 @@ export class CModuleTracer {
   // Thread name cache: threadId -> name
   private threadNames: Map<number, string | null> = new Map();
 
+  // Shared-memory transport: set when the ring lives in a shm region the
+  // daemon can map. Once the daemon takes ownership (shmHandedOff), drain()
+  // stops decoding — the daemon reads TraceEntry records directly.
+  private shmRegion: ShmRegion | null = null;
+  private shmHandedOff: boolean = false;
+  private shmStatePtr: NativePointer | null = null;
+
   constructor(onEvents: (events: any[]) => void, platform: PlatformAdapter) {
     this.onEvents = onEvents;
 
-    // --- Allocate ring buffer shared memory ---
-    this.ringBuffer = Memory.alloc(RING_BUFFER_SIZE);
+    // --- Allocate ring buffer: shm region if possible, anonymous otherwise ---
+    this.shmRegion = createShmRegion(RING_BUFFER_SIZE);
+    this.ringBuffer = this.shmRegion ? this.shmRegion.base : Memory.alloc(RING_BUFFER_SIZE);
 
     // Zero out the header
     this.ringBuffer.writeByteArray(new ArrayBuffer(HEADER_SIZE));
@@ -341,6 +665,10 @@ export class CModuleTracer {
     // Initialize watch_count to 0
     this.watchCountPtr.writeU32(0);
 
+    // Shm handoff state — starts agent-owned
+    this.shmStatePtr = this.ringBuffer.add(SHM_STATE_OFFSET);
+    this.shmStatePtr.writeU32(SHM_STATE_AGENT_OWNED);
+
     // Data region starts at offset HEADER_SIZE
     this.ringDataPtr = this.ringBuffer.add(HEADER_SIZE);
 
@@ -353,6 +681,36 @@ export class CModuleTracer {
     this.ringDataPtrHolder = Memory.alloc(Process.pointerSize);
     this.ringDataPtrHolder.writePointer(this.ringDataPtr);
 
+    // Per-function rule tables. Memory.alloc zero-fills, so every function
+    // starts with interval 0 (record all) and a zeroed call counter.
+    this.funcIntervalsPtr = Memory.alloc(FUNC_RULE_SLOTS * 4);
+    this.funcCountsPtr = Memory.alloc(FUNC_RULE_SLOTS * 4);
+
+    // Argument predicate tables, zero-filled (op 0 = no predicate).
+    this.funcPredOpPtr = Memory.alloc(FUNC_RULE_SLOTS * 4);
+    this.funcPredArgPtr = Memory.alloc(FUNC_RULE_SLOTS);
+    this.funcPredValPtr = Memory.alloc(FUNC_RULE_SLOTS * 8);
+
+    // Aggregation tables: mode flags plus one stats cell per function,
+    // all zero-filled (mode off, empty stats). Same holder trick as
+    // ring_data for the `extern guint8 *agg_data` symbol.
+    this.funcAggModePtr = Memory.alloc(FUNC_RULE_SLOTS * 4);
+
+    // Stack capture defaults to on: the native frame-pointer walk is a
+    // handful of guarded loads per enter event, cheap enough to always run.
+    this.stackCapturePtr = Memory.alloc(4);
+    this.stackCapturePtr.writeS32(1);
+
+    // Watch sampler state: interval 0 (disabled), thread not yet spawned.
+    this.samplerIntervalUsPtr = Memory.alloc(4);
+    this.samplerStartedPtr = Memory.alloc(4);
+    this.samplerExitedPtr = Memory.alloc(4);
+
+    this.aggDataPtr = Memory.alloc(FUNC_RULE_SLOTS * AGG_STRIDE);
+    this.aggDataPtrHolder = Memory.alloc(Process.pointerSize);
+    this.aggDataPtrHolder.writePointer(this.aggDataPtr);
+    this.aggScratch = Memory.alloc(AGG_STRIDE - 8);
+
     // --- Compute ticksToNs from platform ---
     this.ticksToNs = platform.getTicksToNs();
 
@@ -371,10 +729,42 @@ export class CModuleTracer {
         watch_sizes:          this.watchSizesPtr,
         watch_deref_depths:   this.watchDerefDepthsPtr,
         watch_deref_offsets:  this.watchDerefOffsetsPtr,
+        func_intervals:       this.funcIntervalsPtr,
+        func_counts:          this.funcCountsPtr,
+        func_pred_op:         this.funcPredOpPtr,
+        func_pred_arg:        this.funcPredArgPtr,
+        func_pred_val:        this.funcPredValPtr,
+        func_agg_mode:        this.funcAggModePtr,
+        agg_data:             this.aggDataPtrHolder,
+        stack_capture:        this.stackCapturePtr,
+        sampler_interval_us:  this.samplerIntervalUsPtr,
+        sampler_started:      this.samplerStartedPtr,
+        sampler_exited:       this.samplerExitedPtr,
       });
+      this.flushAggFn = new NativeFunction(
+        (this.cm as any).flush_agg, 'void', ['uint32', 'pointer']) as any;
+      this.startSamplerFn = new NativeFunction(
+        (this.cm as any).start_sampler, 'void', []) as any;
     } catch (e) {
       send({ type: 'log', message: `CModule creation failed, using JS fallback: ${e}` });
       this.cm = null;
+      this.flushAggFn = null;
+      this.startSamplerFn = null;
+    }
+
+    // --- Offer the shm region to the daemon ---
+    // The daemon maps it and requests ownership via the header state field;
+    // until that handshake completes we keep draining via send() as before.
+    if (this.shmRegion) {
+      send({
+        type: 'shm_ready',
+        name: this.shmRegion.name,
+        size: this.shmRegion.size,
+        capacity: RING_CAPACITY,
+        entrySize: ENTRY_SIZE,
+        headerSize: HEADER_SIZE,
+        ticksToNs: this.ticksToNs,
+      });
     }
 
     // --- Start drain timer ---
@@ -392,6 +782,32 @@ export class CModuleTracer {
     const runtimeBase = Process.mainModule!.base;
     this.aslrSlide = runtimeBase.sub(staticBase);
     this.imageBaseSet = true;
+
+    // In shm mode the daemon decodes ring entries itself — including the
+    // raw stack addresses — and needs the slide to rebase them.
+    if (this.shmRegion) {
+      send({ type: 'shm_slide', slide: this.aslrSlide.toString() });
+    }
+  }
+
+  /** Toggle the CModule's native frame-pointer stack capture (default on). */
+  setStackCapture(enabled: boolean): void {
+    this.stackCapturePtr.writeS32(enabled ? 1 : 0);
+  }
+
+  /**
+   * Time-driven watch sampling: the CModule's sampler thread re-reads the
+   * watch table every intervalUs microseconds and writes the values into the
+   * ring as variable_snapshot entries, independent of any hooked call.
+   * 0 disables (the thread parks). Requires the native CModule — the JS
+   * fallback stays trigger-driven.
+   */
+  setWatchSampling(intervalUs: number): void {
+    const us = Math.max(0, Math.floor(intervalUs));
+    this.samplerIntervalUsPtr.writeS32(us);
+    if (us > 0 && this.startSamplerFn) {
+      this.startSamplerFn();
+    }
   }
 
   getSlide(): NativePointer {
@@ -402,15 +818,169 @@ export class CModuleTracer {
     this.sessionId = sessionId;
   }
 
+  /**
+   * Record the requested argument serialization depth. Capture is not
+   * affected — the hot path always stores raw pointers — but the depth is
+   * echoed back to the daemon's lazy serialize_args requests at query time.
+   */
   setSerializationDepth(depth: number): void {
-    const clamped = Math.max(1, Math.min(depth, 10));
-    this.objectSerializer = new ObjectSerializer(clamped);
+    this.serializationDepth = Math.max(1, Math.min(depth, 10));
+  }
+
+  getSerializationDepth(): number {
+    return this.serializationDepth;
   }
 
   setRateCheck(fn: RateCheckFn): void {
     this.rateCheck = fn;
   }
 
+  /**
+   * Set the native sampling interval for one function: 0/1 record all,
+   * N record 1-in-N, -1 drop all. Evaluated by the CModule in onEnter, so
+   * skipped calls never enter the ring or touch JS.
+   */
+  setFuncSampling(funcId: number, interval: number): void {
+    if (funcId < 0 || funcId >= FUNC_RULE_SLOTS) return;
+    this.funcIntervalsPtr.add(funcId * 4).writeS32(interval);
+  }
+
+  /**
+   * Install or clear the argument predicate for one function. Value and
+   * arg index are written before the op slot — the CModule reads op as the
+   * gate, so a concurrent onEnter sees either no predicate or a complete
+   * one, never a half-written compare.
+   */
+  setFuncPredicate(funcId: number, predicate: ArgPredicate | null): void {
+    if (funcId < 0 || funcId >= FUNC_RULE_SLOTS) return;
+    if (predicate) {
+      this.funcPredValPtr.add(funcId * 8).writeS64(int64(predicate.value));
+      this.funcPredArgPtr.add(funcId).writeU8(predicate.arg);
+      this.funcPredOpPtr.add(funcId * 4).writeS32(predicate.op);
+    } else {
+      this.funcPredOpPtr.add(funcId * 4).writeS32(0);
+      this.funcPredArgPtr.add(funcId).writeU8(0);
+      this.funcPredValPtr.add(funcId * 8).writeS64(int64(0));
+    }
+  }
+
+  /**
+   * Read and reset the native per-function call counters (all calls,
+   * including skipped ones). Pulled by the rate timer every 100ms; the
+   * read-then-reset can miss increments landing in between, which only
+   * nudges one window's rate estimate.
+   */
+  collectFuncCounts(): Map<number, number> {
+    const counts = new Map<number, number>();
+    for (const funcId of this.funcRegistry.keys()) {
+      if (funcId >= FUNC_RULE_SLOTS) continue;
+      const p = this.funcCountsPtr.add(funcId * 4);
+      const n = p.readU32();
+      if (n > 0) {
+        p.writeU32(0);
+        counts.set(funcId, n);
+      }
+    }
+    return counts;
+  }
+
+  /** Aggregation needs the native CModule (timestamping + stats cells). */
+  supportsAggregation(): boolean {
+    return this.cm !== null && this.flushAggFn !== null;
+  }
+
+  /**
+   * Degrade a hot function to in-CModule aggregation: instead of dropping
+   * events, every call is folded into native counters (count, min/max/mean
+   * duration, log-scale latency histogram) and flushed as a periodic
+   * aggregate_summary event. Disabling flushes the remainder and resumes
+   * full per-call capture.
+   */
+  setFuncAggregation(funcId: number, enabled: boolean): void {
+    if (!this.supportsAggregation()) return;
+    if (funcId < 0 || funcId >= FUNC_RULE_SLOTS) return;
+
+    if (enabled) {
+      // Aggregation supersedes interval sampling for this function
+      this.funcIntervalsPtr.add(funcId * 4).writeS32(0);
+      this.funcAggModePtr.add(funcId * 4).writeS32(1);
+      this.aggregatedFuncs.add(funcId);
+      if (this.aggFlushTimer === null) {
+        this.lastAggFlushMs = Date.now();
+        this.aggFlushTimer = setInterval(() => this.flushAggregates(), AGG_FLUSH_INTERVAL_MS);
+        (this.aggFlushTimer as any).unref?.();
+      }
+    } else {
+      this.funcAggModePtr.add(funcId * 4).writeS32(0);
+      // Emit whatever accumulated since the last tick before forgetting
+      this.flushAggregates([funcId]);
+      this.aggregatedFuncs.delete(funcId);
+      if (this.aggregatedFuncs.size === 0 && this.aggFlushTimer !== null) {
+        clearInterval(this.aggFlushTimer);
+        this.aggFlushTimer = null;
+      }
+    }
+  }
+
+  /** Flush native stats cells into aggregate_summary events. */
+  private flushAggregates(only?: number[]): void {
+    if (!this.sessionId || !this.flushAggFn) return;
+
+    const now = Date.now();
+    const windowMs = Math.max(1, now - this.lastAggFlushMs);
+    if (!only) this.lastAggFlushMs = now;
+
+    const events: AggregateSummaryEvent[] = [];
+
+    for (const funcId of only ?? this.aggregatedFuncs) {
+      const func = this.funcRegistry.get(funcId);
+      if (!func) continue;
+
+      this.flushAggFn(funcId, this.aggScratch);
+      const count = this.aggScratch.readU64().toNumber();
+      if (count === 0) continue;
+
+      const sumNs = Math.round(this.aggScratch.add(8).readU64().toNumber() * this.ticksToNs);
+      const minNs = Math.round(this.aggScratch.add(16).readU64().toNumber() * this.ticksToNs);
+      const maxNs = Math.round(this.aggScratch.add(24).readU64().toNumber() * this.ticksToNs);
+
+      // Bucket b holds durations in [2^b, 2^(b+1)) ticks; report the upper
+      // bound in ns, Prometheus-style "le" semantics.
+      const histogram: Array<{ leNs: number; count: number }> = [];
+      for (let b = 0; b < AGG_HIST_BUCKETS; b++) {
+        const n = this.aggScratch.add(32 + b * 4).readU32();
+        if (n > 0) {
+          histogram.push({ leNs: Math.round(Math.pow(2, b + 1) * this.ticksToNs), count: n });
+        }
+      }
+
+      events.push({
+        id: this.generateEventId(),
+        sessionId: this.sessionId,
+        timestampNs: now * 1000000,
+        threadId: 0,
+        eventType: 'aggregate_summary',
+        functionName: func.name,
+        functionNameRaw: func.nameRaw,
+        sourceFile: func.sourceFile,
+        lineNumber: func.lineNumber,
+        data: {
+          callCount: count,
+          totalDurationNs: sumNs,
+          minDurationNs: minNs,
+          maxDurationNs: maxNs,
+          meanDurationNs: Math.round(sumNs / count),
+          histogram,
+          windowMs,
+        },
+      });
+    }
+
+    if (events.length > 0) {
+      this.onEvents(events);
+    }
+  }
+
   installHook(func: FunctionTarget, mode: HookMode = 'full'): number | null {
     const existing = this.hooks.get(func.address);
     if (existing) {
@@ -431,6 +1001,12 @@ export class CModuleTracer {
     // Adjust address for ASLR: runtime addr = static addr + slide
     const addr = ptr(func.address).add(this.aslrSlide);
 
+    // Predicate goes in before the attach so the first calls are filtered
+    // too (Memory.alloc zero-fills, so absent predicates need no write).
+    if (func.predicate) {
+      this.setFuncPredicate(funcId, func.predicate);
+    }
+
     try {
       let listener: InvocationListener;
 
@@ -441,26 +1017,61 @@ export class CModuleTracer {
         listener = Interceptor.attach(addr, this.cm as any, data);
       } else {
         // JS fallback path — used when CModule is unavailable
-        listener = this.installJsHook(addr, funcId, mode);
+        listener = this.installJsHook(addr, funcId, mode, func.predicate ?? null);
       }
 
       this.hooks.set(func.address, { listener, funcId, funcName: func.name });
+
+      // In shm mode the daemon decodes ring entries itself and needs the
+      // funcId → metadata mapping. Sent at install time — not the hot path.
+      if (this.shmRegion) {
+        send({
+          type: 'shm_func',
+          funcId,
+          name: func.name,
+          nameRaw: func.nameRaw,
+          sourceFile: func.sourceFile,
+          lineNumber: func.lineNumber,
+        });
+      }
+
       return funcId;
     } catch (_e) {
       // Silently skip functions that can't be hooked
       this.funcRegistry.delete(funcId);
+      this.setFuncPredicate(funcId, null);
       return null;
     }
   }
 
   /** JS-based hook fallback: writes to the same ring buffer as CModule. */
-  private installJsHook(addr: NativePointer, funcId: number, mode: HookMode): InvocationListener {
+  private installJsHook(addr: NativePointer, funcId: number, mode: HookMode,
+                        predicate: ArgPredicate | null = null): InvocationListener {
     const writeIdxPtr = this.writeIdxPtr;
     const ringDataPtr = this.ringDataPtr;
     const isLight = mode === 'light';
+    // Pre-parse the predicate value once; Int64 compares keep 64-bit
+    // semantics that JS numbers would lose.
+    const predVal = predicate ? int64(predicate.value) : null;
 
     return Interceptor.attach(addr, {
       onEnter(args) {
+        if (predicate && predVal !== null) {
+          const av = int64(args[predicate.arg].toString());
+          const cmp = av.compare(predVal);
+          const op = predicate.op;
+          const pass =
+            op === 1 ? cmp === 0 :
+            op === 2 ? cmp !== 0 :
+            op === 3 ? cmp < 0 :
+            op === 4 ? cmp > 0 :
+            op === 5 ? cmp <= 0 :
+            cmp >= 0;
+          if (!pass) {
+            (this as any)._strobeSkip = true;
+            return;
+          }
+        }
         const idx = (writeIdxPtr.readU32() % RING_CAPACITY);
         const entryPtr = ringDataPtr.add(idx * ENTRY_SIZE);
         const now = uint64(Date.now() * 1000000);  // ms -> ns
@@ -475,11 +1086,13 @@ export class CModuleTracer {
         entryPtr.add(44).writeU8(0);               // eventType = enter
         entryPtr.add(45).writeU8(0);               // sampled
         entryPtr.add(46).writeU8(0);               // watchEntryCount
+        entryPtr.add(47).writeU8(0);               // stackCount (CModule only)
 
         writeIdxPtr.writeU32(writeIdxPtr.readU32() + 1);
         (this as any)._strobeEntryIdx = idx;
       },
       onLeave(retval) {
+        if ((this as any)._strobeSkip) return;
         const idx = (writeIdxPtr.readU32() % RING_CAPACITY);
         const entryPtr = ringDataPtr.add(idx * ENTRY_SIZE);
         const now = uint64(Date.now() * 1000000);
@@ -494,6 +1107,7 @@ export class CModuleTracer {
         entryPtr.add(44).writeU8(1);               // eventType = exit
         entryPtr.add(45).writeU8(0);
         entryPtr.add(46).writeU8(0);
+        entryPtr.add(47).writeU8(0);
 
         writeIdxPtr.writeU32(writeIdxPtr.readU32() + 1);
       }
@@ -506,6 +1120,21 @@ export class CModuleTracer {
       entry.listener.detach();
       this.funcRegistry.delete(entry.funcId);
       this.hooks.delete(address);
+      if (entry.funcId < FUNC_RULE_SLOTS) {
+        this.funcIntervalsPtr.add(entry.funcId * 4).writeS32(0);
+        this.funcCountsPtr.add(entry.funcId * 4).writeU32(0);
+        this.setFuncPredicate(entry.funcId, null);
+        if (this.aggregatedFuncs.has(entry.funcId)) {
+          // Hook is gone — discard the partial window rather than emit it
+          this.funcAggModePtr.add(entry.funcId * 4).writeS32(0);
+          this.flushAggFn?.(entry.funcId, this.aggScratch);
+          this.aggregatedFuncs.delete(entry.funcId);
+          if (this.aggregatedFuncs.size === 0 && this.aggFlushTimer !== null) {
+            clearInterval(this.aggFlushTimer);
+            this.aggFlushTimer = null;
+          }
+        }
+      }
     }
   }
 
@@ -522,19 +1151,56 @@ export class CModuleTracer {
     this.nextFuncId = 1;
     this.threadStacks.clear();
 
-    // Clear watch state
+    // funcIds restart from 1, so stale rules must not apply to new hooks
+    this.funcIntervalsPtr.writeByteArray(new ArrayBuffer(FUNC_RULE_SLOTS * 4));
+    this.funcCountsPtr.writeByteArray(new ArrayBuffer(FUNC_RULE_SLOTS * 4));
+    this.funcPredOpPtr.writeByteArray(new ArrayBuffer(FUNC_RULE_SLOTS * 4));
+    this.funcPredArgPtr.writeByteArray(new ArrayBuffer(FUNC_RULE_SLOTS));
+    this.funcPredValPtr.writeByteArray(new ArrayBuffer(FUNC_RULE_SLOTS * 8));
+    this.funcAggModePtr.writeByteArray(new ArrayBuffer(FUNC_RULE_SLOTS * 4));
+    this.aggDataPtr.writeByteArray(new ArrayBuffer(FUNC_RULE_SLOTS * AGG_STRIDE));
+    this.aggregatedFuncs.clear();
+    if (this.aggFlushTimer !== null) {
+      clearInterval(this.aggFlushTimer);
+      this.aggFlushTimer = null;
+    }
+
+    // Clear watch state (including the timer-driven sampler)
     this.watchCountPtr.writeU32(0);
+    this.samplerIntervalUsPtr.writeS32(0);
     this.watchConfigs = [null, null, null, null];
     this.exprWatches = [];
   }
 
   /** Final drain — flush any buffered events before script teardown. */
   dispose(): void {
+    // Stop the sampler thread before the script (and with it the CModule
+    // code the thread executes) is unloaded: a negative interval makes
+    // sampler_main exit, sampler_exited acknowledges. The parked thread
+    // wakes every 10ms, so the bounded wait is generous; on timeout we
+    // proceed anyway rather than hang teardown.
+    this.samplerIntervalUsPtr.writeS32(-1);
+    if (this.samplerStartedPtr.readS32() !== 0) {
+      const deadline = Date.now() + 500;
+      while (this.samplerExitedPtr.readS32() === 0 && Date.now() < deadline) {
+        Thread.sleep(0.005);
+      }
+    }
     if (this.drainTimer !== null) {
       clearInterval(this.drainTimer);
       this.drainTimer = null;
     }
+    if (this.aggFlushTimer !== null) {
+      clearInterval(this.aggFlushTimer);
+      this.aggFlushTimer = null;
+    }
+    this.flushAggregates();
     this.drain();
+    // In shm mode the daemon holds its own mapping; unlinking here just
+    // removes the name so the object is reclaimed when both sides unmap.
+    if (this.shmRegion) {
+      this.shmRegion.unlink();
+    }
   }
 
   updateWatches(watches: Array<{
@@ -606,6 +1272,22 @@ export class CModuleTracer {
 
     // Atomic enable
     this.watchCountPtr.writeU32(watches.length);
+
+    // In shm mode, mirror the resolved watch configs to the daemon so it can
+    // format the raw slot values (pattern→funcId resolution happens here).
+    // JS expression watches are agent-only and not evaluated in shm mode.
+    if (this.shmRegion) {
+      send({
+        type: 'shm_watches',
+        watches: this.watchConfigs.map(cfg => cfg && {
+          label: cfg.label,
+          typeKind: cfg.typeKind,
+          size: cfg.size,
+          isGlobal: cfg.isGlobal,
+          funcIds: Array.from(cfg.onFuncIds),
+        }),
+      });
+    }
   }
 
   // Match patterns against installed hook function names and return matching funcIds
@@ -697,6 +1379,22 @@ export class CModuleTracer {
     // Issue 2: bail if sessionId not yet set (setSessionId() hasn't been called)
     if (!this.sessionId) return;
 
+    // Shm handoff: once the daemon requests ownership, acknowledge and stop
+    // decoding — the daemon drains TraceEntry records directly from the
+    // mapped region. We keep ticking only to drive adaptive sampling.
+    if (this.shmRegion && this.shmStatePtr) {
+      if (!this.shmHandedOff &&
+          this.shmStatePtr.readU32() === SHM_STATE_DAEMON_REQUEST) {
+        this.shmStatePtr.writeU32(SHM_STATE_AGENT_ACKED);
+        this.shmHandedOff = true;
+      }
+      if (this.shmHandedOff) {
+        const backlog = (this.writeIdxPtr.readU32() - this.readIdxPtr.readU32()) >>> 0;
+        this.adaptSampling(Math.min(backlog, RING_CAPACITY));
+        return;
+      }
+    }
+
     // Periodic cleanup: clear thread stacks every 50k events to prevent
     // unbounded growth from missed function exits (exception unwinding, ring overflow)
     if (this.eventIdCounter % 50000 === 0) {
@@ -738,12 +1436,41 @@ export class CModuleTracer {
       const eventType  = entryPtr.add(44).readU8();
       const sampled    = entryPtr.add(45).readU8();
       const watchEntryCount = entryPtr.add(46).readU8();
+      const stackCount = entryPtr.add(47).readU8();
+
+      // Timer-driven watch sample from the sampler thread: sentinel funcId 0
+      // and no function/thread context, just the watch values at that tick.
+      // Scoping by 'on' patterns doesn't apply — there is no triggering call.
+      if (eventType === 2) {
+        const watchValues: Record<string, number | string> = {};
+        for (let w = 0; w < watchEntryCount && w < 4; w++) {
+          const cfg = this.watchConfigs[w];
+          if (!cfg) continue;
+          const raw = entryPtr.add(48 + w * 8).readU64();
+          watchValues[cfg.label] = this.formatWatchValue(raw, cfg);
+        }
+        if (Object.keys(watchValues).length > 0) {
+          events.push({
+            id: this.generateEventId(),
+            sessionId: this.sessionId,
+            timestampNs: Math.round(timestamp * this.ticksToNs),
+            threadId: 0,
+            parentEventId: null,
+            eventType: 'variable_snapshot',
+            functionName: '',
+            watchValues,
+          });
+        }
+        continue;
+      }
 
       const func = this.funcRegistry.get(funcId);
       if (!func) continue;
 
-      // Hot function detection: check if this call should be recorded
-      if (this.rateCheck) {
+      // Hot function detection (JS fallback hooks only): CModule hooks
+      // evaluate the per-function rules natively in onEnter, so skipped
+      // calls never reach the ring and nothing is re-checked here.
+      if (!this.cm && this.rateCheck) {
         const shouldRecord = this.rateCheck(funcId);
         if (!shouldRecord) continue;
       }
@@ -824,6 +1551,17 @@ export class CModuleTracer {
           }
         }
 
+        // Rebase raw return addresses to static addresses and forward them
+        // unsymbolized — the daemon resolves them lazily from DWARF.
+        if (stackCount > 0) {
+          const frames: string[] = [];
+          for (let s = 0; s < stackCount && s < STACK_SLOTS; s++) {
+            const raw = entryPtr.add(80 + s * 8).readPointer();
+            frames.push(raw.sub(this.aslrSlide).toString());
+          }
+          event.stack = frames;
+        }
+
         events.push(event);
 
       } else {
@@ -922,29 +1660,14 @@ export class CModuleTracer {
     return raw.toNumber();
   }
 
+  /**
+   * Arguments are recorded as raw hex pointers only — full serialization
+   * happens lazily in handleSerializeArgs when an event is actually queried
+   * (we inspect a tiny fraction of captured events, so eager serialization
+   * on the drain path was almost entirely wasted work).
+   */
   private serializeArguments(arg0: UInt64, arg1: UInt64): string[] {
-    if (!this.objectSerializer) {
-      return ['0x' + arg0.toString(16), '0x' + arg1.toString(16)];
-    }
-
-    const results: string[] = [];
-    for (const rawArg of [arg0, arg1]) {
-      const addr = ptr(rawArg.toString());
-      // Without DWARF type info for arguments, treat as generic pointer
-      const typeInfo: TypeInfo = {
-        typeKind: 'pointer',
-        byteSize: 8,
-        typeName: 'void*',
-      };
-      try {
-        const serialized = this.objectSerializer.serialize(addr, typeInfo);
-        results.push(typeof serialized === 'string' ? serialized : JSON.stringify(serialized));
-      } catch (e) {
-        results.push('0x' + rawArg.toString(16));
-      }
-      this.objectSerializer.reset();
-    }
-    return results;
+    return ['0x' + arg0.toString(16), '0x' + arg1.toString(16)];
   }
 
   /** Read thread name from /proc without calling Process.enumerateThreads(). */
@@ -1,5 +1,10 @@
 /**
- * Tracks call rates per function for hot function detection
+ * Tracks call rates per function for hot function detection.
+ *
+ * Call counts come from one of two sources: the CModule's native per-function
+ * counters (pulled in bulk every window via `pullCounts`) or per-event
+ * `recordCall` invocations on the JS fallback path. Detection itself stays
+ * here on the 100ms timer — only the per-call counting is native.
  */
 
 export interface RateStats {
@@ -31,6 +36,7 @@ export class RateTracker {
         private readonly funcNames: Map<number, string>,
         private readonly onSamplingChange: (funcId: number, enabled: boolean, rate: number) => void,
         private readonly onLog: LogFn = (_msg) => {},
+        private readonly pullCounts: (() => Map<number, number>) | null = null,
     ) {
         // Check rates every 100ms
         this.rateCheckTimer = setInterval(() => this.checkRates(), 100);
@@ -56,6 +62,14 @@ export class RateTracker {
 
         if (elapsed < 0.1) return; // Too soon
 
+        // Merge native counters from the CModule (includes skipped calls,
+        // so hot functions are still detected while being sampled)
+        if (this.pullCounts) {
+            for (const [funcId, n] of this.pullCounts()) {
+                this.currentWindow.set(funcId, (this.currentWindow.get(funcId) || 0) + n);
+            }
+        }
+
         // Calculate rates for this window
         for (const [funcId, count] of this.currentWindow.entries()) {
             const rate = count / elapsed;
@@ -0,0 +1,86 @@
+/**
+ * POSIX shared-memory region for the trace ring buffer.
+ *
+ * When available, the CModule's ring buffer is allocated in a shm object
+ * instead of anonymous memory, letting the daemon map the same region and
+ * drain TraceEntry records directly — no JSON on the target's hot path.
+ * Setup is best-effort: any failure returns null and the tracer falls back
+ * to Memory.alloc + the send() channel.
+ */
+
+import { findGlobalExport } from './utils.js';
+
+export interface ShmRegion {
+  /** POSIX shm name (e.g. "/strobe-1234-42"), passed to the daemon. */
+  name: string;
+  size: number;
+  base: NativePointer;
+  /** Unlink the shm object (mapping stays valid until process exit). */
+  unlink(): void;
+}
+
+// open(2) flag values differ between Linux and Darwin.
+const O_RDWR = 2;
+const O_CREAT = Process.platform === 'darwin' ? 0x200 : 0o100;
+const O_EXCL  = Process.platform === 'darwin' ? 0x800 : 0o200;
+
+const PROT_READ = 1;
+const PROT_WRITE = 2;
+const MAP_SHARED = 1;
+
+export function createShmRegion(size: number): ShmRegion | null {
+  if (Process.platform !== 'linux' && Process.platform !== 'darwin') {
+    return null;
+  }
+
+  try {
+    // Module.getExportByName(null, ...) was removed as a static in Frida 17.x
+    const shmOpenPtr = findGlobalExport('shm_open');
+    const shmUnlinkPtr = findGlobalExport('shm_unlink');
+    const ftruncatePtr = findGlobalExport('ftruncate');
+    const mmapPtr = findGlobalExport('mmap');
+    const closePtr = findGlobalExport('close');
+    if (!shmOpenPtr || !shmUnlinkPtr || !ftruncatePtr || !mmapPtr || !closePtr) {
+      return null;
+    }
+
+    const shmOpen = new NativeFunction(shmOpenPtr, 'int', ['pointer', 'int', 'int']);
+    const shmUnlink = new NativeFunction(shmUnlinkPtr, 'int', ['pointer']);
+    const ftruncate = new NativeFunction(ftruncatePtr, 'int', ['int', 'long']);
+    const mmap = new NativeFunction(
+      mmapPtr, 'pointer', ['pointer', 'ulong', 'int', 'int', 'int', 'ulong']);
+    const close = new NativeFunction(closePtr, 'int', ['int']);
+
+    // Unique per process + attempt so a crashed predecessor's stale object
+    // never collides (O_EXCL).
+    const name = `/strobe-${Process.id}-${Date.now() % 1000000}`;
+    const namePtr = Memory.allocUtf8String(name);
+
+    const fd = shmOpen(namePtr, O_RDWR | O_CREAT | O_EXCL, 0o600) as number;
+    if (fd < 0) return null;
+
+    if ((ftruncate(fd, size) as number) !== 0) {
+      close(fd);
+      shmUnlink(namePtr);
+      return null;
+    }
+
+    const base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) as NativePointer;
+    close(fd);
+
+    // MAP_FAILED is (void*)-1
+    if (base.isNull() || base.equals(ptr('-1')) || base.toString() === '0xffffffffffffffff') {
+      shmUnlink(namePtr);
+      return null;
+    }
+
+    return {
+      name,
+      size,
+      base,
+      unlink: () => { try { shmUnlink(namePtr); } catch (_e) {} },
+    };
+  } catch (_e) {
+    return null;
+  }
+}
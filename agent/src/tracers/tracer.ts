@@ -14,6 +14,9 @@ export interface ResolvedTarget {
   nameRaw?: string;
   sourceFile?: string;
   lineNumber?: number;
+  // Native only: argument predicate compiled into the hook
+  // (op codes match the CModule's func_pred_op table)
+  predicate?: { arg: number; op: number; value: string };
 }
 
 export interface Tracer {
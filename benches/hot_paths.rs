@@ -0,0 +1,200 @@
+//! Criterion benchmarks for the ingest and query hot paths.
+//!
+//! Run with `cargo bench`. The DWARF group builds the C++ fixture via CMake
+//! on first run (same fixture the e2e tests use) and is skipped with a note
+//! when no CMake toolchain is available.
+//!
+//! Ingest and query groups report per-element timings (criterion throughput),
+//! which is the number to watch: per-event daemon-side overhead in
+//! nanoseconds. Full in-target tracing overhead needs a live Frida agent and
+//! is exercised by the e2e integration tests instead.
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use std::path::PathBuf;
+
+use strobe::db::{Database, Event, EventType};
+use strobe::dwarf::{DwarfParser, PatternMatcher};
+
+/// Default per-session FIFO limit (mirrors STROBE_MAX_EVENTS_PER_SESSION).
+const MAX_EVENTS: usize = 200_000;
+
+fn make_event(session_id: &str, i: usize) -> Event {
+    let module = ["audio", "midi", "engine", "ui"][i % 4];
+    Event {
+        id: format!("evt-{}", i),
+        session_id: session_id.to_string(),
+        timestamp_ns: (i as i64) * 1_000,
+        thread_id: (i % 8) as i64,
+        event_type: if i % 2 == 0 {
+            EventType::FunctionEnter
+        } else {
+            EventType::FunctionExit
+        },
+        function_name: format!("{}::process_buffer_{}", module, i % 512),
+        source_file: Some(format!("/src/{}.cpp", module)),
+        line_number: Some((i % 900) as i32 + 1),
+        arguments: Some(serde_json::json!(["0x7fff0000", "0x2"])),
+        duration_ns: (i % 2 == 1).then_some((i % 50_000) as i64),
+        ..Default::default()
+    }
+}
+
+fn bench_ingest(c: &mut Criterion) {
+    let mut group = c.benchmark_group("insert_events_with_limit");
+    for batch_size in [100usize, 1_000, 10_000] {
+        group.throughput(Throughput::Elements(batch_size as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(batch_size),
+            &batch_size,
+            |b, &batch_size| {
+                let dir = tempfile::tempdir().unwrap();
+                let db = Database::open(&dir.path().join("bench.db")).unwrap();
+                db.create_session("s1", "/bin/bench", "/tmp", 1).unwrap();
+                let batch: Vec<Event> =
+                    (0..batch_size).map(|i| make_event("s1", i)).collect();
+                b.iter(|| db.insert_events_with_limit(&batch, MAX_EVENTS).unwrap());
+            },
+        );
+    }
+    group.finish();
+}
+
+fn bench_query(c: &mut Criterion) {
+    // Seed once: 200k events, the default FIFO capacity
+    let dir = tempfile::tempdir().unwrap();
+    let db = Database::open(&dir.path().join("bench.db")).unwrap();
+    db.create_session("s1", "/bin/bench", "/tmp", 1).unwrap();
+    let events: Vec<Event> = (0..MAX_EVENTS).map(|i| make_event("s1", i)).collect();
+    for chunk in events.chunks(10_000) {
+        db.insert_events_with_limit(chunk, MAX_EVENTS).unwrap();
+    }
+
+    let mut group = c.benchmark_group("query_events_200k");
+    group.bench_function("unfiltered_page", |b| {
+        b.iter(|| db.query_events("s1", |q| q.limit(500)).unwrap())
+    });
+    group.bench_function("function_contains", |b| {
+        b.iter(|| {
+            db.query_events("s1", |q| q.function_contains("audio::").limit(500))
+                .unwrap()
+        })
+    });
+    group.bench_function("event_type_filter", |b| {
+        b.iter(|| {
+            db.query_events("s1", |q| q.event_type(EventType::FunctionExit).limit(500))
+                .unwrap()
+        })
+    });
+    group.bench_function("timestamp_range", |b| {
+        b.iter(|| {
+            db.query_events("s1", |q| {
+                let mut q = q.limit(500);
+                q.timestamp_from_ns = Some(50_000_000);
+                q.timestamp_to_ns = Some(150_000_000);
+                q
+            })
+            .unwrap()
+        })
+    });
+    group.bench_function("combined_filters", |b| {
+        b.iter(|| {
+            db.query_events("s1", |q| {
+                let mut q = q
+                    .function_contains("process_buffer")
+                    .event_type(EventType::FunctionExit)
+                    .limit(500);
+                q.min_duration_ns = Some(10_000);
+                q
+            })
+            .unwrap()
+        })
+    });
+    group.finish();
+}
+
+fn bench_pattern_matching(c: &mut Criterion) {
+    // Realistic corpus shape: namespaced C++/Rust-style names with hash
+    // suffixes, the kind debug_trace patterns run against
+    let corpus: Vec<String> = (0..10_000)
+        .map(|i| {
+            let module = ["audio", "midi", "engine", "juce::dsp", "std::vector"][i % 5];
+            format!("{}::process_{}::h{:016x}", module, i % 512, i)
+        })
+        .collect();
+
+    let mut group = c.benchmark_group("pattern_matcher_10k_names");
+    group.throughput(Throughput::Elements(corpus.len() as u64));
+    for pattern in ["audio::*", "audio::**", "**::process_42**", "juce::dsp::**"] {
+        group.bench_with_input(
+            BenchmarkId::from_parameter(pattern),
+            &pattern,
+            |b, pattern| {
+                b.iter(|| {
+                    let matcher = PatternMatcher::new(pattern);
+                    corpus.iter().filter(|n| matcher.matches(n)).count()
+                })
+            },
+        );
+    }
+    group.finish();
+}
+
+/// Build the C++ fixture (cached across runs by common test infrastructure
+/// conventions: skip when the binary is newer than the sources).
+fn cpp_fixture_binary() -> Option<PathBuf> {
+    let fixture_dir = PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("tests/fixtures/cpp");
+    let binary = fixture_dir.join("build/strobe_test_target");
+    if binary.exists() {
+        return Some(binary);
+    }
+
+    let build_dir = fixture_dir.join("build");
+    std::fs::create_dir_all(&build_dir).ok()?;
+    let configure = std::process::Command::new("cmake")
+        .args(["-S", ".", "-B", "build", "-DCMAKE_BUILD_TYPE=Debug"])
+        .current_dir(&fixture_dir)
+        .output()
+        .ok()?;
+    if !configure.status.success() {
+        return None;
+    }
+    let build = std::process::Command::new("cmake")
+        .args(["--build", "build"])
+        .current_dir(&fixture_dir)
+        .output()
+        .ok()?;
+    if !build.status.success() {
+        return None;
+    }
+    binary.exists().then_some(binary)
+}
+
+fn bench_dwarf_parse(c: &mut Criterion) {
+    let Some(binary) = cpp_fixture_binary() else {
+        eprintln!("Skipping dwarf_parse benches: C++ fixture unavailable (no CMake toolchain?)");
+        return;
+    };
+
+    let mut group = c.benchmark_group("dwarf_parse");
+    group.sample_size(10);
+    // First call populates the on-disk cache; steady-state iterations measure
+    // the warm rehydration path, which is what real session creation pays
+    group.bench_function("parse_with_options", |b| {
+        b.iter(|| DwarfParser::parse_with_options(&binary, None, None).unwrap())
+    });
+
+    let parser = DwarfParser::parse_with_options(&binary, None, None).unwrap();
+    group.bench_function("find_by_pattern_deep", |b| {
+        b.iter(|| parser.find_by_pattern("audio::**").len())
+    });
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_ingest,
+    bench_query,
+    bench_pattern_matching,
+    bench_dwarf_parse
+);
+criterion_main!(benches);
@@ -0,0 +1,311 @@
+//! Write-behind event writer: one task per session, draining the event
+//! channel into large batched SQLite transactions.
+//!
+//! The agent-facing message handlers only `try_send` into a bounded channel,
+//! so a burst from a broad pattern never stalls the Frida message thread.
+//! This task pulls whole runs of events with `recv_many` and commits them in
+//! one `BEGIN`/`COMMIT` (up to [`MAX_TRANSACTION_EVENTS`] per transaction)
+//! instead of a transaction per small drain.
+//!
+//! Backpressure is exposed as a shared queue-depth gauge: the depth counts
+//! events accepted off the channel but not yet committed, plus whatever is
+//! still queued in the channel. Producers (e.g. the shm reader) consult the
+//! channel's remaining capacity and pause draining when it saturates, which
+//! feeds back into the agent's adaptive sampling.
+
+use crate::db::{Database, Event};
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, RwLock};
+use tokio::sync::{mpsc, watch};
+
+/// Maximum events committed per SQLite transaction. Large enough that commit
+/// overhead amortizes to noise, small enough that a flush never holds the
+/// connection lock long enough to starve queries.
+pub const MAX_TRANSACTION_EVENTS: usize = 2000;
+
+/// Writer shards per session: each shard owns a channel and a writer task,
+/// and producers are assigned a shard by PID (see `ShardedEventTx`). Commits
+/// still serialize on the SQLite connection, but in a fork storm one hot
+/// child can no longer fill the session's only channel and force drops on
+/// every sibling, and shards stage their batches concurrently.
+pub const WRITER_SHARDS: usize = 4;
+
+/// How long a partial batch may sit before being committed anyway.
+const FLUSH_INTERVAL_MS: u64 = 10;
+
+/// How many flushes between re-reads of the per-session event limit
+/// (avoids taking the limits lock on every commit).
+const LIMIT_REFRESH_FLUSHES: u32 = 10;
+
+/// Number of events buffered by a session's writer but not yet committed.
+/// Cloned into the writer task and readable from anywhere via SessionManager.
+pub type QueueDepth = Arc<AtomicUsize>;
+
+/// Spawn the write-behind task for one session. Returns the join handle
+/// (awaited by `flush_writer` on stop) and the queue-depth gauge.
+///
+/// The task exits after committing any remaining events once `cancel_rx`
+/// flips or the channel closes.
+pub fn spawn(
+    session_id: String,
+    mut rx: mpsc::Receiver<Event>,
+    db: Database,
+    event_limits: Arc<RwLock<HashMap<String, usize>>>,
+    mut cancel_rx: watch::Receiver<bool>,
+) -> (tokio::task::JoinHandle<()>, QueueDepth) {
+    let depth: QueueDepth = Arc::new(AtomicUsize::new(0));
+    let depth_for_task = Arc::clone(&depth);
+
+    let handle = tokio::spawn(async move {
+        let mut batch: Vec<Event> = Vec::with_capacity(MAX_TRANSACTION_EVENTS);
+        let mut cached_limit = crate::config::StrobeSettings::default().events_max_per_session;
+        let mut flushes_since_refresh = LIMIT_REFRESH_FLUSHES; // refresh on first flush
+
+        let flush = |batch: &mut Vec<Event>,
+                     cached_limit: &mut usize,
+                     flushes_since_refresh: &mut u32| {
+            if batch.is_empty() {
+                return;
+            }
+            if *flushes_since_refresh >= LIMIT_REFRESH_FLUSHES {
+                *cached_limit = event_limits
+                    .read()
+                    .unwrap_or_else(|e| e.into_inner())
+                    .get(&session_id)
+                    .copied()
+                    .unwrap_or(crate::config::StrobeSettings::default().events_max_per_session);
+                *flushes_since_refresh = 0;
+            }
+            *flushes_since_refresh += 1;
+            let flush_start = std::time::Instant::now();
+            match db.insert_events_with_limit(batch, *cached_limit) {
+                Ok(stats) => {
+                    super::metrics::metrics().record_flush(
+                        batch.len() as u64,
+                        stats.events_deleted as u64,
+                        flush_start.elapsed().as_nanos() as u64,
+                    );
+                    if stats.events_deleted > 0 {
+                        tracing::warn!(
+                            "Event limit cleanup: deleted {} old events from {} session(s) to stay within {} event limit",
+                            stats.events_deleted,
+                            stats.sessions_cleaned.len(),
+                            cached_limit
+                        );
+                    }
+                }
+                Err(e) => {
+                    tracing::error!("Failed to insert events: {}", e);
+                }
+            }
+            batch.clear();
+            depth_for_task.store(0, Ordering::Relaxed);
+        };
+
+        // Pinned flush deadline: only advanced after an actual flush, so a
+        // steady sub-interval event stream can't keep restarting the timer
+        // and leave a partial batch uncommitted past FLUSH_INTERVAL_MS.
+        let flush_interval = std::time::Duration::from_millis(FLUSH_INTERVAL_MS);
+        let mut next_flush = tokio::time::Instant::now() + flush_interval;
+
+        loop {
+            let room = MAX_TRANSACTION_EVENTS.saturating_sub(batch.len()).max(1);
+            tokio::select! {
+                // recv_many pulls every queued event (up to the transaction cap)
+                // in one wakeup, so bursts land in a handful of large commits.
+                n = rx.recv_many(&mut batch, room) => {
+                    if n == 0 {
+                        // Channel closed — all senders dropped
+                        flush(&mut batch, &mut cached_limit, &mut flushes_since_refresh);
+                        break;
+                    }
+                    depth_for_task.store(batch.len(), Ordering::Relaxed);
+                    if batch.len() >= MAX_TRANSACTION_EVENTS {
+                        flush(&mut batch, &mut cached_limit, &mut flushes_since_refresh);
+                        next_flush = tokio::time::Instant::now() + flush_interval;
+                    }
+                }
+                _ = tokio::time::sleep_until(next_flush) => {
+                    flush(&mut batch, &mut cached_limit, &mut flushes_since_refresh);
+                    next_flush = tokio::time::Instant::now() + flush_interval;
+                }
+                _ = cancel_rx.changed() => {
+                    // Final flush: drain anything still queued, then commit
+                    while let Ok(event) = rx.try_recv() {
+                        batch.push(event);
+                        if batch.len() >= MAX_TRANSACTION_EVENTS {
+                            flush(&mut batch, &mut cached_limit, &mut flushes_since_refresh);
+                        }
+                    }
+                    flush(&mut batch, &mut cached_limit, &mut flushes_since_refresh);
+                    break;
+                }
+            }
+        }
+    });
+
+    (handle, depth)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::db::EventType;
+    use tempfile::tempdir;
+
+    fn make_event(session_id: &str, n: u64) -> Event {
+        Event {
+            id: format!("{}-{}", session_id, n),
+            session_id: session_id.to_string(),
+            timestamp_ns: n as i64,
+            event_type: EventType::FunctionEnter,
+            function_name: "test::func".to_string(),
+            ..Default::default()
+        }
+    }
+
+    async fn setup(
+        limit: usize,
+    ) -> (
+        tempfile::TempDir,
+        Database,
+        Arc<RwLock<HashMap<String, usize>>>,
+    ) {
+        let dir = tempdir().unwrap();
+        let db = Database::open(&dir.path().join("test.db")).unwrap();
+        db.create_session("s1", "/bin/app", "/proj", 1).unwrap();
+        let limits = Arc::new(RwLock::new(HashMap::from([("s1".to_string(), limit)])));
+        (dir, db, limits)
+    }
+
+    #[tokio::test]
+    async fn test_events_committed_in_batches() {
+        let (_dir, db, limits) = setup(10_000).await;
+        let (tx, rx) = mpsc::channel(10_000);
+        let (cancel_tx, cancel_rx) = watch::channel(false);
+        let (handle, _depth) = spawn("s1".to_string(), rx, db.clone(), limits, cancel_rx);
+
+        for n in 0..500 {
+            tx.send(make_event("s1", n)).await.unwrap();
+        }
+        // Cancel flushes the remainder and exits
+        cancel_tx.send(true).unwrap();
+        handle.await.unwrap();
+
+        assert_eq!(db.count_session_events("s1").unwrap(), 500);
+    }
+
+    #[tokio::test]
+    async fn test_cancel_flushes_pending_queue() {
+        let (_dir, db, limits) = setup(10_000).await;
+        let (tx, rx) = mpsc::channel(10_000);
+        let (cancel_tx, cancel_rx) = watch::channel(false);
+
+        // Queue events BEFORE the writer starts, then cancel immediately —
+        // the final drain must still commit everything.
+        for n in 0..250 {
+            tx.send(make_event("s1", n)).await.unwrap();
+        }
+        let (handle, _depth) = spawn("s1".to_string(), rx, db.clone(), limits, cancel_rx);
+        cancel_tx.send(true).unwrap();
+        handle.await.unwrap();
+
+        assert_eq!(db.count_session_events("s1").unwrap(), 250);
+    }
+
+    #[tokio::test]
+    async fn test_limit_enforced_across_batches() {
+        let (_dir, db, limits) = setup(100).await;
+        let (tx, rx) = mpsc::channel(10_000);
+        let (cancel_tx, cancel_rx) = watch::channel(false);
+        let (handle, _depth) = spawn("s1".to_string(), rx, db.clone(), limits, cancel_rx);
+
+        for n in 0..300 {
+            tx.send(make_event("s1", n)).await.unwrap();
+        }
+        // Let the flush timer commit the first wave; eviction runs against
+        // committed rows, so a second wave must bring the session back to
+        // its limit regardless of how the first wave was batched.
+        tokio::time::sleep(std::time::Duration::from_millis(100)).await;
+        for n in 300..380 {
+            tx.send(make_event("s1", n)).await.unwrap();
+        }
+        cancel_tx.send(true).unwrap();
+        handle.await.unwrap();
+
+        // FIFO eviction keeps the session at its limit
+        assert_eq!(db.count_session_events("s1").unwrap(), 100);
+    }
+
+    #[tokio::test]
+    async fn test_sharded_writers_merge_into_session_store() {
+        let (_dir, db, limits) = setup(10_000).await;
+        let (cancel_tx, cancel_rx) = watch::channel(false);
+
+        // Two shards of the same session, as start_session wires them: shared
+        // cancel token, independent channels, one store underneath.
+        let (tx_a, rx_a) = mpsc::channel(10_000);
+        let (tx_b, rx_b) = mpsc::channel(10_000);
+        let (handle_a, _) = spawn(
+            "s1".to_string(),
+            rx_a,
+            db.clone(),
+            Arc::clone(&limits),
+            cancel_rx.clone(),
+        );
+        let (handle_b, _) = spawn("s1".to_string(), rx_b, db.clone(), limits, cancel_rx);
+
+        for n in 0..100 {
+            tx_a.send(make_event("s1", n)).await.unwrap();
+            tx_b.send(make_event("s1", 1000 + n)).await.unwrap();
+        }
+        cancel_tx.send(true).unwrap();
+        handle_a.await.unwrap();
+        handle_b.await.unwrap();
+
+        assert_eq!(db.count_session_events("s1").unwrap(), 200);
+    }
+
+    #[tokio::test]
+    async fn test_steady_stream_flushes_within_interval() {
+        let (_dir, db, limits) = setup(10_000).await;
+        let (tx, rx) = mpsc::channel(10_000);
+        let (cancel_tx, cancel_rx) = watch::channel(false);
+        let (handle, _depth) = spawn("s1".to_string(), rx, db.clone(), limits, cancel_rx);
+
+        // Events arriving faster than FLUSH_INTERVAL_MS must still commit —
+        // the flush deadline is pinned, not restarted by each wakeup.
+        for n in 0..30 {
+            tx.send(make_event("s1", n)).await.unwrap();
+            tokio::time::sleep(std::time::Duration::from_millis(3)).await;
+        }
+        assert!(
+            db.count_session_events("s1").unwrap() > 0,
+            "partial batch sat uncommitted through a steady stream"
+        );
+
+        cancel_tx.send(true).unwrap();
+        handle.await.unwrap();
+        assert_eq!(db.count_session_events("s1").unwrap(), 30);
+    }
+
+    #[tokio::test]
+    async fn test_depth_gauge_resets_after_flush() {
+        let (_dir, db, limits) = setup(10_000).await;
+        let (tx, rx) = mpsc::channel(10_000);
+        let (cancel_tx, cancel_rx) = watch::channel(false);
+        let (handle, depth) = spawn("s1".to_string(), rx, db.clone(), limits, cancel_rx);
+
+        for n in 0..50 {
+            tx.send(make_event("s1", n)).await.unwrap();
+        }
+        // Give the flush timer a couple of cycles
+        tokio::time::sleep(std::time::Duration::from_millis(50)).await;
+        assert_eq!(depth.load(Ordering::Relaxed), 0);
+        assert_eq!(db.count_session_events("s1").unwrap(), 50);
+
+        cancel_tx.send(true).unwrap();
+        handle.await.unwrap();
+    }
+}
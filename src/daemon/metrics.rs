@@ -0,0 +1,178 @@
+//! Always-on pipeline metrics for the event hot path.
+//!
+//! When tracing degrades, the first question is where: the agent drain, the
+//! Frida channel, or SQLite. These process-wide counters answer it without a
+//! profiler attached — received vs. written separates channel loss from write
+//! lag, flush timings isolate SQLite, and the per-session gauges (queue
+//! depth, hook counts) live in `SessionManager` and are merged in by the
+//! `debug_metrics` tool.
+//!
+//! Everything is a relaxed atomic: increments cost a few nanoseconds on the
+//! message-handler and writer threads, so the counters stay on in production.
+//! Exposed through the `debug_metrics` MCP tool and, when
+//! `STROBE_METRICS_ADDR` is set, a plain-text Prometheus endpoint.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::OnceLock;
+use std::time::Instant;
+
+#[derive(Default)]
+pub struct PipelineMetrics {
+    /// Events accepted off the agent (JS message handler + shm ring drain).
+    pub events_received: AtomicU64,
+    /// Events lost because a session's writer channel was full.
+    pub events_dropped: AtomicU64,
+    /// Events committed to SQLite.
+    pub events_written: AtomicU64,
+    /// Events evicted by the per-session FIFO limit.
+    pub events_evicted: AtomicU64,
+    /// Completed writer flushes (one batched transaction each).
+    pub db_flush_count: AtomicU64,
+    /// Cumulative flush wall time, for mean flush duration.
+    pub db_flush_ns_total: AtomicU64,
+    /// Slowest single flush since daemon start.
+    pub db_flush_ns_max: AtomicU64,
+}
+
+impl PipelineMetrics {
+    pub fn record_received(&self, n: u64) {
+        self.events_received.fetch_add(n, Ordering::Relaxed);
+    }
+
+    pub fn record_dropped(&self, n: u64) {
+        self.events_dropped.fetch_add(n, Ordering::Relaxed);
+    }
+
+    pub fn record_flush(&self, events_written: u64, events_evicted: u64, duration_ns: u64) {
+        self.events_written
+            .fetch_add(events_written, Ordering::Relaxed);
+        self.events_evicted
+            .fetch_add(events_evicted, Ordering::Relaxed);
+        self.db_flush_count.fetch_add(1, Ordering::Relaxed);
+        self.db_flush_ns_total
+            .fetch_add(duration_ns, Ordering::Relaxed);
+        self.db_flush_ns_max
+            .fetch_max(duration_ns, Ordering::Relaxed);
+    }
+
+    /// JSON snapshot for the `debug_metrics` MCP tool.
+    pub fn snapshot(&self) -> serde_json::Value {
+        let flushes = self.db_flush_count.load(Ordering::Relaxed);
+        let flush_ns_total = self.db_flush_ns_total.load(Ordering::Relaxed);
+        serde_json::json!({
+            "uptimeSecs": uptime().as_secs(),
+            "eventsReceived": self.events_received.load(Ordering::Relaxed),
+            "eventsDropped": self.events_dropped.load(Ordering::Relaxed),
+            "eventsWritten": self.events_written.load(Ordering::Relaxed),
+            "eventsEvicted": self.events_evicted.load(Ordering::Relaxed),
+            "dbFlushCount": flushes,
+            "dbFlushMeanUs": if flushes > 0 { flush_ns_total / flushes / 1_000 } else { 0 },
+            "dbFlushMaxUs": self.db_flush_ns_max.load(Ordering::Relaxed) / 1_000,
+        })
+    }
+
+    /// Prometheus text exposition (version 0.0.4).
+    pub fn prometheus_text(&self) -> String {
+        let mut out = String::with_capacity(1024);
+        let mut counter = |name: &str, help: &str, value: u64| {
+            out.push_str(&format!(
+                "# HELP {name} {help}\n# TYPE {name} counter\n{name} {value}\n"
+            ));
+        };
+        counter(
+            "strobe_events_received_total",
+            "Events accepted off the agent",
+            self.events_received.load(Ordering::Relaxed),
+        );
+        counter(
+            "strobe_events_dropped_total",
+            "Events lost to a full writer channel",
+            self.events_dropped.load(Ordering::Relaxed),
+        );
+        counter(
+            "strobe_events_written_total",
+            "Events committed to SQLite",
+            self.events_written.load(Ordering::Relaxed),
+        );
+        counter(
+            "strobe_events_evicted_total",
+            "Events evicted by per-session FIFO limits",
+            self.events_evicted.load(Ordering::Relaxed),
+        );
+        counter(
+            "strobe_db_flush_total",
+            "Completed batched SQLite flushes",
+            self.db_flush_count.load(Ordering::Relaxed),
+        );
+        counter(
+            "strobe_db_flush_nanoseconds_total",
+            "Cumulative flush wall time",
+            self.db_flush_ns_total.load(Ordering::Relaxed),
+        );
+        out.push_str(&format!(
+            "# HELP strobe_db_flush_max_nanoseconds Slowest single flush since start\n# TYPE strobe_db_flush_max_nanoseconds gauge\nstrobe_db_flush_max_nanoseconds {}\n",
+            self.db_flush_ns_max.load(Ordering::Relaxed)
+        ));
+        out.push_str(&format!(
+            "# HELP strobe_uptime_seconds Daemon uptime\n# TYPE strobe_uptime_seconds gauge\nstrobe_uptime_seconds {}\n",
+            uptime().as_secs()
+        ));
+        out
+    }
+}
+
+/// Process-wide metrics instance. First access pins the uptime epoch.
+pub fn metrics() -> &'static PipelineMetrics {
+    static METRICS: OnceLock<PipelineMetrics> = OnceLock::new();
+    METRICS.get_or_init(|| {
+        start_instant();
+        PipelineMetrics::default()
+    })
+}
+
+fn start_instant() -> Instant {
+    static START: OnceLock<Instant> = OnceLock::new();
+    *START.get_or_init(Instant::now)
+}
+
+fn uptime() -> std::time::Duration {
+    start_instant().elapsed()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_flush_accounting() {
+        let m = PipelineMetrics::default();
+        m.record_received(100);
+        m.record_dropped(2);
+        m.record_flush(90, 10, 3_000_000);
+        m.record_flush(8, 0, 1_000_000);
+
+        let snap = m.snapshot();
+        assert_eq!(snap["eventsReceived"], 100);
+        assert_eq!(snap["eventsDropped"], 2);
+        assert_eq!(snap["eventsWritten"], 98);
+        assert_eq!(snap["eventsEvicted"], 10);
+        assert_eq!(snap["dbFlushCount"], 2);
+        assert_eq!(snap["dbFlushMeanUs"], 2_000);
+        assert_eq!(snap["dbFlushMaxUs"], 3_000);
+    }
+
+    #[test]
+    fn test_prometheus_text_format() {
+        let m = PipelineMetrics::default();
+        m.record_received(5);
+        m.record_flush(5, 0, 500);
+
+        let text = m.prometheus_text();
+        assert!(text.contains("# TYPE strobe_events_received_total counter"));
+        assert!(text.contains("strobe_events_received_total 5"));
+        assert!(text.contains("strobe_events_written_total 5"));
+        assert!(text.contains("# TYPE strobe_uptime_seconds gauge"));
+        // Every sample line ends with a newline (exposition format requirement)
+        assert!(text.ends_with('\n'));
+    }
+}
@@ -1,3 +1,5 @@
+mod event_writer;
+pub mod metrics;
 mod server;
 mod session_manager;
 
@@ -51,6 +51,10 @@ pub struct Daemon {
     /// notifications/progress (MCP 2025-06-18) on long-running operations
     /// without blocking the synchronous request/response loop.
     notification_senders: Arc<RwLock<HashMap<String, NotificationSender>>>,
+    /// Per-session subtree hashes from the last debug_ui tree capture,
+    /// so delta captures can elide unchanged subtrees. Entries are a few
+    /// bytes per UI node and are overwritten on every capture.
+    ui_subtree_hashes: Arc<RwLock<HashMap<String, HashMap<String, u64>>>>,
 }
 
 fn format_event(event: &crate::db::Event, verbose: bool) -> serde_json::Value {
@@ -83,6 +87,19 @@ fn format_event(event: &crate::db::Event, verbose: bool) -> serde_json::Value {
         });
     }
 
+    if event.event_type == crate::db::EventType::AggregateSummary {
+        return serde_json::json!({
+            "id": event.id,
+            "timestamp_ns": event.timestamp_ns,
+            "eventType": "aggregate_summary",
+            "pid": event.pid,
+            "function": event.function_name,
+            "sourceFile": event.source_file,
+            "line": event.line_number,
+            "summary": event.arguments,
+        });
+    }
+
     if event.event_type == crate::db::EventType::Stdout
         || event.event_type == crate::db::EventType::Stderr
     {
@@ -158,6 +175,7 @@ fn format_event(event: &crate::db::Event, verbose: bool) -> serde_json::Value {
             "arguments": event.arguments,
             "returnValue": event.return_value,
             "watchValues": event.watch_values,
+            "backtrace": event.backtrace,
             "logpointMessage": event.logpoint_message,
         })
     } else {
@@ -185,10 +203,43 @@ fn format_event(event: &crate::db::Event, verbose: bool) -> serde_json::Value {
         if let Some(ref msg) = event.logpoint_message {
             obj["logpointMessage"] = serde_json::Value::String(msg.clone());
         }
+        if let Some(ref bt) = event.backtrace {
+            obj["backtrace"] = bt.clone();
+        }
         obj
     }
 }
 
+/// Fill in functionName/file/line for raw backtrace frames captured by the
+/// agent's native frame-pointer unwinder. Frames arrive as bare static
+/// addresses; resolving them here means capture costs a few loads per call
+/// while the DWARF lookups run once, at query time, for returned events only.
+/// Frames that are already symbolized (crash/pause backtraces) pass through.
+fn symbolize_backtrace(backtrace: &mut serde_json::Value, dwarf: &crate::dwarf::DwarfParser) {
+    let Some(frames) = backtrace.as_array_mut() else {
+        return;
+    };
+    for frame in frames {
+        if frame.get("functionName").is_some() {
+            continue;
+        }
+        let Some(addr) = frame
+            .get("address")
+            .and_then(|v| v.as_str())
+            .and_then(|s| u64::from_str_radix(s.trim_start_matches("0x"), 16).ok())
+        else {
+            continue;
+        };
+        if let Some(func) = dwarf.function_at_address(addr) {
+            frame["functionName"] = serde_json::Value::String(func.name.clone());
+        }
+        if let Some((file, line, _col)) = dwarf.resolve_address(addr) {
+            frame["file"] = serde_json::Value::String(file);
+            frame["line"] = serde_json::json!(line);
+        }
+    }
+}
+
 /// Parse a type hint string (e.g. "u32", "f64", "pointer") into (size_bytes, type_kind_str).
 pub fn parse_type_hint(hint: &str) -> (u8, String) {
     match hint {
@@ -356,8 +407,53 @@ impl Daemon {
                 crate::ui::vision::VisionSidecar::new(),
             )),
             notification_senders: Arc::new(RwLock::new(HashMap::new())),
+            ui_subtree_hashes: Arc::new(RwLock::new(HashMap::new())),
         });
 
+        // Warm the Frida device manager before the first session arrives:
+        // enumeration + spawn-gating setup runs on the coordinator thread now
+        // instead of adding latency to the first spawn.
+        daemon.session_manager.prewarm_frida().await;
+
+        // Optional Prometheus exposition endpoint. Off unless an address is
+        // configured — the MCP debug_metrics tool is the always-available view.
+        if let Ok(addr) = std::env::var("STROBE_METRICS_ADDR") {
+            match tokio::net::TcpListener::bind(&addr).await {
+                Ok(metrics_listener) => {
+                    tracing::info!("Prometheus metrics endpoint on http://{}/metrics", addr);
+                    tokio::spawn(async move {
+                        loop {
+                            let (mut stream, _) = match metrics_listener.accept().await {
+                                Ok(conn) => conn,
+                                Err(e) => {
+                                    tracing::warn!("Metrics endpoint accept error: {}", e);
+                                    tokio::time::sleep(Duration::from_millis(100)).await;
+                                    continue;
+                                }
+                            };
+                            tokio::spawn(async move {
+                                use tokio::io::{AsyncReadExt, AsyncWriteExt};
+                                // Drain the request line; every GET serves the
+                                // same document, so no routing needed
+                                let mut buf = [0u8; 1024];
+                                let _ = stream.read(&mut buf).await;
+                                let body = super::metrics::metrics().prometheus_text();
+                                let response = format!(
+                                    "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}",
+                                    body.len(),
+                                    body
+                                );
+                                let _ = stream.write_all(response.as_bytes()).await;
+                            });
+                        }
+                    });
+                }
+                Err(e) => {
+                    tracing::warn!("Failed to bind metrics endpoint {}: {}", addr, e);
+                }
+            }
+        }
+
         let listener = UnixListener::bind(&socket_path)?;
         tracing::info!("Daemon listening on {:?}", socket_path);
 
@@ -578,8 +674,7 @@ impl Daemon {
         let handle = tokio::spawn(async move {
             let start = std::time::Instant::now();
             let mut tick: u64 = 0;
-            let mut interval =
-                tokio::time::interval(std::time::Duration::from_millis(1500));
+            let mut interval = tokio::time::interval(std::time::Duration::from_millis(1500));
             interval.tick().await;
 
             loop {
@@ -824,7 +919,7 @@ If behavior requires user action (button press, network event), tell the user wh
 
 ## Limits
 
-- Aim for <50 hooks (fast, stable). 100+ risks crashes. Hard cap: 100 per debug_trace call.
+- Aim for <100 hooks (fast install, manageable event volume). Hard cap: 1000 per debug_trace call — coverage-style runs work, but broad patterns still drown the event budget; hot functions degrade to aggregate_summary statistics.
 - Default 200k events/session (FIFO). Configure via .strobe/settings.json. Use 500k for audio/DSP; avoid 1M+.
 
 ## Watches
@@ -836,9 +931,9 @@ Read globals during function execution (requires DWARF symbols). Max 32 watches.
 
 ## Queries
 
-- eventType: `stderr`/`stdout` (always captured), `function_enter`/`function_exit` (when tracing), `pause`/`logpoint`/`condition_error`/`variable_snapshot`/`crash`
+- eventType: `stderr`/`stdout` (always captured), `function_enter`/`function_exit` (when tracing), `pause`/`logpoint`/`condition_error`/`variable_snapshot`/`crash`, `aggregate_summary` (hot functions degraded to count/duration statistics)
 - Filters: `function: { contains }`, `sourceFile: { contains }`, `verbose: true`
-- Default 50 events. Paginate with `offset`/`afterEventId`. Check `hasMore`.
+- Default 50 events. Page older with `beforeEventId` (use `firstEventId` from the previous page), poll newer with `afterEventId`. Check `hasMore`. Avoid `offset` on large sessions — it degrades linearly.
 
 ## Running Tests
 
@@ -851,6 +946,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
 ## UI (macOS only)
 
 - `debug_ui` returns accessibility tree and/or screenshots. Start with `mode: \"tree\"`.
+- Repeated captures in an automation loop: pass `delta: true` to get only subtrees that changed since the last capture.
 - Pass `id` with screenshot mode to crop to a specific element.
 - **App state matters**: use `debug_ui_action` to navigate (click tabs, open menus) before inspecting.
 - `debug_ui_action` returns `{ success, nodeBefore, nodeAfter, changed }` — verify actions took effect.
@@ -878,12 +974,12 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
             },
             McpTool {
                 name: "debug_session".to_string(),
-                description: "Manage debug sessions: get status, stop, list retained, or delete. Use action to select operation.".to_string(),
+                description: "Manage debug sessions: get status, stop, list retained, delete, or resume. Resume re-attaches to a still-running native target after a daemon restart and replays its checkpointed hooks/watches.".to_string(),
                 input_schema: serde_json::json!({
                     "type": "object",
                     "properties": {
-                        "action": { "type": "string", "enum": ["status", "stop", "list", "delete"], "description": "Action to perform" },
-                        "sessionId": { "type": "string", "description": "Session ID (required for status/stop/delete)" },
+                        "action": { "type": "string", "enum": ["status", "stop", "list", "delete", "resume"], "description": "Action to perform" },
+                        "sessionId": { "type": "string", "description": "Session ID (required for status/stop/delete/resume)" },
                         "retain": { "type": "boolean", "description": "Retain session data for post-mortem debugging (default: false, only for action: 'stop')" }
                     },
                     "required": ["action"]
@@ -896,7 +992,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                     "type": "object",
                     "properties": {
                         "sessionId": { "type": "string", "description": "Session ID. Omit to set pending patterns for the next debug_launch. Provide to modify a running session." },
-                        "add": { "type": "array", "items": { "type": "string" }, "description": "Patterns to start tracing (e.g. \"mymodule::*\", \"*::init\", \"@usercode\")" },
+                        "add": { "type": "array", "items": { "type": "string" }, "description": "Patterns to start tracing (e.g. \"mymodule::*\", \"*::init\", \"@usercode\"). A pattern may carry an argument predicate suffix like \"processBlock(arg1 != 512)\" or \"getNext(arg0 == null)\" — native hooks then drop non-matching calls in-process without producing events. Operators: == != < > <= >=; values: integer, 0x hex, or null; arg0-arg7." },
                         "remove": { "type": "array", "items": { "type": "string" }, "description": "Patterns to stop tracing" },
                         "serializationDepth": { "type": "integer", "description": "Maximum depth for recursive argument serialization (default: 3, max: 10)", "minimum": 1, "maximum": 10 },
                         "projectRoot": { "type": "string", "description": "Root directory for user code detection" },
@@ -918,7 +1014,8 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                                                 "type": "array",
                                                 "items": { "type": "string" },
                                                 "description": "Optional function patterns to scope this watch (e.g. ['NoteOn', 'audio::*']). Supports wildcards: * (shallow, stops at ::), ** (deep, crosses ::). If omitted, watch is global (captured on all traced functions)."
-                                            }
+                                            },
+                                            "sampleHz": { "type": "integer", "description": "Sample this watch on a timer at the given rate (Hz, max 50000) in addition to function triggers. A native sampler thread records the value as variable_snapshot events — use for transients between traced calls. Variable/address watches only.", "minimum": 1, "maximum": 50000 }
                                         }
                                     }
                                 },
@@ -939,7 +1036,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                     "type": "object",
                     "properties": {
                         "sessionId": { "type": "string" },
-                        "eventType": { "type": "string", "enum": ["function_enter", "function_exit", "stdout", "stderr", "crash", "variable_snapshot", "pause", "logpoint", "condition_error"] },
+                        "eventType": { "type": "string", "enum": ["function_enter", "function_exit", "stdout", "stderr", "crash", "variable_snapshot", "pause", "logpoint", "condition_error", "aggregate_summary"] },
                         "function": {
                             "type": "object",
                             "properties": {
@@ -985,7 +1082,8 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                         "limit": { "type": "integer", "default": 50, "maximum": 500 },
                         "offset": { "type": "integer" },
                         "verbose": { "type": "boolean", "default": false },
-                        "afterEventId": { "type": "integer", "description": "Cursor: return only events with rowid > afterEventId (for incremental polling)" }
+                        "afterEventId": { "type": "integer", "description": "Cursor: return only events with rowid > afterEventId (for incremental polling)" },
+                        "beforeEventId": { "type": "integer", "description": "Keyset cursor: return only events with rowid < beforeEventId. Pass the previous page's firstEventId to page newest→oldest at constant cost (prefer over offset, which degrades with depth)" }
                     },
                     "required": ["sessionId"]
                 }),
@@ -1066,6 +1164,27 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                     "required": ["sessionId", "targets"]
                 }),
             },
+            McpTool {
+                name: "debug_profile".to_string(),
+                description: "Sample a running session's thread stacks at a configurable frequency and return folded-stack (flame graph) data, hottest stacks first. Use this to find the hot function before choosing debug_trace patterns, instead of tracing broadly and burning the event budget. On Linux this uses perf_event_open (user-space samples only) and needs kernel.perf_event_paranoid <= 2 or CAP_PERFMON; the error message says which when the kernel refuses.".to_string(),
+                input_schema: serde_json::json!({
+                    "type": "object",
+                    "properties": {
+                        "sessionId": { "type": "string", "description": "Session ID (from debug_launch)" },
+                        "durationMs": { "type": "integer", "description": "How long to sample in ms (100-60000, default 5000)", "minimum": 100, "maximum": 60000 },
+                        "frequencyHz": { "type": "integer", "description": "Target sampling frequency in Hz (1-1000, default 99)", "minimum": 1, "maximum": 1000 }
+                    },
+                    "required": ["sessionId"]
+                }),
+            },
+            McpTool {
+                name: "debug_metrics".to_string(),
+                description: "Report daemon pipeline metrics: events/sec received vs. written, drop and eviction counts, SQLite flush timings, and per-session writer queue depth and hook counts. Use this to locate the bottleneck (agent drain, Frida channel, or SQLite) when tracing degrades.".to_string(),
+                input_schema: serde_json::json!({
+                    "type": "object",
+                    "properties": {}
+                }),
+            },
             McpTool {
                 name: "debug_test".to_string(),
                 description: "Start a test run asynchronously or poll for results. Returns a testRunId immediately — poll with action: 'status' for progress and results. Only one test run at a time per project. Use this instead of running test commands via bash.\n\nPretest scripts (e.g. `pretest:e2e` in package.json) are automatically detected and run before spawning tests. Configure timeout via .strobe/settings.json `test.timeoutMs` or the `timeout` parameter.".to_string(),
@@ -1089,7 +1208,8 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                             }
                         },
                         "env": { "type": "object", "description": "Additional environment variables" },
-                        "timeout": { "type": "integer", "description": "Hard timeout in milliseconds. Overrides adapter default and settings.json. Falls back to: settings.json test.timeoutMs → adapter default (e.g. 600s Playwright, 60-300s bun)." }
+                        "timeout": { "type": "integer", "description": "Hard timeout in milliseconds. Overrides adapter default and settings.json. Falls back to: settings.json test.timeoutMs → adapter default (e.g. 600s Playwright, 60-300s bun)." },
+                        "shards": { "type": "integer", "description": "Split the suite into N parallel processes (2-16). Requires a framework that can enumerate tests (catch2, gtest) and a test binary via 'command'. Results are merged; each shard gets its own stuck detection.", "minimum": 2, "maximum": 16 }
                     }
                 }),
             },
@@ -1102,7 +1222,8 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                         "sessionId": { "type": "string", "description": "Session ID (from debug_launch)" },
                         "mode": { "type": "string", "enum": ["tree", "screenshot", "both"], "description": "Output mode: tree (UI element hierarchy), screenshot (PNG image), or both" },
                         "id": { "type": "string", "description": "Target node ID from debug_ui tree. When provided with screenshot or both mode, crops the screenshot to this element's bounds." },
-                        "verbose": { "type": "boolean", "description": "Return JSON instead of compact text (default: false)" }
+                        "verbose": { "type": "boolean", "description": "Return JSON instead of compact text (default: false)" },
+                        "delta": { "type": "boolean", "description": "Return only subtrees changed since the previous capture of this session; unchanged subtrees are elided (stats.unchangedNodes reports how many). Much cheaper for repeated captures in UI automation loops." }
                     },
                     "required": ["sessionId", "mode"]
                 }),
@@ -1163,6 +1284,8 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
             "debug_session" => self.tool_debug_session(&call.arguments).await,
             "debug_test" => self.tool_debug_test(&call.arguments, connection_id).await,
             "debug_memory" => self.tool_debug_memory(&call.arguments).await,
+            "debug_metrics" => self.tool_debug_metrics().await,
+            "debug_profile" => self.tool_debug_profile(&call.arguments).await,
             "debug_breakpoint" => self.tool_debug_breakpoint(&call.arguments).await,
             "debug_continue" => self.tool_debug_continue(&call.arguments).await,
             "debug_ui" => match self.tool_debug_ui(&call.arguments).await {
@@ -1193,10 +1316,18 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
 
         match result {
             Ok(value) => {
+                // Pretty-print small results for readability. Large event
+                // pages go compact: indentation inflates the payload by
+                // ~40%, and the whole string is escaped a second time when
+                // embedded in the JSON-RPC frame, so the savings compound.
+                let compact = serde_json::to_string(&value)?;
+                let text = if compact.len() <= 4096 {
+                    serde_json::to_string_pretty(&value)?
+                } else {
+                    compact
+                };
                 let response = McpToolCallResponse {
-                    content: vec![McpContent::Text {
-                        text: serde_json::to_string_pretty(&value)?,
-                    }],
+                    content: vec![McpContent::Text { text }],
                     is_error: None,
                 };
                 Ok(serde_json::to_value(response)?)
@@ -1393,6 +1524,17 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
             0, // PID not known yet, updated after spawn
         )?;
 
+        // Spawn-gating: when this connection staged patterns before launch,
+        // keep the process suspended until the initial hook set is confirmed
+        // installed — otherwise startup code runs untraced while hooks
+        // install in the background. Clean launches still resume immediately.
+        let gate_on_patterns = self
+            .pending_patterns
+            .read()
+            .await
+            .get(connection_id)
+            .is_some_and(|p| !p.is_empty());
+
         // Launch always starts fast (no DWARF blocking, no initial hooks).
         // DWARF parsing happens in the background.
         let args_vec = req.args.unwrap_or_default();
@@ -1405,7 +1547,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                 req.cwd.as_deref(),
                 &req.project_root,
                 req.env.as_ref(),
-                false, // debug_launch: resume immediately
+                gate_on_patterns, // defer resume until staged hooks are in
                 req.symbols_path.as_deref(),
             )
             .await
@@ -1454,34 +1596,40 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
             self.session_manager
                 .add_patterns(&session_id, &pending_patterns)?;
 
-            let sm = Arc::clone(&self.session_manager);
-            let sid = session_id.clone();
-            tokio::spawn(async move {
-                match sm
-                    .update_frida_patterns(&sid, Some(&pending_patterns), None, None)
-                    .await
-                {
-                    Ok(result) => {
-                        tracing::info!(
-                            "Deferred hooks installed for {}: {} hooked ({} matched)",
-                            sid,
-                            result.installed,
-                            result.matched
+            // Install the staged hooks while the process is still suspended
+            // (spawned with defer_resume above), then release it — the first
+            // instruction of startup code runs with hooks already attached.
+            match self
+                .session_manager
+                .update_frida_patterns(&session_id, Some(&pending_patterns), None, None)
+                .await
+            {
+                Ok(result) => {
+                    tracing::info!(
+                        "Staged hooks installed for {} before resume: {} hooked ({} matched)",
+                        session_id,
+                        result.installed,
+                        result.matched
+                    );
+                    if !result.warnings.is_empty() {
+                        tracing::warn!(
+                            "Staged hook warnings for {}: {:?}",
+                            session_id,
+                            result.warnings
                         );
-                        if !result.warnings.is_empty() {
-                            tracing::warn!(
-                                "Deferred hook warnings for {}: {:?}",
-                                sid,
-                                result.warnings
-                            );
-                        }
-                        sm.set_hook_count(&sid, result.installed);
-                    }
-                    Err(e) => {
-                        tracing::error!("Failed to install deferred hooks for {}: {}", sid, e);
                     }
+                    self.session_manager
+                        .set_hook_count(&session_id, result.installed);
                 }
-            });
+                Err(e) => {
+                    // The process must not stay suspended on a hook failure
+                    tracing::error!("Failed to install staged hooks for {}: {}", session_id, e);
+                }
+            }
+
+            if let Err(e) = self.session_manager.resume_process(pid).await {
+                tracing::error!("Failed to resume gated process {}: {}", pid, e);
+            }
         }
 
         let (pending_count, next_steps) = if !had_pending_patterns {
@@ -1489,7 +1637,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
         } else {
             (
                 Some(patterns_count),
-                Some(format!("Applied {} pre-configured pattern(s). Note: Recommended workflow is to launch clean, check output first, then add targeted traces. Hooks are installing in background.", patterns_count))
+                Some(format!("Applied {} pre-configured pattern(s) before the process was resumed, so startup code runs traced. Note: Recommended workflow is to launch clean, check output first, then add targeted traces.", patterns_count))
             )
         };
 
@@ -1683,6 +1831,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                                     type_name: Some(type_hint.to_string()),
                                     on_patterns: on_patterns.clone(),
                                     no_slide: true,
+                                    sample_hz: watch_target.sample_hz,
                                 });
 
                                 state_watches.push(crate::daemon::ActiveWatchState {
@@ -1697,6 +1846,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                                     is_expr: false,
                                     expr: None,
                                     no_slide: true,
+                                    sample_hz: watch_target.sample_hz,
                                 });
 
                                 active_watches.push(crate::mcp::ActiveWatch {
@@ -1725,6 +1875,13 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                                     let is_global =
                                         on_patterns.as_ref().map_or(true, |p| p.is_empty());
 
+                                    if watch_target.sample_hz.is_some() {
+                                        watch_warnings.push(format!(
+                                            "Watch '{}': sampleHz only applies to variable/address watches (JS expression watches are trigger-driven)",
+                                            label
+                                        ));
+                                    }
+
                                     expr_watches.push(crate::frida_collector::ExprWatchTarget {
                                         label: label.clone(),
                                         expr: expr.clone(),
@@ -1804,6 +1961,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                                 type_name: recipe.type_name.clone(),
                                 on_patterns: on_patterns.clone(),
                                 no_slide: false,
+                                sample_hz: watch_target.sample_hz,
                             });
 
                             state_watches.push(crate::daemon::ActiveWatchState {
@@ -1818,6 +1976,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                                 is_expr: false,
                                 expr: None,
                                 no_slide: false,
+                                sample_hz: watch_target.sample_hz,
                             });
 
                             active_watches.push(crate::mcp::ActiveWatch {
@@ -1835,6 +1994,9 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                                 .update_frida_watches(session_id, frida_watches, expr_watches)
                                 .await?;
                             self.session_manager.set_watches(session_id, state_watches);
+                            // Watch state changed after update_frida_watches ran,
+                            // so refresh the resume checkpoint here.
+                            self.session_manager.checkpoint_session(session_id).await;
                         }
                     }
 
@@ -1859,6 +2021,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                                     type_name: w.type_name.clone(),
                                     on_patterns: w.on_patterns.clone(),
                                     no_slide: w.no_slide,
+                                    sample_hz: w.sample_hz,
                                 })
                                 .collect();
 
@@ -1866,6 +2029,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                         self.session_manager
                             .update_frida_watches(session_id, frida_watches, vec![])
                             .await?;
+                        self.session_manager.checkpoint_session(session_id).await;
 
                         watch_warnings.push(format!("Removed {} watch(es)", remove_labels.len()));
                     }
@@ -1961,7 +2125,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
             .as_ref()
             .and_then(|v| resolve_time_value(v, latest_ns));
 
-        let events = self
+        let mut events = self
             .session_manager
             .db()
             .query_events(&req.session_id, |mut q| {
@@ -1976,6 +2140,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                         EventTypeFilter::Pause => crate::db::EventType::Pause,
                         EventTypeFilter::Logpoint => crate::db::EventType::Logpoint,
                         EventTypeFilter::ConditionError => crate::db::EventType::ConditionError,
+                        EventTypeFilter::AggregateSummary => crate::db::EventType::AggregateSummary,
                     });
                 }
                 if let Some(ref f) = req.function {
@@ -2011,6 +2176,9 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                 if let Some(after) = req.after_event_id {
                     q.after_rowid = Some(after);
                 }
+                if let Some(before) = req.before_event_id {
+                    q.before_rowid = Some(before);
+                }
                 q.limit(limit).offset(offset)
             })?;
 
@@ -2032,6 +2200,9 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                             EventTypeFilter::Pause => crate::db::EventType::Pause,
                             EventTypeFilter::Logpoint => crate::db::EventType::Logpoint,
                             EventTypeFilter::ConditionError => crate::db::EventType::ConditionError,
+                            EventTypeFilter::AggregateSummary => {
+                                crate::db::EventType::AggregateSummary
+                            }
                         });
                     }
                     if let Some(ref f) = req.function {
@@ -2067,10 +2238,43 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                     if let Some(after) = req.after_event_id {
                         q.after_rowid = Some(after);
                     }
+                    if let Some(before) = req.before_event_id {
+                        q.before_rowid = Some(before);
+                    }
                     q
                 })?;
         let has_more = (offset as u64 + events.len() as u64) < total_count;
 
+        // Lazily symbolize raw frame-pointer backtraces. Capture stores bare
+        // static addresses, so only the events a query actually returns pay
+        // for DWARF resolution — and only when any frame is unresolved.
+        let needs_symbols = events.iter().any(|e| {
+            e.backtrace
+                .as_ref()
+                .and_then(|b| b.as_array())
+                .is_some_and(|frames| frames.iter().any(|f| f.get("functionName").is_none()))
+        });
+        if needs_symbols {
+            if let Ok(Some(dwarf)) = self.session_manager.get_dwarf(&req.session_id).await {
+                for event in &mut events {
+                    if let Some(ref mut bt) = event.backtrace {
+                        symbolize_backtrace(bt, &dwarf);
+                    }
+                }
+            }
+        }
+
+        // Same lazy strategy for captured arguments: capture stores raw
+        // pointers, and the agent serializes them only for events a query
+        // returns. Best-effort — a failure never fails the query.
+        if let Err(e) = self
+            .session_manager
+            .serialize_event_arguments(&req.session_id, &mut events)
+            .await
+        {
+            tracing::debug!("Lazy argument serialization skipped: {}", e);
+        }
+
         // Convert to appropriate format
         let verbose = req.verbose.unwrap_or(false);
         let event_values: Vec<serde_json::Value> =
@@ -2078,6 +2282,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
 
         // Compute cursor fields
         let last_event_id = events.iter().filter_map(|e| e.rowid).max();
+        let first_event_id = events.iter().filter_map(|e| e.rowid).min();
 
         let events_dropped = if let Some(after) = req.after_event_id {
             let min_rowid = self
@@ -2113,6 +2318,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
             has_more,
             pids: if pids.len() > 1 { Some(pids) } else { None },
             last_event_id,
+            first_event_id,
             events_dropped,
             crash,
         };
@@ -2166,6 +2372,67 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
         }
     }
 
+    async fn tool_debug_profile(&self, args: &serde_json::Value) -> Result<serde_json::Value> {
+        let req: crate::mcp::DebugProfileRequest = serde_json::from_value(args.clone())?;
+        req.validate()?;
+        let session = self.require_session(&req.session_id)?;
+
+        let duration_ms = req
+            .duration_ms
+            .unwrap_or(crate::mcp::DEFAULT_PROFILE_DURATION_MS);
+        let frequency_hz = req
+            .frequency_hz
+            .unwrap_or(crate::mcp::DEFAULT_PROFILE_FREQUENCY_HZ);
+
+        tracing::info!(
+            "Profiling session {} (pid {}) for {}ms at {}Hz",
+            req.session_id,
+            session.pid,
+            duration_ms,
+            frequency_hz
+        );
+
+        let mut report =
+            crate::profiler::profile_process(session.pid, duration_ms, frequency_hz).await?;
+
+        // Resolve raw address frames through the session's DWARF index when
+        // available. Sampled addresses are runtime addresses, so the ASLR
+        // slide is subtracted during lookup.
+        if let Ok(Some(dwarf)) = self.session_manager.get_dwarf(&req.session_id).await {
+            let slide = crate::profiler::runtime_slide(
+                session.pid,
+                std::path::Path::new(&session.binary_path),
+            );
+            crate::profiler::symbolize_report(&mut report, &dwarf, slide);
+        }
+
+        let next_steps = if report.samples == 0 {
+            "No samples captured — the process may have exited. Check status with debug_session."
+                .to_string()
+        } else if report.folded.is_empty() {
+            "Samples arrived but carried no stack frames — the binary was likely built without frame pointers. Recompile with -fno-omit-frame-pointer for full stacks.".to_string()
+        } else {
+            format!(
+                "{} distinct stacks across {} samples. The top folded lines are the hot paths — use their leaf frames as debug_trace patterns to drill in.",
+                report.folded.len(),
+                report.samples
+            )
+        };
+
+        let response = crate::mcp::DebugProfileResponse {
+            samples: report.samples,
+            duration_ms,
+            frequency_hz,
+            folded: report
+                .folded
+                .iter()
+                .map(|(stack, count)| format!("{} {}", stack, count))
+                .collect(),
+            next_steps,
+        };
+        Ok(serde_json::to_value(response)?)
+    }
+
     async fn tool_debug_session(&self, args: &serde_json::Value) -> Result<serde_json::Value> {
         let req: DebugSessionRequest = serde_json::from_value(args.clone())?;
         req.validate()?;
@@ -2179,9 +2446,33 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
             SessionAction::Stop => self.tool_debug_stop(args).await,
             SessionAction::List => self.tool_debug_list_sessions().await,
             SessionAction::Delete => self.tool_debug_delete_session(args).await,
+            SessionAction::Resume => self.tool_debug_resume(args).await,
         }
     }
 
+    /// Re-attach to a still-running target after a daemon restart and replay
+    /// the session's checkpointed tracing setup. Resumed sessions are not
+    /// bound to this connection: they survived one daemon already, so client
+    /// disconnects shouldn't tear them down.
+    async fn tool_debug_resume(&self, args: &serde_json::Value) -> Result<serde_json::Value> {
+        let session_id = args
+            .get("sessionId")
+            .and_then(|v| v.as_str())
+            .ok_or_else(|| crate::Error::ValidationError("sessionId is required".to_string()))?;
+
+        let summary = self.session_manager.resume_session(session_id).await?;
+
+        Ok(serde_json::json!({
+            "sessionId": session_id,
+            "pid": summary.pid,
+            "hookedFunctions": summary.hooked_functions,
+            "patterns": summary.patterns,
+            "watchesInstalled": summary.watches_installed,
+            "replayedFromCheckpoint": summary.replayed_from_checkpoint,
+            "warnings": summary.warnings,
+        }))
+    }
+
     async fn tool_debug_stop(&self, args: &serde_json::Value) -> Result<serde_json::Value> {
         let req: DebugStopRequest = serde_json::from_value(args.clone())?;
 
@@ -2253,6 +2544,27 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
         }))
     }
 
+    async fn tool_debug_metrics(&self) -> Result<serde_json::Value> {
+        let mut snapshot = super::metrics::metrics().snapshot();
+
+        // Per-session gauges: writer backlog and installed hooks
+        let sessions: Vec<serde_json::Value> = self
+            .session_manager
+            .get_running_sessions()?
+            .iter()
+            .map(|s| {
+                serde_json::json!({
+                    "sessionId": s.id,
+                    "writerQueueDepth": self.session_manager.writer_queue_depth(&s.id).unwrap_or(0),
+                    "hookCount": self.session_manager.get_hook_count(&s.id),
+                })
+            })
+            .collect();
+        snapshot["sessions"] = serde_json::Value::Array(sessions);
+
+        Ok(snapshot)
+    }
+
     async fn tool_debug_delete_session(
         &self,
         args: &serde_json::Value,
@@ -2387,28 +2699,55 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
             let trace_patterns = req_clone.trace_patterns.unwrap_or_default();
             let project_root = std::path::PathBuf::from(&req_clone.project_root);
 
-            let run_result = runner
-                .run(
-                    &project_root,
-                    req_clone.framework.as_deref(),
-                    req_clone.level,
-                    req_clone.test.as_deref(),
-                    req_clone.command.as_deref(),
-                    &env,
-                    req_clone.timeout, // explicit timeout overrides adapter default + settings.json
-                    &session_manager,
-                    &trace_patterns,
-                    req_clone.watches.as_ref(),
-                    &connection_id_owned,
-                    &session_id_clone,
-                    progress_clone,
-                )
-                .await;
+            let shards = req_clone.shards.filter(|&s| s > 1);
+            let run_result = if let Some(shards) = shards {
+                runner
+                    .run_sharded(
+                        &project_root,
+                        req_clone.framework.as_deref(),
+                        req_clone.level,
+                        req_clone.command.as_deref(),
+                        &env,
+                        req_clone.timeout,
+                        &session_manager,
+                        &trace_patterns,
+                        shards,
+                        &session_id_clone,
+                        progress_clone,
+                    )
+                    .await
+            } else {
+                runner
+                    .run(
+                        &project_root,
+                        req_clone.framework.as_deref(),
+                        req_clone.level,
+                        req_clone.test.as_deref(),
+                        req_clone.command.as_deref(),
+                        &env,
+                        req_clone.timeout, // explicit timeout overrides adapter default + settings.json
+                        &session_manager,
+                        &trace_patterns,
+                        req_clone.watches.as_ref(),
+                        &connection_id_owned,
+                        &session_id_clone,
+                        progress_clone,
+                    )
+                    .await
+            };
 
             // Clean up Frida session — test process is dead, release resources.
             // Without this, the output_registry and session state from the old run
             // can interfere with subsequent test runs on the same connection.
             let _ = session_manager.stop_frida(&session_id_clone).await;
+            if let Some(n) = shards {
+                // Shard sessions 1..N have their own Frida state to release
+                for i in 1..n {
+                    let _ = session_manager
+                        .stop_frida(&format!("{}-s{}", session_id_clone, i))
+                        .await;
+                }
+            }
 
             // Record baselines for completed tests
             if let Ok(ref run_result) = run_result {
@@ -2902,6 +3241,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
         let mut ax_count = 0;
         let mut vision_count = 0;
         let mut merged_count = 0;
+        let mut unchanged_count = None;
 
         let needs_tree = matches!(
             req.mode,
@@ -3006,10 +3346,41 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                 merged_count = actual_merged;
             }
 
+            // Record subtree hashes on every tree capture (cheap: one FNV
+            // pass), so the next delta capture has a baseline even if this
+            // one was full. With delta requested, elide subtrees whose hash
+            // matches the previous capture — steady-state loops then pay
+            // only for what actually changed.
+            let mut new_hashes = HashMap::new();
+            crate::ui::tree::collect_subtree_hashes(&final_nodes, &mut new_hashes);
+            let display_nodes = if req.delta.unwrap_or(false) {
+                let prev = self
+                    .ui_subtree_hashes
+                    .read()
+                    .await
+                    .get(&req.session_id)
+                    .cloned();
+                match prev {
+                    Some(prev) => {
+                        let (pruned, elided) =
+                            crate::ui::tree::prune_unchanged(&final_nodes, &prev);
+                        unchanged_count = Some(elided);
+                        pruned
+                    }
+                    None => final_nodes, // first capture: no baseline yet
+                }
+            } else {
+                final_nodes
+            };
+            self.ui_subtree_hashes
+                .write()
+                .await
+                .insert(req.session_id.clone(), new_hashes);
+
             tree_output = Some(if verbose {
-                crate::ui::tree::format_json(&final_nodes)?
+                crate::ui::tree::format_json(&display_nodes)?
             } else {
-                crate::ui::tree::format_compact(&final_nodes)
+                crate::ui::tree::format_compact(&display_nodes)
             });
         }
 
@@ -3071,6 +3442,7 @@ Do NOT pass `framework` unless auto-detection fails. For C++, provide `command`
                     vision_nodes: vision_count,
                     merged_nodes: merged_count,
                     latency_ms,
+                    unchanged_nodes: unchanged_count,
                 }),
             };
             content.push(McpContent::Text {
@@ -3135,6 +3507,7 @@ mod tests {
                 crate::ui::vision::VisionSidecar::new(),
             )),
             notification_senders: Arc::new(RwLock::new(HashMap::new())),
+            ui_subtree_hashes: Arc::new(RwLock::new(HashMap::new())),
         };
 
         (daemon, dir)
@@ -3428,6 +3801,7 @@ mod tests {
                 crate::ui::vision::VisionSidecar::new(),
             )),
             notification_senders: Arc::new(RwLock::new(HashMap::new())),
+            ui_subtree_hashes: Arc::new(RwLock::new(HashMap::new())),
         };
 
         daemon.graceful_shutdown().await;
@@ -101,6 +101,20 @@ pub struct ActiveWatchState {
     pub is_expr: bool,
     pub expr: Option<String>,
     pub no_slide: bool,
+    pub sample_hz: Option<u32>,
+}
+
+/// What `resume_session` restored, for reporting back to the client.
+#[derive(Debug, Clone)]
+pub struct ResumeSummary {
+    pub pid: u32,
+    pub patterns: Vec<String>,
+    pub hooked_functions: u32,
+    pub watches_installed: usize,
+    /// True when the checkpointed address set was replayed directly
+    /// (binary unchanged); false when patterns were re-resolved.
+    pub replayed_from_checkpoint: bool,
+    pub warnings: Vec<String>,
 }
 
 /// Check if a process is alive. Returns true if the process exists,
@@ -313,10 +327,15 @@ pub struct SessionManager {
     frida_spawner: Arc<tokio::sync::RwLock<Option<FridaSpawner>>>,
     /// Child PIDs per session (parent PID is in the Session struct)
     child_pids: Arc<RwLock<HashMap<String, Vec<u32>>>>,
-    /// Cancellation tokens for database writer tasks per session
+    /// Cancellation tokens for database writer tasks per session (one token
+    /// shared by all of a session's writer shards)
     writer_cancel_tokens: Arc<RwLock<HashMap<String, tokio::sync::watch::Sender<bool>>>>,
-    /// JoinHandles for database writer tasks per session (for awaiting completion)
-    writer_handles: Arc<tokio::sync::RwLock<HashMap<String, tokio::task::JoinHandle<()>>>>,
+    /// Per-session writer queue depth gauges, one per shard (events buffered
+    /// but not committed)
+    writer_queue_depths: Arc<RwLock<HashMap<String, Vec<super::event_writer::QueueDepth>>>>,
+    /// JoinHandles for database writer tasks per session, one per shard
+    /// (for awaiting completion)
+    writer_handles: Arc<tokio::sync::RwLock<HashMap<String, Vec<tokio::task::JoinHandle<()>>>>>,
     /// Breakpoints per session
     breakpoints: Arc<RwLock<HashMap<String, HashMap<String, Breakpoint>>>>,
     /// Logpoints per session
@@ -331,11 +350,17 @@ pub struct SessionManager {
     esm_hook_paths: Arc<RwLock<HashMap<String, String>>>,
     /// Runtime capabilities per session (derived at spawn, enriched by agent)
     capabilities: Arc<RwLock<HashMap<String, crate::mcp::RuntimeCapabilities>>>,
+    /// Requested argument serialization depth per session (drives lazy
+    /// query-time serialization; capture itself records raw pointers only)
+    serialization_depths: Arc<RwLock<HashMap<String, u32>>>,
 }
 
 impl SessionManager {
     pub fn new(db_path: &Path) -> Result<Self> {
-        let db = Database::open(db_path)?;
+        // Per-session event databases (under `<dir>/sessions/`) keep
+        // concurrent sessions off each other's WAL file; the shared file
+        // holds only session metadata.
+        let db = Database::open_with_session_dbs(db_path)?;
 
         // Clean up any sessions left as 'running' from a previous daemon instance
         db.cleanup_stale_sessions()?;
@@ -350,6 +375,7 @@ impl SessionManager {
             frida_spawner: Arc::new(tokio::sync::RwLock::new(None)),
             child_pids: Arc::new(RwLock::new(HashMap::new())),
             writer_cancel_tokens: Arc::new(RwLock::new(HashMap::new())),
+            writer_queue_depths: Arc::new(RwLock::new(HashMap::new())),
             writer_handles: Arc::new(tokio::sync::RwLock::new(HashMap::new())),
             breakpoints: Arc::new(RwLock::new(HashMap::new())),
             logpoints: Arc::new(RwLock::new(HashMap::new())),
@@ -358,6 +384,7 @@ impl SessionManager {
             resolvers: Arc::new(RwLock::new(HashMap::new())),
             esm_hook_paths: Arc::new(RwLock::new(HashMap::new())),
             capabilities: Arc::new(RwLock::new(HashMap::new())),
+            serialization_depths: Arc::new(RwLock::new(HashMap::new())),
         })
     }
 
@@ -450,19 +477,36 @@ impl SessionManager {
         Ok(count)
     }
 
-    /// Signal the database writer task to flush and wait for it with a timeout.
+    /// Events buffered by a session's write-behind writers but not yet
+    /// committed, summed across shards. Producers can use this as a
+    /// backpressure signal.
+    pub fn writer_queue_depth(&self, session_id: &str) -> Option<usize> {
+        read_lock(&self.writer_queue_depths)
+            .get(session_id)
+            .map(|depths| {
+                depths
+                    .iter()
+                    .map(|d| d.load(std::sync::atomic::Ordering::Relaxed))
+                    .sum()
+            })
+    }
+
+    /// Signal the database writer tasks to flush and wait for them with a timeout.
     async fn flush_writer(&self, id: &str) {
         if let Some(cancel_tx) = write_lock(&self.writer_cancel_tokens).remove(id) {
             let _ = cancel_tx.send(true);
         }
-        if let Some(handle) = self.writer_handles.write().await.remove(id) {
-            // Timeout prevents hanging if the writer is stuck on a DB operation
-            match tokio::time::timeout(std::time::Duration::from_secs(5), handle).await {
-                Ok(_) => {} // Writer flushed and exited
-                Err(_) => tracing::warn!(
-                    "Timed out waiting for event writer to flush for session {} (5s)",
-                    id
-                ),
+        write_lock(&self.writer_queue_depths).remove(id);
+        if let Some(handles) = self.writer_handles.write().await.remove(id) {
+            for handle in handles {
+                // Timeout prevents hanging if a writer is stuck on a DB operation
+                match tokio::time::timeout(std::time::Duration::from_secs(5), handle).await {
+                    Ok(_) => {} // Writer flushed and exited
+                    Err(_) => tracing::warn!(
+                        "Timed out waiting for event writer to flush for session {} (5s)",
+                        id
+                    ),
+                }
             }
         }
     }
@@ -479,6 +523,7 @@ impl SessionManager {
         write_lock(&self.paused_threads).remove(id);
         write_lock(&self.languages).remove(id);
         write_lock(&self.resolvers).remove(id);
+        write_lock(&self.serialization_depths).remove(id);
         if let Some(path) = write_lock(&self.esm_hook_paths).remove(id) {
             let _ = std::fs::remove_file(&path);
         }
@@ -772,75 +817,74 @@ impl SessionManager {
         }
         let effective_env = esm_env_overlay.as_ref().or(env);
 
-        // Create event channel
-        let (tx, mut rx) = mpsc::channel::<Event>(10000);
+        let (event_shards, pause_tx) = self.start_session_pipelines(session_id).await;
 
-        // Spawn database writer task with automatic event limit enforcement
-        let db = self.db.clone();
-        let event_limits = Arc::clone(&self.event_limits);
-        let (cancel_tx, mut cancel_rx) = tokio::sync::watch::channel(false);
-        write_lock(&self.writer_cancel_tokens).insert(session_id.to_string(), cancel_tx);
-
-        let writer_handle = tokio::spawn(async move {
-            let mut batch = Vec::with_capacity(100);
-            let mut cached_limit = crate::config::StrobeSettings::default().events_max_per_session;
-            let mut batches_since_refresh = 0u32;
-
-            let flush_batch = |batch: &mut Vec<Event>,
-                               cached_limit: &mut usize,
-                               batches_since_refresh: &mut u32| {
-                if batch.is_empty() {
-                    return;
-                }
-                if *batches_since_refresh >= 10 {
-                    let session_id = &batch[0].session_id;
-                    *cached_limit = read_lock(&event_limits)
-                        .get(session_id)
-                        .copied()
-                        .unwrap_or(crate::config::StrobeSettings::default().events_max_per_session);
-                    *batches_since_refresh = 0;
-                }
-                *batches_since_refresh += 1;
-                match db.insert_events_with_limit(batch, *cached_limit) {
-                    Ok(stats) => {
-                        if stats.events_deleted > 0 {
-                            tracing::warn!(
-                                "Event limit cleanup: deleted {} old events from {} session(s) to stay within {} event limit",
-                                stats.events_deleted, stats.sessions_cleaned.len(), cached_limit
-                            );
-                        }
-                    }
-                    Err(e) => {
-                        tracing::error!("Failed to insert events: {}", e);
-                    }
-                }
-                batch.clear();
-            };
+        // Ensure FridaSpawner exists (brief write lock for lazy init only)
+        {
+            let mut guard = self.frida_spawner.write().await;
+            guard.get_or_insert_with(FridaSpawner::new);
+        }
+        // Use read lock for the actual spawn — allows concurrent Frida operations
+        let guard = self.frida_spawner.read().await;
+        let spawner = guard.as_ref().unwrap();
+        spawner
+            .spawn(
+                session_id,
+                command,
+                args,
+                cwd,
+                project_root,
+                effective_env,
+                dwarf_handle,
+                image_base,
+                event_shards,
+                defer_resume,
+                Some(pause_tx),
+                language,
+            )
+            .await
+    }
 
-            loop {
-                tokio::select! {
-                    Some(event) = rx.recv() => {
-                        batch.push(event);
-                        if batch.len() >= 100 {
-                            flush_batch(&mut batch, &mut cached_limit, &mut batches_since_refresh);
-                        }
-                    }
-                    _ = tokio::time::sleep(std::time::Duration::from_millis(10)) => {
-                        flush_batch(&mut batch, &mut cached_limit, &mut batches_since_refresh);
-                    }
-                    _ = cancel_rx.changed() => {
-                        flush_batch(&mut batch, &mut cached_limit, &mut batches_since_refresh);
-                        break;
-                    }
-                }
-            }
-        });
+    /// Start a session's event pipelines: per-PID writer shards and the
+    /// breakpoint pause bridge. Shared by `spawn_with_frida` and
+    /// `resume_session`.
+    async fn start_session_pipelines(
+        &self,
+        session_id: &str,
+    ) -> (
+        crate::frida_collector::ShardedEventTx,
+        mpsc::Sender<crate::frida_collector::PauseNotification>,
+    ) {
+        // Per-PID writer shards: one channel + write-behind task per shard,
+        // all draining into the session store. Each process (the target and
+        // every forked child) is assigned a shard by PID in the spawner, so a
+        // fork storm doesn't funnel every child through one queue.
+        let (cancel_tx, cancel_rx) = tokio::sync::watch::channel(false);
+        write_lock(&self.writer_cancel_tokens).insert(session_id.to_string(), cancel_tx);
+        let mut shard_txs = Vec::with_capacity(super::event_writer::WRITER_SHARDS);
+        let mut writer_handles = Vec::with_capacity(super::event_writer::WRITER_SHARDS);
+        let mut queue_depths = Vec::with_capacity(super::event_writer::WRITER_SHARDS);
+        for _ in 0..super::event_writer::WRITER_SHARDS {
+            let (tx, rx) = mpsc::channel::<Event>(10000);
+            let (writer_handle, queue_depth) = super::event_writer::spawn(
+                session_id.to_string(),
+                rx,
+                self.db.clone(),
+                Arc::clone(&self.event_limits),
+                cancel_rx.clone(),
+            );
+            shard_txs.push(tx);
+            writer_handles.push(writer_handle);
+            queue_depths.push(queue_depth);
+        }
+        let event_shards = crate::frida_collector::ShardedEventTx::new(shard_txs);
+        write_lock(&self.writer_queue_depths).insert(session_id.to_string(), queue_depths);
 
-        // Store writer handle so we can await completion during stop
+        // Store writer handles so we can await completion during stop
         self.writer_handles
             .write()
             .await
-            .insert(session_id.to_string(), writer_handle);
+            .insert(session_id.to_string(), writer_handles);
 
         // Create pause notification channel for breakpoint support
         let (pause_tx, mut pause_rx) =
@@ -879,30 +923,20 @@ impl SessionManager {
             }
         });
 
-        // Ensure FridaSpawner exists (brief write lock for lazy init only)
-        {
-            let mut guard = self.frida_spawner.write().await;
-            guard.get_or_insert_with(FridaSpawner::new);
+        (event_shards, pause_tx)
+    }
+
+    /// Eagerly initialize the Frida spawner so the first session skips device
+    /// enumeration and coordinator setup (~100-300ms). Called once at daemon
+    /// start; session creation paths keep their lazy init as a fallback.
+    pub async fn prewarm_frida(&self) {
+        let mut guard = self.frida_spawner.write().await;
+        if guard.is_none() {
+            *guard = Some(FridaSpawner::new());
+            tracing::info!(
+                "Frida coordinator started at daemon startup — device warming in background"
+            );
         }
-        // Use read lock for the actual spawn — allows concurrent Frida operations
-        let guard = self.frida_spawner.read().await;
-        let spawner = guard.as_ref().unwrap();
-        spawner
-            .spawn(
-                session_id,
-                command,
-                args,
-                cwd,
-                project_root,
-                effective_env,
-                dwarf_handle,
-                image_base,
-                tx,
-                defer_resume,
-                Some(pause_tx),
-                language,
-            )
-            .await
     }
 
     /// Resume a process that was spawned with defer_resume=true.
@@ -924,6 +958,13 @@ impl SessionManager {
         remove: Option<&[String]>,
         serialization_depth: Option<u32>,
     ) -> Result<HookResult> {
+        // Remember the requested depth — capture only records raw argument
+        // pointers, so serialization happens lazily at query time (see
+        // serialize_event_arguments).
+        if let Some(depth) = serialization_depth {
+            write_lock(&self.serialization_depths).insert(session_id.to_string(), depth);
+        }
+
         // Get resolver for this session (if available)
         let resolver = {
             let resolvers = read_lock(&self.resolvers);
@@ -942,33 +983,37 @@ impl SessionManager {
             }
         };
 
-        if let Some(patterns) = add {
-            return spawner
+        let result = if let Some(patterns) = add {
+            spawner
                 .add_patterns(
                     session_id,
                     patterns,
                     serialization_depth,
                     resolver.as_ref().map(|v| &**v),
                 )
-                .await;
-        }
-
-        if let Some(patterns) = remove {
+                .await?
+        } else if let Some(patterns) = remove {
             let remaining = spawner
                 .remove_patterns(session_id, patterns, resolver.as_ref().map(|v| &**v))
                 .await?;
-            return Ok(HookResult {
+            HookResult {
                 installed: remaining,
                 matched: 0,
                 warnings: vec![],
+            }
+        } else {
+            return Ok(HookResult {
+                installed: 0,
+                matched: 0,
+                warnings: vec![],
             });
-        }
+        };
+        drop(guard);
 
-        Ok(HookResult {
-            installed: 0,
-            matched: 0,
-            warnings: vec![],
-        })
+        // Hook state changed — refresh the session's resume checkpoint
+        self.checkpoint_session(session_id).await;
+
+        Ok(result)
     }
 
     /// Update Frida watches
@@ -987,6 +1032,283 @@ impl SessionManager {
         spawner.set_watches(session_id, watches, expr_watches).await
     }
 
+    /// Persist the session's tracing setup — resolved hooks, watch recipes,
+    /// event-limit config — so a restarted daemon can resume it (see
+    /// `resume_session`). Best-effort: failures are logged, never surfaced,
+    /// because checkpointing must not break the mutation that triggered it.
+    pub async fn checkpoint_session(&self, session_id: &str) {
+        let session = match self.get_session(session_id) {
+            Ok(Some(s)) => s,
+            _ => return,
+        };
+        let hooks = {
+            let guard = self.frida_spawner.read().await;
+            guard
+                .as_ref()
+                .and_then(|s| s.snapshot_resolved_hooks(session_id))
+                .unwrap_or_default()
+        };
+        let watches = self
+            .get_watches(session_id)
+            .into_iter()
+            .map(|w| crate::db::WatchCheckpoint {
+                label: w.label,
+                address: w.address,
+                size: w.size,
+                type_kind_str: w.type_kind_str,
+                deref_depth: w.deref_depth,
+                deref_offset: w.deref_offset,
+                type_name: w.type_name,
+                on_patterns: w.on_patterns,
+                is_expr: w.is_expr,
+                expr: w.expr,
+                no_slide: w.no_slide,
+                sample_hz: w.sample_hz,
+            })
+            .collect();
+        let (binary_mtime, binary_size) =
+            crate::db::binary_fingerprint(Path::new(&session.binary_path));
+        let checkpoint = crate::db::SessionCheckpoint {
+            patterns: self.get_patterns(session_id),
+            hooks,
+            watches,
+            event_limit: self.get_event_limit(session_id),
+            serialization_depth: read_lock(&self.serialization_depths)
+                .get(session_id)
+                .copied(),
+            binary_mtime,
+            binary_size,
+        };
+        if let Err(e) = self.db.save_session_checkpoint(session_id, &checkpoint) {
+            tracing::warn!("Failed to checkpoint session {}: {}", session_id, e);
+        }
+    }
+
+    /// Re-attach to a still-running target after a daemon restart and replay
+    /// the session's checkpointed tracing setup in one batched install.
+    ///
+    /// Native sessions only: interpreted targets are self-spawned with stdio
+    /// pipes the old daemon owned, which can't be recovered — relaunch those.
+    /// When the binary's mtime/size fingerprint is unchanged the checkpointed
+    /// address set is replayed directly (no DWARF wait); after a rebuild the
+    /// patterns are re-resolved against fresh debug info.
+    pub async fn resume_session(&self, session_id: &str) -> Result<ResumeSummary> {
+        let session = self
+            .get_session(session_id)?
+            .ok_or_else(|| crate::Error::SessionNotFound(session_id.to_string()))?;
+
+        if session.status != SessionStatus::Running {
+            return Err(crate::Error::Frida(format!(
+                "Session {} is not running (status: {}) — resume only re-attaches to a live \
+                 process. Use debug_launch to start a new session.",
+                session_id,
+                session.status.as_str()
+            )));
+        }
+        if !is_process_alive(session.pid) {
+            self.db
+                .update_session_status(session_id, SessionStatus::Stopped)?;
+            return Err(crate::Error::Frida(format!(
+                "Process {} for session {} is gone — marked the session stopped. \
+                 Use debug_launch to start a new one.",
+                session.pid, session_id
+            )));
+        }
+        {
+            let guard = self.frida_spawner.read().await;
+            if guard.as_ref().is_some_and(|s| s.has_session(session_id)) {
+                return Err(crate::Error::Frida(format!(
+                    "Session {} is already attached — nothing to resume.",
+                    session_id
+                )));
+            }
+        }
+
+        let language = detect_language(&session.binary_path, Path::new(&session.project_root));
+        if language != Language::Native {
+            return Err(crate::Error::Frida(
+                "Resume only supports native sessions — interpreted targets are self-spawned \
+                 with stdio pipes the previous daemon owned. Relaunch with debug_launch."
+                    .to_string(),
+            ));
+        }
+
+        let checkpoint = self
+            .db
+            .load_session_checkpoint(session_id)?
+            .unwrap_or_default();
+
+        // Restore in-memory session state from the checkpoint
+        write_lock(&self.languages).insert(session_id.to_string(), language);
+        let caps = crate::capabilities::derive_capabilities(language, &session.binary_path);
+        write_lock(&self.capabilities).insert(session_id.to_string(), caps);
+        write_lock(&self.patterns).insert(session_id.to_string(), checkpoint.patterns.clone());
+        write_lock(&self.hook_counts).insert(session_id.to_string(), 0);
+        let event_limit = if checkpoint.event_limit > 0 {
+            checkpoint.event_limit
+        } else {
+            crate::config::resolve(Some(Path::new(&session.project_root))).events_max_per_session
+        };
+        write_lock(&self.event_limits).insert(session_id.to_string(), event_limit);
+        if let Some(depth) = checkpoint.serialization_depth {
+            write_lock(&self.serialization_depths).insert(session_id.to_string(), depth);
+        }
+        let watch_state: Vec<ActiveWatchState> = checkpoint
+            .watches
+            .iter()
+            .map(|w| ActiveWatchState {
+                label: w.label.clone(),
+                address: w.address,
+                size: w.size,
+                type_kind_str: w.type_kind_str.clone(),
+                deref_depth: w.deref_depth,
+                deref_offset: w.deref_offset,
+                type_name: w.type_name.clone(),
+                on_patterns: w.on_patterns.clone(),
+                is_expr: w.is_expr,
+                expr: w.expr.clone(),
+                no_slide: w.no_slide,
+                sample_hz: w.sample_hz,
+            })
+            .collect();
+        write_lock(&self.watches).insert(session_id.to_string(), watch_state);
+
+        // DWARF handle + resolver as in spawn_with_frida. The background
+        // parse serves later pattern changes and breakpoints; checkpoint
+        // replay itself never waits on it.
+        let image_base =
+            DwarfParser::extract_image_base(Path::new(&session.binary_path)).unwrap_or(0);
+        let dwarf_handle =
+            self.get_or_start_dwarf_parse(&session.binary_path, Some(&session.project_root));
+        {
+            let mut dwarf_clone = dwarf_handle.clone();
+            let resolvers = Arc::clone(&self.resolvers);
+            let sid = session_id.to_string();
+            tokio::spawn(async move {
+                match dwarf_clone.get().await {
+                    Ok(_) => {
+                        let resolver = Arc::new(DwarfResolver::new(dwarf_clone, image_base));
+                        write_lock(&resolvers)
+                            .insert(sid.clone(), resolver as Arc<dyn SymbolResolver>);
+                        tracing::debug!("DwarfResolver instantiated for session {}", sid);
+                    }
+                    Err(e) => {
+                        tracing::warn!("DWARF parse failed for session {}: {}", sid, e);
+                    }
+                }
+            });
+        }
+
+        let (event_shards, pause_tx) = self.start_session_pipelines(session_id).await;
+
+        // Ensure FridaSpawner exists (brief write lock for lazy init only)
+        {
+            let mut guard = self.frida_spawner.write().await;
+            guard.get_or_insert_with(FridaSpawner::new);
+        }
+        let guard = self.frida_spawner.read().await;
+        let spawner = guard.as_ref().unwrap();
+        spawner
+            .reattach(
+                session_id,
+                &session.binary_path,
+                &session.project_root,
+                session.pid,
+                dwarf_handle,
+                image_base,
+                event_shards,
+                Some(pause_tx),
+                language,
+            )
+            .await?;
+
+        // Replay hooks: by address while the binary is unchanged, otherwise
+        // fall back to re-resolving the patterns against fresh DWARF.
+        let mut warnings: Vec<String> = Vec::new();
+        let fingerprint = crate::db::binary_fingerprint(Path::new(&session.binary_path));
+        let binary_unchanged = checkpoint.binary_mtime.is_some()
+            && fingerprint == (checkpoint.binary_mtime, checkpoint.binary_size);
+        let hook_result = if checkpoint.hooks.is_empty() && checkpoint.patterns.is_empty() {
+            HookResult {
+                installed: 0,
+                matched: 0,
+                warnings: vec![],
+            }
+        } else if binary_unchanged {
+            spawner
+                .replay_hooks(
+                    session_id,
+                    &checkpoint.hooks,
+                    checkpoint.serialization_depth,
+                )
+                .await?
+        } else {
+            warnings.push(
+                "Binary changed since the checkpoint was saved — re-resolved trace patterns \
+                 against fresh debug info."
+                    .to_string(),
+            );
+            spawner
+                .add_patterns(
+                    session_id,
+                    &checkpoint.patterns,
+                    checkpoint.serialization_depth,
+                    None,
+                )
+                .await?
+        };
+        warnings.extend(hook_result.warnings);
+        self.set_hook_count(session_id, hook_result.installed);
+
+        // Replay watches in one batch. Expression watches derive is_global
+        // the same way the server does when first installing them.
+        let mut watch_targets: Vec<crate::frida_collector::WatchTarget> = Vec::new();
+        let mut expr_targets: Vec<crate::frida_collector::ExprWatchTarget> = Vec::new();
+        for w in &checkpoint.watches {
+            if w.is_expr {
+                if let Some(expr) = &w.expr {
+                    expr_targets.push(crate::frida_collector::ExprWatchTarget {
+                        label: w.label.clone(),
+                        expr: expr.clone(),
+                        is_global: w.on_patterns.as_ref().map_or(true, |p| p.is_empty()),
+                        on_patterns: w.on_patterns.clone(),
+                    });
+                }
+            } else {
+                watch_targets.push(crate::frida_collector::WatchTarget {
+                    label: w.label.clone(),
+                    address: w.address,
+                    size: w.size,
+                    type_kind_str: w.type_kind_str.clone(),
+                    deref_depth: w.deref_depth,
+                    deref_offset: w.deref_offset,
+                    type_name: w.type_name.clone(),
+                    on_patterns: w.on_patterns.clone(),
+                    no_slide: w.no_slide,
+                    sample_hz: w.sample_hz,
+                });
+            }
+        }
+        let watches_installed = watch_targets.len() + expr_targets.len();
+        if watches_installed > 0 {
+            if let Err(e) = spawner
+                .set_watches(session_id, watch_targets, expr_targets)
+                .await
+            {
+                warnings.push(format!("Watch replay failed: {}", e));
+            }
+        }
+
+        Ok(ResumeSummary {
+            pid: session.pid,
+            patterns: checkpoint.patterns,
+            hooked_functions: hook_result.installed,
+            watches_installed,
+            replayed_from_checkpoint: binary_unchanged,
+            warnings,
+        })
+    }
+
     /// Send a raw read_memory command to the Frida agent and return the response.
     async fn send_read_memory(
         &self,
@@ -1001,6 +1323,108 @@ impl SessionManager {
         spawner.read_memory(session_id, recipes_json).await
     }
 
+    /// Lazily serialize captured argument pointers for events a query actually
+    /// returns. Capture records raw `0x...` pointers only; this asks the agent
+    /// to walk them now and writes the results back so repeat queries are free.
+    /// Arguments whose memory is gone come back as `<stale>`. Silently a no-op
+    /// when no serialization depth was requested or the process has exited —
+    /// raw pointers are still informative on their own.
+    pub async fn serialize_event_arguments(
+        &self,
+        session_id: &str,
+        events: &mut [crate::db::Event],
+    ) -> Result<()> {
+        let depth = match read_lock(&self.serialization_depths).get(session_id) {
+            Some(d) => *d,
+            None => return Ok(()),
+        };
+
+        let session = self
+            .get_session(session_id)?
+            .ok_or_else(|| crate::Error::SessionNotFound(session_id.to_string()))?;
+        if session.status != crate::db::SessionStatus::Running {
+            return Ok(());
+        }
+
+        // Collect unique raw pointers still awaiting serialization
+        let mut pointers: Vec<String> = Vec::new();
+        for event in events.iter() {
+            if event.event_type != crate::db::EventType::FunctionEnter {
+                continue;
+            }
+            if let Some(args) = event.arguments.as_ref().and_then(|a| a.as_array()) {
+                for arg in args {
+                    if let Some(s) = arg.as_str() {
+                        if s.starts_with("0x") && !pointers.iter().any(|p| p == s) {
+                            pointers.push(s.to_string());
+                        }
+                    }
+                }
+            }
+        }
+        if pointers.is_empty() {
+            return Ok(());
+        }
+
+        let msg = serde_json::json!({
+            "type": "serialize_args",
+            "pointers": pointers,
+            "depth": depth,
+        });
+        let response = self.send_read_memory(session_id, msg.to_string()).await?;
+
+        // Map pointer -> serialized value
+        let mut serialized: HashMap<String, String> = HashMap::new();
+        if let Some(results) = response.get("results").and_then(|r| r.as_array()) {
+            for result in results {
+                if let (Some(label), Some(value)) = (
+                    result.get("label").and_then(|l| l.as_str()),
+                    result.get("value").and_then(|v| v.as_str()),
+                ) {
+                    serialized.insert(label.to_string(), value.to_string());
+                }
+            }
+        }
+        if serialized.is_empty() {
+            return Ok(());
+        }
+
+        // Substitute in-memory and persist. Only write back when a value
+        // actually changed — pointers the agent couldn't improve on stay raw,
+        // so a later query (while memory is still live) can retry them.
+        for event in events.iter_mut() {
+            if event.event_type != crate::db::EventType::FunctionEnter {
+                continue;
+            }
+            let Some(args) = event.arguments.as_ref().and_then(|a| a.as_array()) else {
+                continue;
+            };
+            let mut changed = false;
+            let new_args: Vec<serde_json::Value> = args
+                .iter()
+                .map(|arg| {
+                    if let Some(s) = arg.as_str() {
+                        if let Some(value) = serialized.get(s) {
+                            if value != s {
+                                changed = true;
+                                return serde_json::Value::String(value.clone());
+                            }
+                        }
+                    }
+                    arg.clone()
+                })
+                .collect();
+            if changed {
+                let new_args = serde_json::Value::Array(new_args);
+                self.db
+                    .update_event_arguments(session_id, &event.id, &new_args)?;
+                event.arguments = Some(new_args);
+            }
+        }
+
+        Ok(())
+    }
+
     /// Execute a debug_read request end-to-end: validate, resolve DWARF, build recipes,
     /// send to agent, format response. This is the full pipeline used by the MCP tool.
     pub async fn execute_debug_read(&self, args: &serde_json::Value) -> Result<serde_json::Value> {
@@ -1579,8 +2003,11 @@ impl SessionManager {
                     arch,
                 );
                 if !locals.is_empty() {
-                    self.db
-                        .update_event_locals(event_id, &serde_json::Value::Array(locals))?;
+                    self.db.update_event_locals(
+                        session_id,
+                        event_id,
+                        &serde_json::Value::Array(locals),
+                    )?;
                 }
             }
         }
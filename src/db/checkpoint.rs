@@ -0,0 +1,253 @@
+//! Session state checkpoints: resolved hooks, watch recipes and event-limit
+//! config persisted to the shared database so a restarted daemon can re-attach
+//! to a still-running target and replay its tracing setup in one batched
+//! install instead of re-resolving everything against the binary.
+//!
+//! The checkpoint is a single JSON blob per session, rewritten on every hook
+//! or watch mutation. It records the binary's mtime/size fingerprint at save
+//! time: resume replays the stored addresses only while the fingerprint still
+//! matches, and falls back to pattern re-resolution after a rebuild.
+
+use super::Database;
+use crate::frida_collector::ArgPredicate;
+use crate::Result;
+use rusqlite::{params, Connection};
+use serde::{Deserialize, Serialize};
+use std::path::Path;
+
+/// One resolved hook target as last installed, tagged with the pattern that
+/// produced it so replay and later `remove` calls keep their association.
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct HookCheckpoint {
+    pub pattern: String,
+    pub address: u64,
+    pub name: String,
+    pub name_raw: Option<String>,
+    pub source_file: Option<String>,
+    pub line_number: Option<u32>,
+    /// Full-mode hooks capture arguments; light-mode hooks count only.
+    pub full_mode: bool,
+    pub predicate: Option<ArgPredicate>,
+}
+
+/// One watch recipe, mirroring `ActiveWatchState` in a serializable shape.
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct WatchCheckpoint {
+    pub label: String,
+    pub address: u64,
+    pub size: u8,
+    pub type_kind_str: String,
+    pub deref_depth: u8,
+    pub deref_offset: u64,
+    pub type_name: Option<String>,
+    pub on_patterns: Option<Vec<String>>,
+    pub is_expr: bool,
+    pub expr: Option<String>,
+    pub no_slide: bool,
+    pub sample_hz: Option<u32>,
+}
+
+/// Everything needed to rebuild a session's tracing setup after a daemon
+/// restart. Breakpoints and paused-thread state are deliberately excluded:
+/// they reference agent-side state that dies with the old daemon's script.
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize, Default)]
+pub struct SessionCheckpoint {
+    pub patterns: Vec<String>,
+    pub hooks: Vec<HookCheckpoint>,
+    pub watches: Vec<WatchCheckpoint>,
+    pub event_limit: usize,
+    pub serialization_depth: Option<u32>,
+    /// Binary fingerprint at save time (mtime seconds, size bytes). A
+    /// mismatch at resume means the stored addresses are stale.
+    pub binary_mtime: Option<i64>,
+    pub binary_size: Option<u64>,
+}
+
+/// Binary fingerprint for staleness detection: (mtime seconds, size bytes).
+/// `None` components mean the file is unreadable — treated as changed.
+pub fn binary_fingerprint(path: &Path) -> (Option<i64>, Option<u64>) {
+    match std::fs::metadata(path) {
+        Ok(meta) => {
+            let mtime = meta
+                .modified()
+                .ok()
+                .and_then(|t| t.duration_since(std::time::UNIX_EPOCH).ok())
+                .map(|d| d.as_secs() as i64);
+            (mtime, Some(meta.len()))
+        }
+        Err(_) => (None, None),
+    }
+}
+
+/// Create the checkpoint table (idempotent).
+pub(crate) fn initialize(conn: &Connection) -> Result<()> {
+    conn.execute(
+        "CREATE TABLE IF NOT EXISTS session_checkpoints (
+            session_id TEXT PRIMARY KEY,
+            state JSON NOT NULL,
+            saved_at INTEGER NOT NULL
+        )",
+        [],
+    )?;
+    Ok(())
+}
+
+/// Remove a session's checkpoint row (part of session deletion).
+pub(crate) fn delete(conn: &Connection, session_id: &str) -> Result<()> {
+    conn.execute(
+        "DELETE FROM session_checkpoints WHERE session_id = ?",
+        params![session_id],
+    )?;
+    Ok(())
+}
+
+impl Database {
+    /// Persist (or overwrite) a session's checkpoint.
+    pub fn save_session_checkpoint(
+        &self,
+        session_id: &str,
+        checkpoint: &SessionCheckpoint,
+    ) -> Result<()> {
+        let state = serde_json::to_string(checkpoint)?;
+        let conn = self.connection();
+        conn.execute(
+            "INSERT OR REPLACE INTO session_checkpoints (session_id, state, saved_at)
+             VALUES (?, ?, ?)",
+            params![session_id, state, chrono::Utc::now().timestamp()],
+        )?;
+        Ok(())
+    }
+
+    /// Load a session's checkpoint, if one was ever saved.
+    pub fn load_session_checkpoint(&self, session_id: &str) -> Result<Option<SessionCheckpoint>> {
+        let conn = self.connection();
+        let state: Option<String> = match conn.query_row(
+            "SELECT state FROM session_checkpoints WHERE session_id = ?",
+            params![session_id],
+            |row| row.get(0),
+        ) {
+            Ok(s) => Some(s),
+            Err(rusqlite::Error::QueryReturnedNoRows) => None,
+            Err(e) => return Err(e.into()),
+        };
+        match state {
+            Some(s) => Ok(Some(serde_json::from_str(&s)?)),
+            None => Ok(None),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::frida_collector::PredicateOp;
+    use tempfile::tempdir;
+
+    fn sample_checkpoint() -> SessionCheckpoint {
+        SessionCheckpoint {
+            patterns: vec![
+                "Engine::*".to_string(),
+                "processBlock(arg1 != 512)".to_string(),
+            ],
+            hooks: vec![HookCheckpoint {
+                pattern: "processBlock(arg1 != 512)".to_string(),
+                address: 0x1000_3f20,
+                name: "AudioEngine::processBlock".to_string(),
+                name_raw: Some("_ZN11AudioEngine12processBlockEv".to_string()),
+                source_file: Some("src/engine.cpp".to_string()),
+                line_number: Some(42),
+                full_mode: true,
+                predicate: Some(ArgPredicate {
+                    arg_index: 1,
+                    op: PredicateOp::Ne,
+                    value: 512,
+                }),
+            }],
+            watches: vec![WatchCheckpoint {
+                label: "gClock".to_string(),
+                address: 0x2000,
+                size: 8,
+                type_kind_str: "uint".to_string(),
+                deref_depth: 0,
+                deref_offset: 0,
+                type_name: Some("uint64_t".to_string()),
+                on_patterns: None,
+                is_expr: false,
+                expr: None,
+                no_slide: false,
+                sample_hz: Some(100),
+            }],
+            event_limit: 200_000,
+            serialization_depth: Some(3),
+            binary_mtime: Some(1_700_000_000),
+            binary_size: Some(4096),
+        }
+    }
+
+    #[test]
+    fn test_checkpoint_roundtrip() {
+        let dir = tempdir().unwrap();
+        let db = Database::open(&dir.path().join("test.db")).unwrap();
+        db.create_session("s1", "/bin/test", "/home", 1234).unwrap();
+
+        let checkpoint = sample_checkpoint();
+        db.save_session_checkpoint("s1", &checkpoint).unwrap();
+
+        let loaded = db.load_session_checkpoint("s1").unwrap().unwrap();
+        assert_eq!(loaded, checkpoint);
+    }
+
+    #[test]
+    fn test_checkpoint_overwrite_keeps_latest() {
+        let dir = tempdir().unwrap();
+        let db = Database::open(&dir.path().join("test.db")).unwrap();
+        db.create_session("s1", "/bin/test", "/home", 1234).unwrap();
+
+        db.save_session_checkpoint("s1", &sample_checkpoint())
+            .unwrap();
+        let mut updated = sample_checkpoint();
+        updated.patterns.push("Mixer::*".to_string());
+        updated.event_limit = 500_000;
+        db.save_session_checkpoint("s1", &updated).unwrap();
+
+        let loaded = db.load_session_checkpoint("s1").unwrap().unwrap();
+        assert_eq!(loaded.patterns.len(), 3);
+        assert_eq!(loaded.event_limit, 500_000);
+    }
+
+    #[test]
+    fn test_load_missing_checkpoint_returns_none() {
+        let dir = tempdir().unwrap();
+        let db = Database::open(&dir.path().join("test.db")).unwrap();
+        assert!(db.load_session_checkpoint("nope").unwrap().is_none());
+    }
+
+    #[test]
+    fn test_delete_session_removes_checkpoint() {
+        let dir = tempdir().unwrap();
+        let db = Database::open(&dir.path().join("test.db")).unwrap();
+        db.create_session("s1", "/bin/test", "/home", 1234).unwrap();
+        db.save_session_checkpoint("s1", &sample_checkpoint())
+            .unwrap();
+
+        db.delete_session("s1").unwrap();
+        assert!(db.load_session_checkpoint("s1").unwrap().is_none());
+    }
+
+    #[test]
+    fn test_binary_fingerprint_tracks_content_changes() {
+        let dir = tempdir().unwrap();
+        let path = dir.path().join("bin");
+        std::fs::write(&path, b"v1").unwrap();
+        let (mtime, size) = binary_fingerprint(&path);
+        assert!(mtime.is_some());
+        assert_eq!(size, Some(2));
+
+        std::fs::write(&path, b"rebuilt").unwrap();
+        let (_, size2) = binary_fingerprint(&path);
+        assert_eq!(size2, Some(7));
+
+        let (m, s) = binary_fingerprint(Path::new("/nonexistent/bin"));
+        assert!(m.is_none() && s.is_none());
+    }
+}
@@ -15,6 +15,9 @@ pub enum EventType {
     Pause,
     Logpoint,
     ConditionError,
+    /// Periodic statistics for a function degraded to aggregation mode
+    /// (call count, min/max/mean duration, latency histogram in `arguments`)
+    AggregateSummary,
 }
 
 impl EventType {
@@ -29,6 +32,7 @@ impl EventType {
             Self::Pause => "pause",
             Self::Logpoint => "logpoint",
             Self::ConditionError => "condition_error",
+            Self::AggregateSummary => "aggregate_summary",
         }
     }
 
@@ -43,6 +47,7 @@ impl EventType {
             "pause" => Some(Self::Pause),
             "logpoint" => Some(Self::Logpoint),
             "condition_error" => Some(Self::ConditionError),
+            "aggregate_summary" => Some(Self::AggregateSummary),
             _ => None,
         }
     }
@@ -172,6 +177,10 @@ pub struct EventQuery {
     pub offset: u32,
     /// Cursor: return only events with rowid > after_rowid
     pub after_rowid: Option<i64>,
+    /// Keyset cursor: return only events with rowid < before_rowid.
+    /// Pages newest→oldest at constant cost, unlike OFFSET which scans and
+    /// discards every skipped row.
+    pub before_rowid: Option<i64>,
 }
 
 impl Default for EventQuery {
@@ -192,6 +201,7 @@ impl Default for EventQuery {
             limit: 50,
             offset: 0,
             after_rowid: None,
+            before_rowid: None,
         }
     }
 }
@@ -239,12 +249,38 @@ impl EventQuery {
         self
     }
 
+    pub fn before_rowid(mut self, n: i64) -> Self {
+        self.before_rowid = Some(n);
+        self
+    }
+
     pub fn thread_name_contains(mut self, s: &str) -> Self {
         self.thread_name_contains = Some(s.to_string());
         self
     }
 }
 
+/// FROM source for a query: `events_all` normally, or a pruned union of only
+/// the tables whose timestamp bounds overlap the query's window. Slicing a
+/// long session by time is the common post-mortem workflow, and without
+/// pruning every slice pays for the whole timeline.
+fn timestamp_source(
+    conn: &rusqlite::Connection,
+    session_id: &str,
+    query: &EventQuery,
+) -> Result<String> {
+    if query.timestamp_from_ns.is_some() || query.timestamp_to_ns.is_some() {
+        super::segments::pruned_union_sql(
+            conn,
+            session_id,
+            query.timestamp_from_ns,
+            query.timestamp_to_ns,
+        )
+    } else {
+        Ok("events_all".to_string())
+    }
+}
+
 fn escape_like_pattern(s: &str) -> String {
     s.chars()
         .filter(|c| *c != '\0')
@@ -254,22 +290,25 @@ fn escape_like_pattern(s: &str) -> String {
         .replace('_', "\\_")
 }
 
-const INSERT_EVENT_SQL: &str =
-    "INSERT INTO events (id, session_id, timestamp_ns, thread_id, thread_name, parent_event_id,
-     event_type, function_name, function_name_raw, source_file, line_number,
-     arguments, return_value, duration_ns, text, sampled, watch_values, pid,
-     signal, fault_address, registers, backtrace, locals, breakpoint_id, logpoint_message,
-     exception_type, exception_message, throw_backtrace)
-     VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
-
-/// Insert a single event row using a connection or transaction.
+/// Insert a single event row into `table` with an explicit rowid from the
+/// global sequence (see `segments::allocate_rowids`), so rowids stay unique
+/// and monotonic across the base table and all segment tables.
 fn insert_event_row(
     conn: &rusqlite::Connection,
+    table: &str,
+    rowid: i64,
     event: &Event,
 ) -> std::result::Result<(), rusqlite::Error> {
+    let sql = format!(
+        "INSERT INTO {} (rowid, {}) VALUES (?{})",
+        table,
+        super::segments::EVENT_COLUMNS,
+        ", ?".repeat(28)
+    );
     conn.execute(
-        INSERT_EVENT_SQL,
+        &sql,
         params![
+            rowid,
             &event.id,
             &event.session_id,
             event.timestamp_ns,
@@ -303,6 +342,68 @@ fn insert_event_row(
     Ok(())
 }
 
+/// Segment-table variant of `insert_event_row`: the function and file strings
+/// are replaced by dictionary ids (see `intern`), so a row never repeats a
+/// signature that averages 300+ bytes in template-heavy C++ traces.
+fn insert_segment_event_row(
+    conn: &rusqlite::Connection,
+    table: &str,
+    rowid: i64,
+    event: &Event,
+    cache: &mut super::intern::InternCache,
+) -> Result<()> {
+    let function_name_id = cache.function_name(conn, &event.function_name)?;
+    let function_name_raw_id = match event.function_name_raw.as_deref() {
+        Some(name) => Some(cache.raw_name(conn, name)?),
+        None => None,
+    };
+    let source_file_id = match event.source_file.as_deref() {
+        Some(path) => Some(cache.source_file(conn, path)?),
+        None => None,
+    };
+    let sql = format!(
+        "INSERT INTO {} (rowid, {}) VALUES (?{})",
+        table,
+        super::segments::SEGMENT_INSERT_COLUMNS,
+        ", ?".repeat(28)
+    );
+    conn.execute(
+        &sql,
+        params![
+            rowid,
+            &event.id,
+            &event.session_id,
+            event.timestamp_ns,
+            event.thread_id,
+            &event.thread_name,
+            &event.parent_event_id,
+            event.event_type.as_str(),
+            function_name_id,
+            function_name_raw_id,
+            source_file_id,
+            event.line_number,
+            event.arguments.as_ref().map(|v| v.to_string()),
+            event.return_value.as_ref().map(|v| v.to_string()),
+            event.duration_ns,
+            &event.text,
+            event.sampled,
+            event.watch_values.as_ref().map(|v| v.to_string()),
+            event.pid.map(|p| p as i64),
+            &event.signal,
+            &event.fault_address,
+            event.registers.as_ref().map(|v| v.to_string()),
+            event.backtrace.as_ref().map(|v| v.to_string()),
+            event.locals.as_ref().map(|v| v.to_string()),
+            &event.breakpoint_id,
+            &event.logpoint_message,
+            &event.exception_type,
+            &event.exception_message,
+            event.throw_backtrace.as_ref().map(|v| v.to_string()),
+        ],
+    )?;
+    Ok(())
+}
+
 /// Read a JSON column that may be stored as Text, Integer, or Real.
 fn read_json_flexible(
     row: &rusqlite::Row,
@@ -366,18 +467,83 @@ fn event_from_row(row: &rusqlite::Row) -> rusqlite::Result<Event> {
     })
 }
 
+/// Whether an event is diverted to the per-session output ring instead of
+/// the event tables (see `output_ring`). Only the high-volume stdout/stderr
+/// stream goes to the ring; crash, pause and logpoint events stay in SQLite.
+fn is_ring_output(event: &Event) -> bool {
+    matches!(event.event_type, EventType::Stdout | EventType::Stderr)
+}
+
+/// Split a batch by session, preserving arrival order within each group.
+fn group_by_session(events: &[Event]) -> std::collections::HashMap<&str, Vec<&Event>> {
+    let mut groups: std::collections::HashMap<&str, Vec<&Event>> = std::collections::HashMap::new();
+    for event in events {
+        groups
+            .entry(event.session_id.as_str())
+            .or_default()
+            .push(event);
+    }
+    groups
+}
+
 impl Database {
     pub fn insert_event(&self, event: &Event) -> Result<()> {
+        if let Some(db) = self.events_db(&event.session_id)? {
+            return db.insert_event(event);
+        }
         let conn = self.connection();
-        insert_event_row(&conn, event)?;
+        // FTS indexing runs before interning (see `fts::index_events`).
+        if self.fts_enabled && !is_ring_output(event) {
+            super::fts::index_events(&conn, std::slice::from_ref(event))?;
+        }
+        let rowid = super::segments::allocate_rowids(&conn, 1)?;
+        if is_ring_output(event) {
+            let ring = self.output_ring(&conn, &event.session_id)?;
+            ring.lock().unwrap().append(&conn, event, rowid)?;
+        } else if super::segments::is_evictable(&event.event_type) {
+            let table = super::segments::segment_table(super::segments::active_segment(&conn)?);
+            let mut cache = super::intern::InternCache::new();
+            insert_segment_event_row(&conn, &table, rowid, event, &mut cache)?;
+        } else {
+            insert_event_row(&conn, "events", rowid, event)?;
+        }
         Ok(())
     }
 
     pub fn insert_events_batch(&self, events: &[Event]) -> Result<()> {
+        if self.sessions_dir.is_some() {
+            for (session_id, group) in group_by_session(events) {
+                let db = self
+                    .events_db(session_id)?
+                    .expect("per-session storage is enabled");
+                db.insert_events_batch_local(&group)?;
+            }
+            return Ok(());
+        }
+        let refs: Vec<&Event> = events.iter().collect();
+        self.insert_events_batch_local(&refs)
+    }
+
+    fn insert_events_batch_local(&self, events: &[&Event]) -> Result<()> {
         let mut conn = self.connection();
         let tx = conn.transaction()?;
-        for event in events {
-            insert_event_row(&tx, event)?;
+        // FTS indexing runs before interning (see `fts::index_events`).
+        if self.fts_enabled {
+            super::fts::index_events(&tx, events.iter().copied().filter(|&e| !is_ring_output(e)))?;
+        }
+        let mut rowid = super::segments::allocate_rowids(&tx, events.len())?;
+        let active_table = super::segments::segment_table(super::segments::active_segment(&tx)?);
+        let mut cache = super::intern::InternCache::new();
+        for &event in events {
+            if is_ring_output(event) {
+                let ring = self.output_ring(&tx, &event.session_id)?;
+                ring.lock().unwrap().append(&tx, event, rowid)?;
+            } else if super::segments::is_evictable(&event.event_type) {
+                insert_segment_event_row(&tx, &active_table, rowid, event, &mut cache)?;
+            } else {
+                insert_event_row(&tx, "events", rowid, event)?;
+            }
+            rowid += 1;
         }
         tx.commit()?;
         Ok(())
@@ -387,16 +553,23 @@ impl Database {
     where
         F: FnOnce(EventQuery) -> EventQuery,
     {
+        if let Some(db) = self.existing_events_db(session_id)? {
+            return db.query_events(session_id, build_query);
+        }
         let query = build_query(EventQuery::default());
         let conn = self.connection();
 
-        let mut sql = String::from(
+        // Time-window queries read from a pruned union that drops segments
+        // entirely outside the window, instead of the full events_all view.
+        let source = timestamp_source(&conn, session_id, &query)?;
+        let mut sql = format!(
             "SELECT rowid, id, session_id, timestamp_ns, thread_id, thread_name, parent_event_id,
              event_type, function_name, function_name_raw, source_file, line_number,
              arguments, return_value, duration_ns, text, sampled, watch_values, pid,
              signal, fault_address, registers, backtrace, locals, breakpoint_id, logpoint_message,
              exception_type, exception_message, throw_backtrace
-             FROM events WHERE session_id = ?",
+             FROM {} WHERE session_id = ?",
+            source
         );
 
         let mut params_vec: Vec<Box<dyn rusqlite::ToSql>> = vec![Box::new(session_id.to_string())];
@@ -416,13 +589,31 @@ impl Database {
         }
 
         if let Some(ref f) = query.function_contains {
-            sql.push_str(" AND event_type IN ('function_enter', 'function_exit') AND function_name LIKE ? ESCAPE '\\'");
-            params_vec.push(Box::new(format!("%{}%", escape_like_pattern(f))));
+            if self.fts_enabled && super::fts::usable_pattern(f) {
+                // Resolve the substring against the small name dictionary via
+                // the trigram index, then hit the per-name event indexes.
+                sql.push_str(
+                    " AND event_type IN ('function_enter', 'function_exit') AND function_name IN \
+                     (SELECT name FROM event_function_names_fts WHERE event_function_names_fts MATCH ?)",
+                );
+                params_vec.push(Box::new(super::fts::match_query(f)));
+            } else {
+                sql.push_str(" AND event_type IN ('function_enter', 'function_exit') AND function_name LIKE ? ESCAPE '\\'");
+                params_vec.push(Box::new(format!("%{}%", escape_like_pattern(f))));
+            }
         }
 
         if let Some(ref f) = query.source_file_contains {
-            sql.push_str(" AND source_file LIKE ? ESCAPE '\\'");
-            params_vec.push(Box::new(format!("%{}%", escape_like_pattern(f))));
+            if self.fts_enabled && super::fts::usable_pattern(f) {
+                sql.push_str(
+                    " AND source_file IN \
+                     (SELECT path FROM event_source_files_fts WHERE event_source_files_fts MATCH ?)",
+                );
+                params_vec.push(Box::new(super::fts::match_query(f)));
+            } else {
+                sql.push_str(" AND source_file LIKE ? ESCAPE '\\'");
+                params_vec.push(Box::new(format!("%{}%", escape_like_pattern(f))));
+            }
         }
 
         if let Some(is_null) = query.return_value_is_null {
@@ -466,40 +657,87 @@ impl Database {
             params_vec.push(Box::new(after));
         }
 
+        if let Some(before) = query.before_rowid {
+            sql.push_str(" AND rowid < ?");
+            params_vec.push(Box::new(before));
+        }
+
         sql.push_str(" ORDER BY timestamp_ns DESC");
-        sql.push_str(" LIMIT ? OFFSET ?");
-        params_vec.push(Box::new(query.limit as i64));
-        params_vec.push(Box::new(query.offset as i64));
+        // Fetch limit+offset rows and apply the offset after merging ring
+        // output below — an SQL OFFSET would skip table rows only. The
+        // cursor paths keep offset at 0 and never pay for the extra rows.
+        let fetch = query.limit as usize + query.offset as usize;
+        sql.push_str(" LIMIT ?");
+        params_vec.push(Box::new(fetch as i64));
 
         let params_refs: Vec<&dyn rusqlite::ToSql> =
             params_vec.iter().map(|p| p.as_ref()).collect();
 
         let mut stmt = conn.prepare(&sql)?;
-        let events = stmt.query_map(params_refs.as_slice(), event_from_row)?;
-
-        events
-            .collect::<std::result::Result<Vec<_>, _>>()
-            .map_err(Into::into)
+        let mut events = stmt
+            .query_map(params_refs.as_slice(), event_from_row)?
+            .collect::<std::result::Result<Vec<_>, _>>()?;
+
+        // Merge stdout/stderr from the session's output ring (when the
+        // filters can match output at all) under the same ordering.
+        if super::output_ring::applies_to(&query) {
+            if let Some(ring) = self.existing_output_ring(&conn, session_id)? {
+                let ring_events = ring.lock().unwrap().query(&conn, &query, fetch)?;
+                if !ring_events.is_empty() {
+                    events.extend(ring_events);
+                    events.sort_by(|a, b| b.timestamp_ns.cmp(&a.timestamp_ns));
+                }
+            }
+        }
+        if query.offset > 0 {
+            events.drain(..(query.offset as usize).min(events.len()));
+        }
+        events.truncate(query.limit as usize);
+        Ok(events)
     }
 
     pub fn get_latest_timestamp(&self, session_id: &str) -> Result<i64> {
+        if let Some(db) = self.existing_events_db(session_id)? {
+            return db.get_latest_timestamp(session_id);
+        }
         let conn = self.connection();
-        let ts: i64 = conn.query_row(
-            "SELECT COALESCE(MAX(timestamp_ns), 0) FROM events WHERE session_id = ?",
-            params![session_id],
-            |row| row.get(0),
-        )?;
-        Ok(ts)
+        // MAX over the events_all view scans every row: SQLite's min/max index
+        // optimization doesn't survive view flattening. Probing each physical
+        // table and combining here keeps this O(log n) per table.
+        let mut latest = 0i64;
+        let mut tables = vec!["events".to_string()];
+        tables.extend(
+            super::segments::live_segments(&conn)?
+                .into_iter()
+                .map(super::segments::segment_table),
+        );
+        for table in tables {
+            if let Some((_, max_ts)) =
+                super::segments::table_time_bounds(&conn, &table, session_id)?
+            {
+                latest = latest.max(max_ts);
+            }
+        }
+        // Output lives in the ring, indexed by granule timestamp bounds.
+        if let Some(ts) = super::output_ring::latest_ts(&conn, session_id)? {
+            latest = latest.max(ts);
+        }
+        Ok(latest)
     }
 
     pub fn count_session_events(&self, session_id: &str) -> Result<u64> {
+        if let Some(db) = self.existing_events_db(session_id)? {
+            return db.count_session_events(session_id);
+        }
         let conn = self.connection();
         let count: i64 = conn.query_row(
-            "SELECT COUNT(*) FROM events WHERE session_id = ?",
+            "SELECT COUNT(*) FROM events_all WHERE session_id = ?",
             params![session_id],
             |row| row.get(0),
         )?;
-        Ok(count as u64)
+        // Retained ring output counts toward the session's event total.
+        let ring_count = super::output_ring::record_count(&conn, session_id)?;
+        Ok(count as u64 + ring_count)
     }
 
     /// Count events matching the same filters as query_events (without limit/offset).
@@ -507,10 +745,14 @@ impl Database {
     where
         F: FnOnce(EventQuery) -> EventQuery,
     {
+        if let Some(db) = self.existing_events_db(session_id)? {
+            return db.count_filtered_events(session_id, build_query);
+        }
         let query = build_query(EventQuery::default());
         let conn = self.connection();
 
-        let mut sql = String::from("SELECT COUNT(*) FROM events WHERE session_id = ?");
+        let source = timestamp_source(&conn, session_id, &query)?;
+        let mut sql = format!("SELECT COUNT(*) FROM {} WHERE session_id = ?", source);
         let mut params_vec: Vec<Box<dyn rusqlite::ToSql>> = vec![Box::new(session_id.to_string())];
 
         if query.text_events_only {
@@ -526,12 +768,28 @@ impl Database {
             params_vec.push(Box::new(f.clone()));
         }
         if let Some(ref f) = query.function_contains {
-            sql.push_str(" AND event_type IN ('function_enter', 'function_exit') AND function_name LIKE ? ESCAPE '\\'");
-            params_vec.push(Box::new(format!("%{}%", escape_like_pattern(f))));
+            if self.fts_enabled && super::fts::usable_pattern(f) {
+                sql.push_str(
+                    " AND event_type IN ('function_enter', 'function_exit') AND function_name IN \
+                     (SELECT name FROM event_function_names_fts WHERE event_function_names_fts MATCH ?)",
+                );
+                params_vec.push(Box::new(super::fts::match_query(f)));
+            } else {
+                sql.push_str(" AND event_type IN ('function_enter', 'function_exit') AND function_name LIKE ? ESCAPE '\\'");
+                params_vec.push(Box::new(format!("%{}%", escape_like_pattern(f))));
+            }
         }
         if let Some(ref f) = query.source_file_contains {
-            sql.push_str(" AND source_file LIKE ? ESCAPE '\\'");
-            params_vec.push(Box::new(format!("%{}%", escape_like_pattern(f))));
+            if self.fts_enabled && super::fts::usable_pattern(f) {
+                sql.push_str(
+                    " AND source_file IN \
+                     (SELECT path FROM event_source_files_fts WHERE event_source_files_fts MATCH ?)",
+                );
+                params_vec.push(Box::new(super::fts::match_query(f)));
+            } else {
+                sql.push_str(" AND source_file LIKE ? ESCAPE '\\'");
+                params_vec.push(Box::new(format!("%{}%", escape_like_pattern(f))));
+            }
         }
         if let Some(is_null) = query.return_value_is_null {
             if is_null {
@@ -570,29 +828,67 @@ impl Database {
             params_vec.push(Box::new(after));
         }
 
+        if let Some(before) = query.before_rowid {
+            sql.push_str(" AND rowid < ?");
+            params_vec.push(Box::new(before));
+        }
+
         let params_refs: Vec<&dyn rusqlite::ToSql> =
             params_vec.iter().map(|p| p.as_ref()).collect();
         let count: i64 = conn.query_row(&sql, params_refs.as_slice(), |row| row.get(0))?;
-        Ok(count as u64)
+        let mut count = count as u64;
+        if super::output_ring::applies_to(&query) {
+            if let Some(ring) = self.existing_output_ring(&conn, session_id)? {
+                count += ring.lock().unwrap().count(&conn, &query)?;
+            }
+        }
+        Ok(count)
     }
 
     /// Delete oldest events for a session, keeping only the most recent N.
     /// Returns the number of events deleted.
     pub fn cleanup_old_events(&self, session_id: &str, keep_count: usize) -> Result<u64> {
-        let conn = self.connection();
+        if let Some(db) = self.existing_events_db(session_id)? {
+            return db.cleanup_old_events(session_id, keep_count);
+        }
+        let mut conn = self.connection();
+        let tx = conn.transaction()?;
 
-        let deleted = conn.execute(
-            "DELETE FROM events
-             WHERE session_id = ?
-             AND id NOT IN (
-                 SELECT id FROM events
-                 WHERE session_id = ?
-                 ORDER BY timestamp_ns DESC
-                 LIMIT ?
-             )",
-            params![session_id, session_id, keep_count as i64],
+        let total: i64 = tx.query_row(
+            "SELECT COUNT(*) FROM events_all WHERE session_id = ?",
+            params![session_id],
+            |row| row.get(0),
         )?;
+        let to_delete = total - keep_count as i64;
+        if to_delete <= 0 {
+            return Ok(0);
+        }
 
+        // Materialize the victim ids once (re-evaluating the subquery per
+        // table would shift the window as rows disappear), then delete them
+        // from whichever table each lives in.
+        let ids: Vec<String> = {
+            let mut stmt = tx.prepare(
+                "SELECT id FROM events_all WHERE session_id = ?
+                 ORDER BY timestamp_ns ASC LIMIT ?",
+            )?;
+            let ids = stmt
+                .query_map(params![session_id, to_delete], |row| row.get(0))?
+                .collect::<std::result::Result<Vec<_>, _>>()?;
+            ids
+        };
+
+        let mut deleted = super::segments::delete_ids(&tx, "events", session_id, &ids)?;
+        for seg_id in super::segments::live_segments(&tx)? {
+            deleted += super::segments::delete_ids(
+                &tx,
+                &super::segments::segment_table(seg_id),
+                session_id,
+                &ids,
+            )?;
+        }
+
+        tx.commit()?;
         Ok(deleted as u64)
     }
 
@@ -612,6 +908,32 @@ impl Database {
             return Ok(EventInsertStats::default());
         }
 
+        // Per-session storage: split the batch so each session's own database
+        // enforces its limit — concurrent sessions commit to separate WAL
+        // files instead of serializing on one.
+        if self.sessions_dir.is_some() {
+            let mut stats = EventInsertStats::default();
+            for (session_id, group) in group_by_session(events) {
+                let db = self
+                    .events_db(session_id)?
+                    .expect("per-session storage is enabled");
+                let s = db.insert_events_with_limit_local(&group, max_events_per_session)?;
+                stats.events_inserted += s.events_inserted;
+                stats.events_deleted += s.events_deleted;
+                stats.sessions_cleaned.extend(s.sessions_cleaned);
+            }
+            return Ok(stats);
+        }
+
+        let refs: Vec<&Event> = events.iter().collect();
+        self.insert_events_with_limit_local(&refs, max_events_per_session)
+    }
+
+    fn insert_events_with_limit_local(
+        &self,
+        events: &[&Event],
+        max_events_per_session: usize,
+    ) -> Result<EventInsertStats> {
         let mut conn = self.connection();
         let tx = conn.transaction()?;
 
@@ -623,7 +945,7 @@ impl Database {
         for event in events {
             if !session_counts.contains_key(&event.session_id) {
                 let count: i64 = tx.query_row(
-                    "SELECT COUNT(*) FROM events WHERE session_id = ?",
+                    "SELECT COUNT(*) FROM events_all WHERE session_id = ?",
                     params![&event.session_id],
                     |row| row.get(0),
                 )?;
@@ -634,7 +956,7 @@ impl Database {
         // Group events by session for efficient cleanup
         let mut events_by_session: std::collections::HashMap<String, Vec<&Event>> =
             std::collections::HashMap::new();
-        for event in events {
+        for &event in events {
             events_by_session
                 .entry(event.session_id.clone())
                 .or_default()
@@ -646,15 +968,31 @@ impl Database {
         // results and error messages survive even under heavy tracing.
         const EVICTABLE_TYPES: &str = "'function_enter','function_exit','variable_snapshot'";
 
+        // FTS indexing runs before interning (see `fts::index_events`).
+        if self.fts_enabled {
+            super::fts::index_events(&tx, events.iter().copied().filter(|&e| !is_ring_output(e)))?;
+        }
+
+        let mut rowid = super::segments::allocate_rowids(&tx, events.len())?;
+        // Rotation only happens at the end of this call and eviction never
+        // drops the active segment, so the insert target is stable throughout.
+        let active_table = super::segments::segment_table(super::segments::active_segment(&tx)?);
+        let mut cache = super::intern::InternCache::new();
+
         // For each session, cleanup if needed, then insert
         for (session_id, session_events) in events_by_session {
             let current_count = session_counts.get(&session_id).copied().unwrap_or(0);
-            let new_count = current_count + session_events.len();
+            // Ring-bound output never lands in the event tables, so it must
+            // not trigger eviction of the trace events that do.
+            let table_bound = session_events.iter().filter(|e| !is_ring_output(e)).count();
+            let new_count = current_count + table_bound;
 
             if new_count > max_events_per_session {
-                let to_delete = new_count - max_events_per_session;
+                let mut remaining = new_count - max_events_per_session;
+                let deleted_before = stats.events_deleted;
 
-                // Only evict trace events, preserving stdout/stderr/crash/etc.
+                // Legacy trace rows in the base table (pre-segment databases)
+                // are older than anything in a segment, so they go first.
                 let query = format!(
                     "DELETE FROM events
                      WHERE session_id = ?
@@ -668,36 +1006,111 @@ impl Database {
                     EVICTABLE_TYPES
                 );
                 let deleted =
-                    tx.execute(&query, params![&session_id, &session_id, to_delete as i64])?;
-
+                    tx.execute(&query, params![&session_id, &session_id, remaining as i64])?;
                 stats.events_deleted += deleted as u64;
-                if deleted > 0 {
+                remaining -= deleted;
+
+                // Walk segments oldest-first. A segment whose rows all belong
+                // to this session's overage is evicted with a DROP TABLE —
+                // constant time, no per-row WAL churn. Anything else (the
+                // active segment, a partial overage, or a segment shared with
+                // another session) falls back to row deletes.
+                let live = super::segments::live_segments(&tx)?;
+                let active = live.last().copied().unwrap_or(1);
+                for seg_id in live {
+                    if remaining == 0 {
+                        break;
+                    }
+                    let table = super::segments::segment_table(seg_id);
+                    let sess_rows: i64 = tx.query_row(
+                        &format!("SELECT COUNT(*) FROM {} WHERE session_id = ?", table),
+                        params![&session_id],
+                        |row| row.get(0),
+                    )?;
+                    if sess_rows == 0 {
+                        continue;
+                    }
+                    let total_rows = super::segments::segment_row_count(&tx, seg_id)?;
+                    if seg_id != active
+                        && sess_rows == total_rows
+                        && sess_rows as usize <= remaining
+                    {
+                        super::segments::drop_segment(&tx, seg_id)?;
+                        super::segments::rebuild_view(&tx)?;
+                        stats.events_deleted += sess_rows as u64;
+                        remaining -= sess_rows as usize;
+                    } else {
+                        let ids: Vec<String> = {
+                            let mut stmt = tx.prepare(&format!(
+                                "SELECT id FROM {} WHERE session_id = ?
+                                 ORDER BY timestamp_ns ASC LIMIT ?",
+                                table
+                            ))?;
+                            let ids = stmt
+                                .query_map(params![&session_id, remaining as i64], |row| {
+                                    row.get(0)
+                                })?
+                                .collect::<std::result::Result<Vec<_>, _>>()?;
+                            ids
+                        };
+                        let deleted = super::segments::delete_ids(&tx, &table, &session_id, &ids)?;
+                        stats.events_deleted += deleted as u64;
+                        remaining -= deleted;
+                    }
+                }
+
+                if stats.events_deleted > deleted_before {
                     stats.sessions_cleaned.push(session_id.clone());
                 }
             }
 
             for event in session_events {
-                insert_event_row(&tx, event)?;
+                if is_ring_output(event) {
+                    // Output goes to the ring: it never counts against the
+                    // session's FIFO budget and self-evicts by overwrite.
+                    let ring = self.output_ring(&tx, &session_id)?;
+                    ring.lock().unwrap().append(&tx, event, rowid)?;
+                } else if super::segments::is_evictable(&event.event_type) {
+                    insert_segment_event_row(&tx, &active_table, rowid, event, &mut cache)?;
+                } else {
+                    insert_event_row(&tx, "events", rowid, event)?;
+                }
+                rowid += 1;
                 stats.events_inserted += 1;
             }
         }
 
+        // Start a fresh segment once the active one is at capacity, so future
+        // eviction can reclaim whole segments instead of deleting rows.
+        super::segments::rotate_if_full(&tx, self.segment_capacity)?;
+
         tx.commit()?;
         Ok(stats)
     }
 
     /// Get the minimum rowid for events in a session. Used for FIFO drop detection.
     pub fn min_rowid_for_session(&self, session_id: &str) -> Result<Option<i64>> {
+        if let Some(db) = self.existing_events_db(session_id)? {
+            return db.min_rowid_for_session(session_id);
+        }
         let conn = self.connection();
         let result: Option<i64> = conn.query_row(
-            "SELECT MIN(rowid) FROM events WHERE session_id = ?",
+            "SELECT MIN(rowid) FROM events_all WHERE session_id = ?",
             params![session_id],
             |row| row.get(0),
         )?;
         Ok(result)
     }
 
-    pub fn update_event_locals(&self, event_id: &str, locals: &serde_json::Value) -> Result<()> {
+    pub fn update_event_locals(
+        &self,
+        session_id: &str,
+        event_id: &str,
+        locals: &serde_json::Value,
+    ) -> Result<()> {
+        if let Some(db) = self.existing_events_db(session_id)? {
+            return db.update_event_locals(session_id, event_id, locals);
+        }
         let conn = self.connection();
         conn.execute(
             "UPDATE events SET locals = ? WHERE id = ?",
@@ -705,6 +1118,38 @@ impl Database {
         )?;
         Ok(())
     }
+
+    /// Write back lazily-serialized arguments for a queried event. Unlike
+    /// `update_event_locals` (crash events, base table only), function_enter
+    /// rows live in segment tables, so the live segments are probed first.
+    pub fn update_event_arguments(
+        &self,
+        session_id: &str,
+        event_id: &str,
+        arguments: &serde_json::Value,
+    ) -> Result<()> {
+        if let Some(db) = self.existing_events_db(session_id)? {
+            return db.update_event_arguments(session_id, event_id, arguments);
+        }
+        let conn = self.connection();
+        for seg_id in super::segments::live_segments(&conn)? {
+            let changed = conn.execute(
+                &format!(
+                    "UPDATE {} SET arguments = ? WHERE id = ?",
+                    super::segments::segment_table(seg_id)
+                ),
+                params![arguments.to_string(), event_id],
+            )?;
+            if changed > 0 {
+                return Ok(());
+            }
+        }
+        conn.execute(
+            "UPDATE events SET arguments = ? WHERE id = ?",
+            params![arguments.to_string(), event_id],
+        )?;
+        Ok(())
+    }
 }
 
 /// Statistics returned from insert_events_with_limit
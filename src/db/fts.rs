@@ -0,0 +1,154 @@
+//! Trigram full-text index for substring filters.
+//!
+//! `function_contains` and `source_file_contains` compile to `LIKE '%...%'`,
+//! which cannot use an index and full-scans every event row. But the filters
+//! only ever match against function names and source paths, whose distinct
+//! cardinality is thousands where events are hundreds of thousands. So the
+//! substring index covers the *dictionary*, not the events: small side tables
+//! hold each distinct name once, FTS5 trigram tables index them, and the query
+//! rewrites `LIKE '%x%'` into `function_name IN (SELECT name FROM ... MATCH)`,
+//! which resolves the handful of matching names first and then walks the
+//! per-name index on the event tables.
+//!
+//! The dictionary tables themselves are owned by `intern` (segment rows store
+//! ids into them); this module only maintains the trigram mirrors over them.
+//!
+//! FTS5 availability is probed at startup — if the linked SQLite lacks it,
+//! `Database::fts_enabled` stays false and filters fall back to LIKE scans.
+//! Dictionary entries are never removed when events are evicted; a stale name
+//! simply matches zero rows.
+
+use super::event::Event;
+use crate::Result;
+use rusqlite::{params, Connection};
+
+/// Trigram tokenization needs at least three characters; shorter patterns
+/// fall back to LIKE.
+pub(crate) const MIN_FTS_PATTERN_CHARS: usize = 3;
+
+/// Create the FTS mirror tables (the dictionaries they mirror are created by
+/// `intern::initialize`). Returns false (without failing the open) when the
+/// linked SQLite has no FTS5 support.
+pub(crate) fn initialize(conn: &Connection) -> bool {
+    let ddl = "
+        CREATE VIRTUAL TABLE IF NOT EXISTS event_function_names_fts
+            USING fts5(name, tokenize='trigram');
+        CREATE VIRTUAL TABLE IF NOT EXISTS event_source_files_fts
+            USING fts5(path, tokenize='trigram');
+    ";
+    if let Err(e) = conn.execute_batch(ddl) {
+        tracing::debug!(
+            "FTS5 unavailable ({}); substring filters fall back to LIKE scans",
+            e
+        );
+        return false;
+    }
+
+    // Backfill the dictionary from databases created before this index
+    // existed (one-time DISTINCT scan; no-op once populated).
+    if let Err(e) = backfill(conn) {
+        tracing::warn!("Failed to backfill FTS name dictionary: {}", e);
+    }
+    true
+}
+
+fn backfill(conn: &Connection) -> Result<()> {
+    // Emptiness is probed on the FTS mirrors, not the dictionaries: interning
+    // populates the dictionaries on its own, so a build that only now gained
+    // FTS5 has full dictionaries and empty mirrors.
+    let names: i64 =
+        conn.query_row("SELECT COUNT(*) FROM event_function_names_fts", [], |row| {
+            row.get(0)
+        })?;
+    if names == 0 {
+        conn.execute(
+            "INSERT OR IGNORE INTO event_function_names (name)
+             SELECT DISTINCT function_name FROM events_all WHERE function_name != ''",
+            [],
+        )?;
+        conn.execute(
+            "INSERT INTO event_function_names_fts (name)
+             SELECT name FROM event_function_names WHERE name != ''",
+            [],
+        )?;
+    }
+    let paths: i64 = conn.query_row("SELECT COUNT(*) FROM event_source_files_fts", [], |row| {
+        row.get(0)
+    })?;
+    if paths == 0 {
+        conn.execute(
+            "INSERT OR IGNORE INTO event_source_files (path)
+             SELECT DISTINCT source_file FROM events_all
+             WHERE source_file IS NOT NULL AND source_file != ''",
+            [],
+        )?;
+        conn.execute(
+            "INSERT INTO event_source_files_fts (path)
+             SELECT path FROM event_source_files WHERE path != ''",
+            [],
+        )?;
+    }
+    Ok(())
+}
+
+/// Record any new function names / source files from a batch. The OR IGNORE
+/// probe on the dictionary keeps the FTS table duplicate-free; the common
+/// case (name already seen) is a single B-tree probe per distinct name.
+///
+/// Must run before the batch is interned into segment rows: interning probes
+/// the same dictionaries, and only this path mirrors a newly-seen name into
+/// the FTS table.
+pub(crate) fn index_events<'a, I>(conn: &Connection, events: I) -> Result<()>
+where
+    I: IntoIterator<Item = &'a Event>,
+{
+    let mut functions = std::collections::HashSet::new();
+    let mut sources = std::collections::HashSet::new();
+    for event in events {
+        if !event.function_name.is_empty() {
+            functions.insert(event.function_name.as_str());
+        }
+        if let Some(ref path) = event.source_file {
+            if !path.is_empty() {
+                sources.insert(path.as_str());
+            }
+        }
+    }
+
+    for name in functions {
+        let inserted = conn.execute(
+            "INSERT OR IGNORE INTO event_function_names (name) VALUES (?)",
+            params![name],
+        )?;
+        if inserted > 0 {
+            conn.execute(
+                "INSERT INTO event_function_names_fts (name) VALUES (?)",
+                params![name],
+            )?;
+        }
+    }
+    for path in sources {
+        let inserted = conn.execute(
+            "INSERT OR IGNORE INTO event_source_files (path) VALUES (?)",
+            params![path],
+        )?;
+        if inserted > 0 {
+            conn.execute(
+                "INSERT INTO event_source_files_fts (path) VALUES (?)",
+                params![path],
+            )?;
+        }
+    }
+    Ok(())
+}
+
+/// Whether a pattern is long enough for the trigram index.
+pub(crate) fn usable_pattern(pattern: &str) -> bool {
+    pattern.chars().count() >= MIN_FTS_PATTERN_CHARS
+}
+
+/// Quote a raw substring as an FTS5 phrase query (trigram tokenization makes
+/// a quoted phrase behave as a substring match, case-insensitive like LIKE).
+pub(crate) fn match_query(pattern: &str) -> String {
+    format!("\"{}\"", pattern.replace('"', "\"\""))
+}
@@ -0,0 +1,92 @@
+//! String interning for segment event rows.
+//!
+//! Traces of template-heavy C++ store the full demangled signature, the raw
+//! mangled name and the source path on every row — 300+ bytes of text per
+//! event that repeats for every call of the same function, and most of the
+//! database's size and write I/O. Segment tables therefore store 8-byte
+//! dictionary ids instead: each distinct string lives once in a dictionary
+//! table, rows reference its rowid, and the `events_all` view joins the
+//! strings back (see `segments::rebuild_view`) so readers are unchanged. A
+//! `function_name = ?` filter resolves the name once against the dictionary's
+//! primary key and then compares integers on the segment's id index.
+//!
+//! The function-name and source-file dictionaries are the same tables the
+//! trigram substring index is built over (see `fts`); this module creates and
+//! populates them, `fts` only maintains the FTS5 mirrors. Like the FTS
+//! entries, dictionary rows are never removed when events are evicted — a
+//! stale string costs one row and joins to nothing.
+
+use crate::Result;
+use rusqlite::{params, Connection};
+use std::collections::HashMap;
+
+/// Create the dictionary tables. Runs before `fts::initialize` and before any
+/// view rebuild, so the tables exist even on builds without FTS5.
+pub(crate) fn initialize(conn: &Connection) -> Result<()> {
+    conn.execute_batch(
+        "CREATE TABLE IF NOT EXISTS event_function_names (name TEXT PRIMARY KEY);
+         CREATE TABLE IF NOT EXISTS event_source_files (path TEXT PRIMARY KEY);
+         CREATE TABLE IF NOT EXISTS event_raw_names (name TEXT PRIMARY KEY);",
+    )?;
+    Ok(())
+}
+
+/// Dictionary id for `value` in `table`, inserting it on first sight.
+fn intern(conn: &Connection, table: &str, column: &str, value: &str) -> Result<i64> {
+    conn.execute(
+        &format!("INSERT OR IGNORE INTO {} ({}) VALUES (?)", table, column),
+        params![value],
+    )?;
+    let id = conn.query_row(
+        &format!("SELECT rowid FROM {} WHERE {} = ?", table, column),
+        params![value],
+        |row| row.get(0),
+    )?;
+    Ok(id)
+}
+
+/// Per-batch memo over the dictionary probes. A trace batch repeats a handful
+/// of distinct names thousands of times; the cache turns all but the first
+/// occurrence into a hash lookup.
+pub(crate) struct InternCache {
+    functions: HashMap<String, i64>,
+    raw_names: HashMap<String, i64>,
+    source_files: HashMap<String, i64>,
+}
+
+impl InternCache {
+    pub(crate) fn new() -> Self {
+        Self {
+            functions: HashMap::new(),
+            raw_names: HashMap::new(),
+            source_files: HashMap::new(),
+        }
+    }
+
+    pub(crate) fn function_name(&mut self, conn: &Connection, name: &str) -> Result<i64> {
+        if let Some(&id) = self.functions.get(name) {
+            return Ok(id);
+        }
+        let id = intern(conn, "event_function_names", "name", name)?;
+        self.functions.insert(name.to_string(), id);
+        Ok(id)
+    }
+
+    pub(crate) fn raw_name(&mut self, conn: &Connection, name: &str) -> Result<i64> {
+        if let Some(&id) = self.raw_names.get(name) {
+            return Ok(id);
+        }
+        let id = intern(conn, "event_raw_names", "name", name)?;
+        self.raw_names.insert(name.to_string(), id);
+        Ok(id)
+    }
+
+    pub(crate) fn source_file(&mut self, conn: &Connection, path: &str) -> Result<i64> {
+        if let Some(&id) = self.source_files.get(path) {
+            return Ok(id);
+        }
+        let id = intern(conn, "event_source_files", "path", path)?;
+        self.source_files.insert(path.to_string(), id);
+        Ok(id)
+    }
+}
@@ -1,8 +1,14 @@
 mod baselines;
+mod checkpoint;
 mod event;
+mod fts;
+mod intern;
+mod output_ring;
 mod schema;
+mod segments;
 mod session;
 
+pub use checkpoint::{binary_fingerprint, HookCheckpoint, SessionCheckpoint, WatchCheckpoint};
 pub use event::{Event, EventInsertStats, EventType, TraceEventSummary, TraceEventVerbose};
 pub use schema::Database;
 pub use session::{Session, SessionStatus};
@@ -593,7 +599,7 @@ mod tests {
             {"name": "counter", "value": "42", "type": "int"},
             {"name": "ratio", "value": "3.14", "type": "float"}
         ]);
-        db.update_event_locals("crash-1", &locals).unwrap();
+        db.update_event_locals("s1", "crash-1", &locals).unwrap();
 
         let events = db.query_events("s1", |q| q).unwrap();
         let arr = events[0].locals.as_ref().unwrap().as_array().unwrap();
@@ -601,6 +607,34 @@ mod tests {
         assert_eq!(arr[0]["name"], "counter");
     }
 
+    #[test]
+    fn test_update_event_arguments() {
+        let (_dir, db) = test_db_with_session("s1");
+
+        // function_enter events land in segment tables, not the base table.
+        db.insert_event(&Event {
+            id: "enter-1".into(),
+            session_id: "s1".into(),
+            timestamp_ns: 1000,
+            thread_id: 1,
+            event_type: EventType::FunctionEnter,
+            function_name: "main".into(),
+            arguments: Some(serde_json::json!(["0x7fff0000", "0x2"])),
+            pid: Some(1234),
+            ..Default::default()
+        })
+        .unwrap();
+
+        let enriched = serde_json::json!(["{\"value\": 42}", "0x2"]);
+        db.update_event_arguments("s1", "enter-1", &enriched)
+            .unwrap();
+
+        let events = db.query_events("s1", |q| q).unwrap();
+        let args = events[0].arguments.as_ref().unwrap().as_array().unwrap();
+        assert_eq!(args[0], "{\"value\": 42}");
+        assert_eq!(args[1], "0x2");
+    }
+
     #[test]
     fn test_breakpoint_event_columns() {
         let dir = tempdir().unwrap();
@@ -673,11 +707,13 @@ mod tests {
             });
         }
 
-        let stats = db.insert_events_with_limit(&events, 10).unwrap();
+        // Output goes to the ring and never counts against the FIFO limit,
+        // so the limit only covers the 5 trace events.
+        let stats = db.insert_events_with_limit(&events, 5).unwrap();
         assert_eq!(stats.events_inserted, 10);
         assert_eq!(stats.events_deleted, 0);
 
-        // Now insert 5 more trace events with limit=10 — should evict 5 oldest trace events
+        // Now insert 5 more trace events with limit=5 — should evict 5 oldest trace events
         let more: Vec<Event> = (0..5)
             .map(|i| Event {
                 id: format!("trace-new-{}", i),
@@ -690,7 +726,7 @@ mod tests {
             })
             .collect();
 
-        let stats = db.insert_events_with_limit(&more, 10).unwrap();
+        let stats = db.insert_events_with_limit(&more, 5).unwrap();
         assert_eq!(stats.events_inserted, 5);
         assert_eq!(stats.events_deleted, 5); // 5 old trace events evicted
 
@@ -758,4 +794,608 @@ mod tests {
             .unwrap();
         assert_eq!(all.len(), 8);
     }
+
+    #[test]
+    fn test_output_flood_does_not_evict_trace_events() {
+        let (_dir, db) = test_db_with_session("s1");
+
+        // 5 trace events at limit 5, then a flood of 200 stdout chunks: the
+        // flood goes to the output ring and must not push any trace event
+        // out of the FIFO budget.
+        db.insert_events_with_limit(&trace_events("s1", 0..5), 5)
+            .unwrap();
+        let flood: Vec<Event> = (0..200)
+            .map(|i| Event {
+                id: format!("flood-{}", i),
+                session_id: "s1".into(),
+                timestamp_ns: 10_000 + i as i64,
+                thread_id: 1,
+                event_type: EventType::Stdout,
+                text: Some(format!("log line {}\n", i)),
+                ..Default::default()
+            })
+            .collect();
+        let stats = db.insert_events_with_limit(&flood, 5).unwrap();
+        assert_eq!(stats.events_deleted, 0, "output must not trigger eviction");
+
+        let traces = db
+            .query_events("s1", |q| q.event_type(EventType::FunctionEnter))
+            .unwrap();
+        assert_eq!(traces.len(), 5, "all trace events survive the flood");
+        let output = db
+            .query_events("s1", |q| q.text_output().limit(500))
+            .unwrap();
+        assert_eq!(output.len(), 200);
+    }
+
+    #[test]
+    fn test_output_ring_wraparound_keeps_newest() {
+        let dir = tempdir().unwrap();
+        let mut db = Database::open(&dir.path().join("test.db")).unwrap();
+        db.set_output_ring_capacity(4096);
+        db.create_session("s1", "/bin/test", "/home", 1234).unwrap();
+        let _dir = dir;
+
+        // ~100 bytes per record: 200 records lap the 4KB ring several times.
+        let events: Vec<Event> = (0..200)
+            .map(|i| Event {
+                id: format!("out-{}", i),
+                session_id: "s1".into(),
+                timestamp_ns: i as i64 * 100,
+                thread_id: 1,
+                event_type: EventType::Stdout,
+                text: Some(format!("line {} {}\n", i, "x".repeat(50))),
+                ..Default::default()
+            })
+            .collect();
+        db.insert_events_batch(&events).unwrap();
+
+        let output = db
+            .query_events("s1", |q| q.text_output().limit(500))
+            .unwrap();
+        assert!(!output.is_empty());
+        assert!(output.len() < 200, "oldest output is overwritten");
+        assert_eq!(output[0].id, "out-199", "newest output always survives");
+        // Counts agree with what the ring actually retained
+        assert_eq!(
+            db.count_filtered_events("s1", |q| q.text_output()).unwrap(),
+            output.len() as u64
+        );
+    }
+
+    #[test]
+    fn test_output_queryable_by_time_range() {
+        let (_dir, db) = test_db_with_session("s1");
+
+        let events: Vec<Event> = (0..20)
+            .map(|i| Event {
+                id: format!("out-{}", i),
+                session_id: "s1".into(),
+                timestamp_ns: i as i64 * 100,
+                thread_id: 1,
+                event_type: EventType::Stdout,
+                text: Some(format!("line {}\n", i)),
+                ..Default::default()
+            })
+            .collect();
+        db.insert_events_batch(&events).unwrap();
+
+        let window = db
+            .query_events("s1", |mut q| {
+                q.timestamp_from_ns = Some(500);
+                q.timestamp_to_ns = Some(900);
+                q
+            })
+            .unwrap();
+        assert_eq!(window.len(), 5);
+        assert!(window.iter().all(|e| (500..=900).contains(&e.timestamp_ns)));
+        assert_eq!(db.get_latest_timestamp("s1").unwrap(), 1900);
+    }
+
+    #[test]
+    fn test_delete_session_removes_ring_state() {
+        let (_dir, db) = test_db_with_session("s1");
+        db.insert_event(&Event {
+            id: "out-1".into(),
+            session_id: "s1".into(),
+            timestamp_ns: 100,
+            thread_id: 1,
+            event_type: EventType::Stdout,
+            text: Some("bye\n".into()),
+            ..Default::default()
+        })
+        .unwrap();
+        assert_eq!(db.count_session_events("s1").unwrap(), 1);
+
+        db.delete_session("s1").unwrap();
+        db.create_session("s1", "/bin/test", "/home", 1234).unwrap();
+        assert_eq!(db.count_session_events("s1").unwrap(), 0);
+        assert!(db
+            .query_events("s1", |q| q.text_output())
+            .unwrap()
+            .is_empty());
+    }
+
+    /// Helper: a batch of trace events with sequential ids and timestamps.
+    fn trace_events(session_id: &str, range: std::ops::Range<usize>) -> Vec<Event> {
+        range
+            .map(|i| Event {
+                id: format!("trace-{}", i),
+                session_id: session_id.into(),
+                timestamp_ns: i as i64 * 100,
+                thread_id: 1,
+                event_type: EventType::FunctionEnter,
+                function_name: format!("func_{}", i),
+                ..Default::default()
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_segment_rotation_is_transparent_to_queries() {
+        let (_dir, mut db) = test_db_with_session("s1");
+        db.set_segment_capacity(10);
+
+        // Three full segments' worth of trace events
+        for wave in 0..3 {
+            let events = trace_events("s1", wave * 10..(wave + 1) * 10);
+            db.insert_events_with_limit(&events, 10_000).unwrap();
+        }
+
+        // Rotation created further segments behind the scenes
+        assert!(db.table_exists("events_seg_2").unwrap());
+        assert!(db.table_exists("events_seg_3").unwrap());
+
+        // Reads union all segments: full count, newest-first ordering
+        assert_eq!(db.count_session_events("s1").unwrap(), 30);
+        let events = db.query_events("s1", |q| q.limit(50)).unwrap();
+        assert_eq!(events.len(), 30);
+        assert_eq!(events[0].id, "trace-29");
+        assert_eq!(events[29].id, "trace-0");
+    }
+
+    #[test]
+    fn test_fifo_eviction_drops_whole_segments() {
+        let (_dir, mut db) = test_db_with_session("s1");
+        db.set_segment_capacity(10);
+
+        // Two segments fill without eviction (limit 20)
+        db.insert_events_with_limit(&trace_events("s1", 0..10), 20)
+            .unwrap();
+        db.insert_events_with_limit(&trace_events("s1", 10..20), 20)
+            .unwrap();
+        let min_before = db.min_rowid_for_session("s1").unwrap().unwrap();
+
+        // Third wave overflows by exactly one segment: the oldest segment is
+        // dropped wholesale instead of deleting rows one by one.
+        let stats = db
+            .insert_events_with_limit(&trace_events("s1", 20..30), 20)
+            .unwrap();
+        assert_eq!(stats.events_deleted, 10);
+        assert!(!db.table_exists("events_seg_1").unwrap());
+
+        assert_eq!(db.count_session_events("s1").unwrap(), 20);
+        let events = db.query_events("s1", |q| q.limit(50)).unwrap();
+        assert_eq!(events[events.len() - 1].id, "trace-10", "oldest survivor");
+
+        // FIFO drop detection still works: min rowid advanced past the drop
+        let min_after = db.min_rowid_for_session("s1").unwrap().unwrap();
+        assert!(min_after > min_before);
+    }
+
+    #[test]
+    fn test_rowid_cursor_spans_segments() {
+        let (_dir, mut db) = test_db_with_session("s1");
+        db.set_segment_capacity(5);
+
+        db.insert_events_with_limit(&trace_events("s1", 0..5), 10_000)
+            .unwrap();
+        db.insert_events_with_limit(&trace_events("s1", 5..12), 10_000)
+            .unwrap();
+
+        // Rowids come from one global sequence, so insertion order and rowid
+        // order agree even across segment boundaries.
+        let mut events = db.query_events("s1", |q| q.limit(50)).unwrap();
+        events.sort_by_key(|e| e.timestamp_ns);
+        let rowids: Vec<i64> = events.iter().map(|e| e.rowid.unwrap()).collect();
+        assert!(rowids.windows(2).all(|w| w[0] < w[1]));
+
+        // after_rowid cursor returns exactly the events inserted later
+        let cursor = events[5].rowid.unwrap();
+        let newer = db
+            .query_events("s1", |mut q| {
+                q.after_rowid = Some(cursor);
+                q.limit(50)
+            })
+            .unwrap();
+        assert_eq!(newer.len(), 6);
+        assert!(newer.iter().all(|e| e.rowid.unwrap() > cursor));
+    }
+
+    #[test]
+    fn test_latest_timestamp_spans_base_and_segments() {
+        let (_dir, db) = test_db_with_session("s1");
+        assert_eq!(db.get_latest_timestamp("s1").unwrap(), 0);
+
+        // Trace events land in segments; the crash stays in the base table
+        // with the newest timestamp, so both stores must be consulted.
+        db.insert_events_with_limit(&trace_events("s1", 0..5), 10_000)
+            .unwrap();
+        db.insert_event(&Event {
+            id: "crash-1".into(),
+            session_id: "s1".into(),
+            timestamp_ns: 9_999,
+            thread_id: 1,
+            event_type: EventType::Crash,
+            function_name: "boom".into(),
+            ..Default::default()
+        })
+        .unwrap();
+
+        assert_eq!(db.get_latest_timestamp("s1").unwrap(), 9_999);
+    }
+
+    #[test]
+    fn test_time_window_query_prunes_segments() {
+        let (_dir, mut db) = test_db_with_session("s1");
+        db.set_segment_capacity(5);
+
+        // Four segments; timestamps are i * 100, so each covers a distinct range
+        for wave in 0..4 {
+            db.insert_events_with_limit(&trace_events("s1", wave * 5..(wave + 1) * 5), 10_000)
+                .unwrap();
+        }
+
+        // A window inside the second segment returns exactly its rows
+        let window = db
+            .query_events("s1", |mut q| {
+                q.timestamp_from_ns = Some(500);
+                q.timestamp_to_ns = Some(900);
+                q.limit(50)
+            })
+            .unwrap();
+        assert_eq!(window.len(), 5);
+        assert!(window.iter().all(|e| (500..=900).contains(&e.timestamp_ns)));
+
+        // Counting sees the same pruned source
+        let count = db
+            .count_filtered_events("s1", |mut q| {
+                q.timestamp_from_ns = Some(500);
+                q.timestamp_to_ns = Some(900);
+                q
+            })
+            .unwrap();
+        assert_eq!(count, 5);
+
+        // A window past the whole timeline matches no table and returns empty
+        let beyond = db
+            .query_events("s1", |mut q| {
+                q.timestamp_from_ns = Some(1_000_000);
+                q.limit(50)
+            })
+            .unwrap();
+        assert!(beyond.is_empty());
+    }
+
+    #[test]
+    fn test_keyset_pagination_with_before_rowid() {
+        let (_dir, db) = test_db_with_session("s1");
+        db.insert_events_batch(&trace_events("s1", 0..12)).unwrap();
+
+        // First page: newest 5 events, no cursor
+        let page1 = db.query_events("s1", |q| q.limit(5)).unwrap();
+        assert_eq!(page1.len(), 5);
+        assert_eq!(page1[0].id, "trace-11");
+
+        // Next older page keys off the lowest rowid of the previous page —
+        // no OFFSET scan, and the pages tile without gaps or overlap.
+        let cursor = page1.iter().filter_map(|e| e.rowid).min().unwrap();
+        let page2 = db
+            .query_events("s1", |q| q.before_rowid(cursor).limit(5))
+            .unwrap();
+        assert_eq!(page2.len(), 5);
+        assert_eq!(page2[0].id, "trace-6");
+        assert!(page2.iter().all(|e| e.rowid.unwrap() < cursor));
+
+        // Remaining-count under the same cursor drives hasMore
+        let remaining = db
+            .count_filtered_events("s1", |q| q.before_rowid(cursor))
+            .unwrap();
+        assert_eq!(remaining, 7);
+    }
+
+    #[test]
+    fn test_substring_filters_use_fts_index() {
+        let (_dir, db) = test_db_with_session("s1");
+        assert!(db.fts_enabled, "bundled SQLite should have FTS5");
+
+        let events: Vec<Event> = [
+            ("e1", "juce::AudioBuffer::clear", "src/audio/buffer.cpp"),
+            ("e2", "juce::AudioBuffer::addFrom", "src/audio/buffer.cpp"),
+            ("e3", "Engine::process", "src/engine.cpp"),
+        ]
+        .iter()
+        .enumerate()
+        .map(|(i, (id, func, file))| Event {
+            id: id.to_string(),
+            session_id: "s1".into(),
+            timestamp_ns: i as i64 * 100,
+            thread_id: 1,
+            event_type: EventType::FunctionEnter,
+            function_name: func.to_string(),
+            source_file: Some(file.to_string()),
+            ..Default::default()
+        })
+        .collect();
+        db.insert_events_with_limit(&events, 10_000).unwrap();
+
+        // Trigram path (pattern >= 3 chars), case-insensitive like LIKE
+        let hits = db
+            .query_events("s1", |q| q.function_contains("audiobuffer"))
+            .unwrap();
+        assert_eq!(hits.len(), 2);
+        let hits = db
+            .query_events("s1", |q| q.source_file_contains("audio/buffer"))
+            .unwrap();
+        assert_eq!(hits.len(), 2);
+        assert_eq!(
+            db.count_filtered_events("s1", |q| q.function_contains("process"))
+                .unwrap(),
+            1
+        );
+
+        // Short patterns fall back to LIKE and still match
+        let hits = db
+            .query_events("s1", |q| q.function_contains("ju"))
+            .unwrap();
+        assert_eq!(hits.len(), 2);
+
+        // No false positives
+        assert!(db
+            .query_events("s1", |q| q.function_contains("nonexistent"))
+            .unwrap()
+            .is_empty());
+    }
+
+    #[test]
+    fn test_fts_dictionary_backfill_on_reopen() {
+        let dir = tempdir().unwrap();
+        let path = dir.path().join("test.db");
+        {
+            let db = Database::open(&path).unwrap();
+            db.create_session("s1", "/bin/test", "/home", 1234).unwrap();
+            db.insert_event(&Event {
+                id: "e1".into(),
+                session_id: "s1".into(),
+                timestamp_ns: 100,
+                thread_id: 1,
+                event_type: EventType::FunctionEnter,
+                function_name: "Engine::render".into(),
+                ..Default::default()
+            })
+            .unwrap();
+            // Simulate a database written by a build without FTS5: interning
+            // keeps the dictionary populated, but the trigram mirror is empty
+            let conn = db.conn.lock().unwrap();
+            conn.execute("DELETE FROM event_function_names_fts", [])
+                .unwrap();
+        }
+
+        // Reopen: the empty dictionary is rebuilt from existing events
+        let db = Database::open(&path).unwrap();
+        let hits = db
+            .query_events("s1", |q| q.function_contains("render"))
+            .unwrap();
+        assert_eq!(hits.len(), 1);
+    }
+
+    #[test]
+    fn test_interned_segments_store_dictionary_ids() {
+        let (_dir, db) = test_db_with_session("s1");
+        let long_name =
+            "std::vector<std::pair<juce::String, juce::AudioBuffer<float>>>::emplace_back";
+
+        let events: Vec<Event> = (0..3)
+            .map(|i| Event {
+                id: format!("e{}", i),
+                session_id: "s1".into(),
+                timestamp_ns: i as i64 * 100,
+                thread_id: 1,
+                event_type: EventType::FunctionEnter,
+                function_name: long_name.into(),
+                function_name_raw: Some("_ZNSt6vectorISt4pairEE12emplace_back".into()),
+                source_file: Some("/proj/src/engine.cpp".into()),
+                ..Default::default()
+            })
+            .collect();
+        db.insert_events_batch(&events).unwrap();
+
+        // Physically the rows hold one shared dictionary id, and the string
+        // is stored exactly once
+        {
+            let conn = db.conn.lock().unwrap();
+            let distinct_ids: i64 = conn
+                .query_row(
+                    "SELECT COUNT(DISTINCT function_name_id) FROM events_seg_1",
+                    [],
+                    |row| row.get(0),
+                )
+                .unwrap();
+            assert_eq!(distinct_ids, 1);
+            let copies: i64 = conn
+                .query_row(
+                    "SELECT COUNT(*) FROM event_function_names WHERE name = ?",
+                    rusqlite::params![long_name],
+                    |row| row.get(0),
+                )
+                .unwrap();
+            assert_eq!(copies, 1);
+        }
+
+        // Readers get the strings joined back, and function_equals resolves
+        // through the dictionary
+        let hits = db
+            .query_events("s1", |q| q.function_equals(long_name))
+            .unwrap();
+        assert_eq!(hits.len(), 3);
+        assert_eq!(hits[0].function_name, long_name);
+        assert_eq!(hits[0].source_file.as_deref(), Some("/proj/src/engine.cpp"));
+        assert_eq!(
+            hits[0].function_name_raw.as_deref(),
+            Some("_ZNSt6vectorISt4pairEE12emplace_back")
+        );
+    }
+
+    #[test]
+    fn test_pre_interning_segments_remain_readable() {
+        let dir = tempdir().unwrap();
+        let path = dir.path().join("test.db");
+        {
+            let db = Database::open(&path).unwrap();
+            db.create_session("s1", "/bin/test", "/home", 1234).unwrap();
+            // Rebuild segment 1 in the pre-interning TEXT shape with a legacy
+            // row, as a database written by an older build would leave it
+            let conn = db.conn.lock().unwrap();
+            conn.execute("DROP TABLE events_seg_1", []).unwrap();
+            conn.execute(
+                "CREATE TABLE events_seg_1 (
+                    id TEXT PRIMARY KEY, session_id TEXT NOT NULL,
+                    timestamp_ns INTEGER NOT NULL, thread_id INTEGER NOT NULL,
+                    thread_name TEXT, parent_event_id TEXT, event_type TEXT NOT NULL,
+                    function_name TEXT NOT NULL, function_name_raw TEXT, source_file TEXT,
+                    line_number INTEGER, arguments JSON, return_value JSON,
+                    duration_ns INTEGER, text TEXT, sampled INTEGER, watch_values JSON,
+                    pid INTEGER, signal TEXT, fault_address TEXT, registers JSON,
+                    backtrace JSON, locals JSON, breakpoint_id TEXT, logpoint_message TEXT,
+                    exception_type TEXT, exception_message TEXT, throw_backtrace JSON)",
+                [],
+            )
+            .unwrap();
+            conn.execute(
+                "INSERT INTO events_seg_1
+                     (id, session_id, timestamp_ns, thread_id, event_type, function_name)
+                 VALUES ('legacy-1', 's1', 100, 1, 'function_enter', 'Engine::render')",
+                [],
+            )
+            .unwrap();
+        }
+
+        // Reopen: initialize rotates past the TEXT segment so new rows are
+        // interned, while the legacy segment stays readable through the view
+        let db = Database::open(&path).unwrap();
+        assert!(db.table_exists("events_seg_2").unwrap());
+        db.insert_event(&Event {
+            id: "new-1".into(),
+            session_id: "s1".into(),
+            timestamp_ns: 200,
+            thread_id: 1,
+            event_type: EventType::FunctionEnter,
+            function_name: "Engine::render".into(),
+            ..Default::default()
+        })
+        .unwrap();
+
+        let events = db.query_events("s1", |q| q).unwrap();
+        assert_eq!(events.len(), 2);
+        assert!(events.iter().all(|e| e.function_name == "Engine::render"));
+        let hits = db
+            .query_events("s1", |q| q.function_equals("Engine::render"))
+            .unwrap();
+        assert_eq!(hits.len(), 2, "filter spans legacy and interned segments");
+    }
+
+    #[test]
+    fn test_aggregate_summaries_survive_eviction() {
+        let (_dir, db) = test_db_with_session("s1");
+
+        let summary = Event {
+            id: "agg-1".into(),
+            session_id: "s1".into(),
+            timestamp_ns: 50,
+            thread_id: 0,
+            event_type: EventType::AggregateSummary,
+            function_name: "juce::AudioBuffer::clear".into(),
+            arguments: Some(serde_json::json!({
+                "callCount": 250_000,
+                "meanDurationNs": 480,
+            })),
+            ..Default::default()
+        };
+        db.insert_events_with_limit(std::slice::from_ref(&summary), 10)
+            .unwrap();
+
+        // Blow well past the limit with trace events: the summary is the
+        // whole point of aggregation mode and must outlive the FIFO
+        db.insert_events_with_limit(&trace_events("s1", 0..10), 10)
+            .unwrap();
+        let stats = db
+            .insert_events_with_limit(&trace_events("s1", 10..20), 10)
+            .unwrap();
+        assert_eq!(stats.events_deleted, 10, "trace events evicted");
+
+        let kept = db
+            .query_events("s1", |q| q.event_type(EventType::AggregateSummary))
+            .unwrap();
+        assert_eq!(kept.len(), 1);
+        assert_eq!(kept[0].id, "agg-1");
+        assert_eq!(kept[0].arguments.as_ref().unwrap()["callCount"], 250_000);
+    }
+
+    #[test]
+    fn test_per_session_dbs_route_events() {
+        let dir = tempdir().unwrap();
+        let db = Database::open_with_session_dbs(&dir.path().join("strobe.db")).unwrap();
+        db.create_session("s1", "/bin/a", "/proj", 1).unwrap();
+        db.create_session("s2", "/bin/b", "/proj", 2).unwrap();
+
+        db.insert_events_with_limit(&trace_events("s1", 0..5), 10_000)
+            .unwrap();
+        db.insert_events_batch(&trace_events("s2", 0..3)).unwrap();
+
+        // Each session's events landed in its own file...
+        assert!(dir.path().join("sessions/s1.db").exists());
+        assert!(dir.path().join("sessions/s2.db").exists());
+        // ...and nothing in the shared database
+        let shared: i64 = db
+            .conn
+            .lock()
+            .unwrap()
+            .query_row("SELECT COUNT(*) FROM events_all", [], |row| row.get(0))
+            .unwrap();
+        assert_eq!(shared, 0);
+
+        // Reads route transparently through the same API
+        let events = db.query_events("s1", |q| q.limit(50)).unwrap();
+        assert_eq!(events.len(), 5);
+        assert_eq!(events[0].id, "trace-4");
+        assert_eq!(db.count_session_events("s2").unwrap(), 3);
+
+        // Eviction limits apply per session
+        let stats = db
+            .insert_events_with_limit(&trace_events("s1", 5..15), 10)
+            .unwrap();
+        assert_eq!(stats.events_deleted, 5);
+        assert_eq!(db.count_session_events("s1").unwrap(), 10);
+        assert_eq!(db.count_session_events("s2").unwrap(), 3);
+    }
+
+    #[test]
+    fn test_per_session_db_delete_unlinks_file() {
+        let dir = tempdir().unwrap();
+        let db = Database::open_with_session_dbs(&dir.path().join("strobe.db")).unwrap();
+        db.create_session("s1", "/bin/a", "/proj", 1).unwrap();
+        db.create_session("s2", "/bin/b", "/proj", 2).unwrap();
+        db.insert_events_batch(&trace_events("s1", 0..5)).unwrap();
+        db.insert_events_batch(&trace_events("s2", 0..5)).unwrap();
+
+        db.delete_session("s1").unwrap();
+
+        assert!(!dir.path().join("sessions/s1.db").exists());
+        assert!(db.get_session("s1").unwrap().is_none());
+        // The other session is untouched, and reading the deleted session
+        // does not resurrect its file
+        assert_eq!(db.count_session_events("s2").unwrap(), 5);
+        assert_eq!(db.query_events("s1", |q| q).unwrap().len(), 0);
+        assert!(!dir.path().join("sessions/s1.db").exists());
+    }
 }
@@ -1,6 +1,7 @@
 use crate::Result;
 use rusqlite::{params, Connection};
-use std::path::Path;
+use std::collections::HashMap;
+use std::path::{Path, PathBuf};
 use std::sync::{Arc, Mutex};
 
 /// Add a column to a table, ignoring "duplicate column" errors (idempotent migration).
@@ -22,6 +23,52 @@ fn add_column_if_not_exists(
 
 pub struct Database {
     pub(crate) conn: Arc<Mutex<Connection>>,
+    /// Rows per event segment before rotation (see `segments`).
+    pub(crate) segment_capacity: usize,
+    /// Whether the linked SQLite has FTS5 (see `fts`); false falls back to
+    /// LIKE scans for substring filters.
+    pub(crate) fts_enabled: bool,
+    /// When set, event storage is per-session: each session's events live in
+    /// their own WAL database at `<dir>/<session_id>.db` and `conn` holds only
+    /// shared metadata (sessions, test_baselines). `None` keeps events in
+    /// `conn` as a single file (in-memory databases, tests).
+    pub(crate) sessions_dir: Option<PathBuf>,
+    /// Opened per-session databases, keyed by session id.
+    pub(crate) session_dbs: Arc<Mutex<HashMap<String, Database>>>,
+    /// Directory the database file lives in. Output ring files are placed
+    /// beside it as `<session_id>.out`; `None` (in-memory databases) uses
+    /// memory-backed rings.
+    pub(crate) db_dir: Option<PathBuf>,
+    /// Capacity for newly created output rings (see `output_ring`).
+    pub(crate) output_ring_capacity: u64,
+    /// Opened per-session output rings, keyed by session id.
+    pub(crate) output_rings:
+        Arc<Mutex<HashMap<String, Arc<Mutex<super::output_ring::OutputRing>>>>>,
+}
+
+/// Session id sanitized for use as a filename. Session ids are UUID-shaped
+/// today; the filter keeps an unexpected id from escaping the directory.
+fn safe_session_stem(session_id: &str) -> String {
+    session_id
+        .chars()
+        .map(|c| {
+            if c.is_ascii_alphanumeric() || matches!(c, '-' | '_' | '.') {
+                c
+            } else {
+                '_'
+            }
+        })
+        .collect()
+}
+
+/// Filename for a session's database.
+fn session_db_filename(session_id: &str) -> String {
+    format!("{}.db", safe_session_stem(session_id))
+}
+
+/// Filename for a session's output ring (see `output_ring`).
+fn session_ring_filename(session_id: &str) -> String {
+    format!("{}.out", safe_session_stem(session_id))
 }
 
 impl Database {
@@ -35,24 +82,64 @@ impl Database {
             "PRAGMA synchronous=NORMAL; PRAGMA busy_timeout=5000; PRAGMA foreign_keys=ON;",
         )?;
 
-        let db = Self {
+        let mut db = Self {
             conn: Arc::new(Mutex::new(conn)),
+            segment_capacity: super::segments::DEFAULT_SEGMENT_CAPACITY,
+            fts_enabled: false,
+            sessions_dir: None,
+            session_dbs: Arc::new(Mutex::new(HashMap::new())),
+            db_dir: path.parent().map(Path::to_path_buf),
+            output_ring_capacity: super::output_ring::configured_capacity(),
+            output_rings: Arc::new(Mutex::new(HashMap::new())),
         };
 
-        db.initialize_schema()?;
+        db.fts_enabled = db.initialize_schema()?;
+        Ok(db)
+    }
+
+    /// Open the shared metadata database at `path` with per-session event
+    /// storage enabled: each session's events go to their own WAL database
+    /// under `<parent>/sessions/`, so writers for different sessions never
+    /// contend on one WAL file. Used by the daemon; tests use `open`.
+    pub fn open_with_session_dbs(path: &Path) -> Result<Self> {
+        let mut db = Self::open(path)?;
+        db.sessions_dir = Some(path.parent().unwrap_or(Path::new(".")).join("sessions"));
         Ok(db)
     }
 
     pub fn open_in_memory() -> Result<Self> {
         let conn = Connection::open_in_memory()?;
-        let db = Self {
+        let mut db = Self {
             conn: Arc::new(Mutex::new(conn)),
+            segment_capacity: super::segments::DEFAULT_SEGMENT_CAPACITY,
+            fts_enabled: false,
+            sessions_dir: None,
+            session_dbs: Arc::new(Mutex::new(HashMap::new())),
+            db_dir: None,
+            output_ring_capacity: super::output_ring::configured_capacity(),
+            output_rings: Arc::new(Mutex::new(HashMap::new())),
         };
-        db.initialize_schema()?;
+        db.fts_enabled = db.initialize_schema()?;
         Ok(db)
     }
 
-    fn initialize_schema(&self) -> Result<()> {
+    /// Test hook: shrink segments so rotation and drop paths are exercised
+    /// without inserting tens of thousands of rows.
+    #[cfg(test)]
+    pub(crate) fn set_segment_capacity(&mut self, capacity: usize) {
+        self.segment_capacity = capacity.max(1);
+    }
+
+    /// Test hook: shrink output rings so wraparound eviction is exercised
+    /// without writing tens of megabytes.
+    #[cfg(test)]
+    pub(crate) fn set_output_ring_capacity(&mut self, bytes: u64) {
+        self.output_ring_capacity = bytes.max(1024);
+    }
+
+    /// Create/migrate all tables. Returns whether FTS5 substring indexing is
+    /// available (kept on the struct so queries can pick the fast path).
+    fn initialize_schema(&self) -> Result<bool> {
         let conn = self.conn.lock().unwrap();
 
         // Create main tables
@@ -158,11 +245,34 @@ impl Database {
             [],
         )?;
 
-        // Note: FTS5 virtual table is omitted for now due to linker issues
-        // with static SQLite builds. Full-text search can use LIKE queries
-        // or be added later with proper FTS5 linking.
+        // Covering indexes for the hot filter combinations in query_events
+        // (pid + time ordering, min_duration scans).
+        conn.execute(
+            "CREATE INDEX IF NOT EXISTS idx_events_pid_time ON events(session_id, pid, timestamp_ns)",
+            [],
+        )?;
+        conn.execute(
+            "CREATE INDEX IF NOT EXISTS idx_events_duration ON events(session_id, duration_ns)",
+            [],
+        )?;
+
+        // Segmented trace-event storage: segment tables, rowid sequence and
+        // the events_all view all reads go through.
+        super::segments::initialize(&conn)?;
 
-        Ok(())
+        // Output ring metadata: write position and coarse granule index for
+        // the per-session stdout/stderr ring files.
+        super::output_ring::initialize(&conn)?;
+
+        // Session checkpoints: resolved hook/watch state for daemon-restart
+        // resume (see `checkpoint`).
+        super::checkpoint::initialize(&conn)?;
+
+        // Trigram substring index over function names / source files. Probed
+        // at runtime: builds without FTS5 keep working via LIKE scans.
+        let fts_enabled = super::fts::initialize(&conn);
+
+        Ok(fts_enabled)
     }
 
     pub fn table_exists(&self, table_name: &str) -> Result<bool> {
@@ -178,12 +288,152 @@ impl Database {
     pub(crate) fn connection(&self) -> std::sync::MutexGuard<'_, Connection> {
         self.conn.lock().unwrap()
     }
+
+    /// Database holding event rows for `session_id`: the per-session file when
+    /// per-session storage is enabled, otherwise `None` (events live in
+    /// `self`). Creates the file on first use, mirroring the session row into
+    /// it so the events → sessions foreign key resolves there.
+    pub(crate) fn events_db(&self, session_id: &str) -> Result<Option<Database>> {
+        let Some(dir) = &self.sessions_dir else {
+            return Ok(None);
+        };
+        if let Some(db) = self.cached_session_db(session_id) {
+            return Ok(Some(db));
+        }
+        std::fs::create_dir_all(dir)?;
+        self.open_session_db(session_id, &dir.join(session_db_filename(session_id)))
+            .map(Some)
+    }
+
+    /// Read-side variant of `events_db` that never creates a file. `None`
+    /// means the session has no per-session database (yet); the caller falls
+    /// through to the shared connection, which also covers events written
+    /// before per-session storage existed.
+    pub(crate) fn existing_events_db(&self, session_id: &str) -> Result<Option<Database>> {
+        let Some(dir) = &self.sessions_dir else {
+            return Ok(None);
+        };
+        if let Some(db) = self.cached_session_db(session_id) {
+            return Ok(Some(db));
+        }
+        let path = dir.join(session_db_filename(session_id));
+        if !path.exists() {
+            return Ok(None);
+        }
+        self.open_session_db(session_id, &path).map(Some)
+    }
+
+    fn cached_session_db(&self, session_id: &str) -> Option<Database> {
+        self.session_dbs.lock().unwrap().get(session_id).cloned()
+    }
+
+    fn open_session_db(&self, session_id: &str, path: &Path) -> Result<Database> {
+        let mut db = Database::open(path)?;
+        db.segment_capacity = self.segment_capacity;
+        db.output_ring_capacity = self.output_ring_capacity;
+        db.mirror_session_row(session_id, self.get_session(session_id)?)?;
+        let mut cache = self.session_dbs.lock().unwrap();
+        Ok(cache.entry(session_id.to_string()).or_insert(db).clone())
+    }
+
+    /// Drop the cached handle and unlink a session's database files (with WAL
+    /// sidecars). No-op for single-file databases or missing files.
+    pub(crate) fn remove_session_db(&self, session_id: &str) -> Result<()> {
+        let Some(dir) = &self.sessions_dir else {
+            return Ok(());
+        };
+        self.session_dbs.lock().unwrap().remove(session_id);
+        let base = dir.join(session_db_filename(session_id));
+        for path in [
+            base.clone(),
+            base.with_extension("db-wal"),
+            base.with_extension("db-shm"),
+            dir.join(session_ring_filename(session_id)),
+        ] {
+            match std::fs::remove_file(&path) {
+                Ok(()) => {}
+                Err(e) if e.kind() == std::io::ErrorKind::NotFound => {}
+                Err(e) => return Err(e.into()),
+            }
+        }
+        Ok(())
+    }
+
+    /// Get or create the output ring for a session (see `output_ring`). Takes
+    /// the caller's live connection guard so ring state reads and writes join
+    /// whatever transaction is open on it.
+    pub(crate) fn output_ring(
+        &self,
+        conn: &Connection,
+        session_id: &str,
+    ) -> Result<Arc<Mutex<super::output_ring::OutputRing>>> {
+        let mut rings = self.output_rings.lock().unwrap();
+        if let Some(ring) = rings.get(session_id) {
+            return Ok(Arc::clone(ring));
+        }
+        let path = self
+            .db_dir
+            .as_ref()
+            .map(|dir| dir.join(session_ring_filename(session_id)));
+        let ring = super::output_ring::OutputRing::open(
+            conn,
+            session_id,
+            path,
+            self.output_ring_capacity,
+        )?;
+        let ring = Arc::new(Mutex::new(ring));
+        rings.insert(session_id.to_string(), Arc::clone(&ring));
+        Ok(ring)
+    }
+
+    /// Read-side variant of `output_ring` that never creates a ring file.
+    /// `None` means the session has produced no output, so queries skip the
+    /// ring entirely.
+    pub(crate) fn existing_output_ring(
+        &self,
+        conn: &Connection,
+        session_id: &str,
+    ) -> Result<Option<Arc<Mutex<super::output_ring::OutputRing>>>> {
+        if let Some(ring) = self.output_rings.lock().unwrap().get(session_id) {
+            return Ok(Some(Arc::clone(ring)));
+        }
+        let exists: i64 = conn.query_row(
+            "SELECT COUNT(*) FROM output_ring_state WHERE session_id = ?",
+            params![session_id],
+            |row| row.get(0),
+        )?;
+        if exists == 0 {
+            return Ok(None);
+        }
+        self.output_ring(conn, session_id).map(Some)
+    }
+
+    /// Drop the cached ring handle and unlink a session's ring file. No-op
+    /// when the session never produced output.
+    pub(crate) fn remove_output_ring(&self, session_id: &str) -> Result<()> {
+        self.output_rings.lock().unwrap().remove(session_id);
+        if let Some(dir) = &self.db_dir {
+            match std::fs::remove_file(dir.join(session_ring_filename(session_id))) {
+                Ok(()) => {}
+                Err(e) if e.kind() == std::io::ErrorKind::NotFound => {}
+                Err(e) => return Err(e.into()),
+            }
+        }
+        Ok(())
+    }
 }
 
 impl Clone for Database {
     fn clone(&self) -> Self {
         Self {
             conn: Arc::clone(&self.conn),
+            segment_capacity: self.segment_capacity,
+            fts_enabled: self.fts_enabled,
+            sessions_dir: self.sessions_dir.clone(),
+            session_dbs: Arc::clone(&self.session_dbs),
+            db_dir: self.db_dir.clone(),
+            output_ring_capacity: self.output_ring_capacity,
+            output_rings: Arc::clone(&self.output_rings),
         }
     }
 }
@@ -0,0 +1,429 @@
+//! Segmented storage for high-volume trace events.
+//!
+//! FIFO eviction via `DELETE` rewrites B-tree pages for every evicted row; at
+//! high event rates the churn balloons the WAL file far past the database
+//! itself. Instead, evictable trace events (function_enter, function_exit,
+//! variable_snapshot) are appended to fixed-size segment tables
+//! (`events_seg_N`). When a session's overage covers a whole segment, eviction
+//! is a `DROP TABLE` — constant time regardless of how many rows the segment
+//! holds, and the WAL only records the freed page list.
+//!
+//! Never-evicted event types (stdout, stderr, crash, pause, logpoint,
+//! condition_error) stay in the original `events` table, which also keeps any
+//! trace rows from databases created before segmentation. Reads go through the
+//! `events_all` view — a `UNION ALL` over the base table and every live
+//! segment — so query SQL is unchanged and SQLite pushes predicates down into
+//! each arm's indexes.
+//!
+//! Rowids are allocated from a single monotonic sequence shared by all tables,
+//! so `after_rowid` cursors and FIFO-drop detection via `MIN(rowid)` behave
+//! exactly as they did with one table.
+//!
+//! Segment rows intern their strings: `function_name`, `function_name_raw` and
+//! `source_file` are stored as 8-byte dictionary ids (see `intern`) and the
+//! view joins the text back, so high-volume rows never repeat a 300-byte C++
+//! signature. Segments created before interning keep their TEXT columns and
+//! get a plain view arm until eviction drops them.
+
+use super::event::EventType;
+use crate::Result;
+use rusqlite::{params, Connection};
+
+/// Rows per segment before the writer rotates to a fresh one. Sized so a
+/// segment covers a few seconds of heavy tracing: big enough that drops are
+/// rare, small enough that one drop never reclaims more than a sliver of a
+/// session's history.
+pub(crate) const DEFAULT_SEGMENT_CAPACITY: usize = 50_000;
+
+/// Column list of the base `events` table and the `events_all` view. Order
+/// matters: every `UNION ALL` arm must agree.
+pub(crate) const EVENT_COLUMNS: &str = "id, session_id, timestamp_ns, thread_id, thread_name, \
+     parent_event_id, event_type, function_name, function_name_raw, source_file, line_number, \
+     arguments, return_value, duration_ns, text, sampled, watch_values, pid, signal, \
+     fault_address, registers, backtrace, locals, breakpoint_id, logpoint_message, \
+     exception_type, exception_message, throw_backtrace";
+
+/// Columns segment rows are physically inserted with: as `EVENT_COLUMNS`, but
+/// with the three string columns replaced by their dictionary ids.
+pub(crate) const SEGMENT_INSERT_COLUMNS: &str = "id, session_id, timestamp_ns, thread_id, \
+     thread_name, parent_event_id, event_type, function_name_id, function_name_raw_id, \
+     source_file_id, line_number, arguments, return_value, duration_ns, text, sampled, \
+     watch_values, pid, signal, fault_address, registers, backtrace, locals, breakpoint_id, \
+     logpoint_message, exception_type, exception_message, throw_backtrace";
+
+/// Select list for interned-segment view arms (`s` = the segment table): the
+/// dictionary joins present the same columns, in the same order, as
+/// `EVENT_COLUMNS`.
+const INTERNED_VIEW_COLUMNS: &str = "s.id, s.session_id, s.timestamp_ns, s.thread_id, \
+     s.thread_name, s.parent_event_id, s.event_type, fn_names.name AS function_name, \
+     raw_names.name AS function_name_raw, src_files.path AS source_file, s.line_number, \
+     s.arguments, s.return_value, s.duration_ns, s.text, s.sampled, s.watch_values, s.pid, \
+     s.signal, s.fault_address, s.registers, s.backtrace, s.locals, s.breakpoint_id, \
+     s.logpoint_message, s.exception_type, s.exception_message, s.throw_backtrace";
+
+/// Typed column definitions for segment tables. Mirrors the fully-migrated
+/// `events` schema except for the interned string ids (segments are always
+/// created at the latest version, so no ALTER TABLE migrations apply to them;
+/// pre-interning segments are detected via `segment_interned`).
+const SEGMENT_COLUMN_DEFS: &str = "id TEXT PRIMARY KEY,
+     session_id TEXT NOT NULL,
+     timestamp_ns INTEGER NOT NULL,
+     thread_id INTEGER NOT NULL,
+     thread_name TEXT,
+     parent_event_id TEXT,
+     event_type TEXT NOT NULL,
+     function_name_id INTEGER NOT NULL,
+     function_name_raw_id INTEGER,
+     source_file_id INTEGER,
+     line_number INTEGER,
+     arguments JSON,
+     return_value JSON,
+     duration_ns INTEGER,
+     text TEXT,
+     sampled INTEGER,
+     watch_values JSON,
+     pid INTEGER,
+     signal TEXT,
+     fault_address TEXT,
+     registers JSON,
+     backtrace JSON,
+     locals JSON,
+     breakpoint_id TEXT,
+     logpoint_message TEXT,
+     exception_type TEXT,
+     exception_message TEXT,
+     throw_backtrace JSON,
+     FOREIGN KEY (session_id) REFERENCES sessions(id)";
+
+/// Whether this event type is FIFO-evictable (and therefore stored in
+/// segments). Output and crash events are never evicted so test results and
+/// error context survive heavy tracing; aggregate summaries are protected
+/// too — they exist precisely so hot-function statistics outlive the FIFO.
+pub(crate) fn is_evictable(event_type: &EventType) -> bool {
+    matches!(
+        event_type,
+        EventType::FunctionEnter | EventType::FunctionExit | EventType::VariableSnapshot
+    )
+}
+
+pub(crate) fn segment_table(seg_id: i64) -> String {
+    format!("events_seg_{}", seg_id)
+}
+
+/// Whether a segment stores interned dictionary ids (`function_name_id`)
+/// rather than the pre-interning TEXT columns.
+pub(crate) fn segment_interned(conn: &Connection, table: &str) -> Result<bool> {
+    let count: i64 = conn.query_row(
+        "SELECT COUNT(*) FROM pragma_table_info(?) WHERE name = 'function_name_id'",
+        params![table],
+        |row| row.get(0),
+    )?;
+    Ok(count > 0)
+}
+
+/// Create meta tables, the rowid sequence, the first segment and the
+/// `events_all` view. Idempotent; called from `initialize_schema`.
+pub(crate) fn initialize(conn: &Connection) -> Result<()> {
+    // Dictionary tables must exist before any interned segment or view arm
+    // references them.
+    super::intern::initialize(conn)?;
+    conn.execute(
+        "CREATE TABLE IF NOT EXISTS event_segments (
+            seg_id INTEGER PRIMARY KEY,
+            created_at INTEGER NOT NULL
+        )",
+        [],
+    )?;
+
+    // Global rowid sequence. Seeded past the base table's max rowid so
+    // explicit rowids never collide with rows from pre-segment databases.
+    conn.execute(
+        "CREATE TABLE IF NOT EXISTS event_rowid_seq (
+            id INTEGER PRIMARY KEY CHECK (id = 1),
+            next_rowid INTEGER NOT NULL
+        )",
+        [],
+    )?;
+    conn.execute(
+        "INSERT OR IGNORE INTO event_rowid_seq (id, next_rowid)
+         VALUES (1, (SELECT COALESCE(MAX(rowid), 0) + 1 FROM events))",
+        [],
+    )?;
+
+    if live_segments(conn)?.is_empty() {
+        create_segment(conn, 1)?;
+    }
+    // Databases from before interning have a TEXT-column active segment;
+    // rotate so new rows are interned. The old segments stay readable through
+    // the view until eviction drops them.
+    let active = active_segment(conn)?;
+    if !segment_interned(conn, &segment_table(active))? {
+        create_segment(conn, active + 1)?;
+    }
+    // Index migrations apply to segments created by older versions too.
+    for seg_id in live_segments(conn)? {
+        create_segment_indexes(conn, &segment_table(seg_id))?;
+    }
+    rebuild_view(conn)?;
+    Ok(())
+}
+
+/// Live segment ids, oldest first.
+pub(crate) fn live_segments(conn: &Connection) -> Result<Vec<i64>> {
+    let mut stmt = conn.prepare("SELECT seg_id FROM event_segments ORDER BY seg_id ASC")?;
+    let ids = stmt
+        .query_map([], |row| row.get(0))?
+        .collect::<std::result::Result<Vec<i64>, _>>()?;
+    Ok(ids)
+}
+
+/// The segment currently receiving inserts (highest id).
+pub(crate) fn active_segment(conn: &Connection) -> Result<i64> {
+    let id: i64 = conn.query_row(
+        "SELECT COALESCE(MAX(seg_id), 1) FROM event_segments",
+        [],
+        |row| row.get(0),
+    )?;
+    Ok(id)
+}
+
+pub(crate) fn create_segment(conn: &Connection, seg_id: i64) -> Result<()> {
+    let table = segment_table(seg_id);
+    conn.execute(
+        &format!(
+            "CREATE TABLE IF NOT EXISTS {} ({})",
+            table, SEGMENT_COLUMN_DEFS
+        ),
+        [],
+    )?;
+    create_segment_indexes(conn, &table)?;
+    conn.execute(
+        "INSERT OR IGNORE INTO event_segments (seg_id, created_at) VALUES (?, ?)",
+        params![seg_id, chrono::Utc::now().timestamp()],
+    )?;
+    Ok(())
+}
+
+/// Per-segment indexes mirroring the hot paths on the base table; the view
+/// pushes session/type/function/pid/duration predicates into each arm.
+fn create_segment_indexes(conn: &Connection, table: &str) -> Result<()> {
+    conn.execute(
+        &format!(
+            "CREATE INDEX IF NOT EXISTS idx_{0}_session_time ON {0}(session_id, timestamp_ns)",
+            table
+        ),
+        [],
+    )?;
+    conn.execute(
+        &format!(
+            "CREATE INDEX IF NOT EXISTS idx_{0}_type ON {0}(session_id, event_type, timestamp_ns)",
+            table
+        ),
+        [],
+    )?;
+    // function_equals resolves the name to its dictionary id once, then this
+    // index makes the per-row comparison an integer probe.
+    let function_col = if segment_interned(conn, table)? {
+        "function_name_id"
+    } else {
+        "function_name"
+    };
+    conn.execute(
+        &format!(
+            "CREATE INDEX IF NOT EXISTS idx_{0}_function ON {0}({1})",
+            table, function_col
+        ),
+        [],
+    )?;
+    conn.execute(
+        &format!(
+            "CREATE INDEX IF NOT EXISTS idx_{0}_pid_time ON {0}(session_id, pid, timestamp_ns)",
+            table
+        ),
+        [],
+    )?;
+    conn.execute(
+        &format!(
+            "CREATE INDEX IF NOT EXISTS idx_{0}_duration ON {0}(session_id, duration_ns)",
+            table
+        ),
+        [],
+    )?;
+    Ok(())
+}
+
+/// O(1) eviction: unlink the whole segment. Caller must `rebuild_view`
+/// before the next read through `events_all`.
+pub(crate) fn drop_segment(conn: &Connection, seg_id: i64) -> Result<()> {
+    conn.execute(
+        &format!("DROP TABLE IF EXISTS {}", segment_table(seg_id)),
+        [],
+    )?;
+    conn.execute(
+        "DELETE FROM event_segments WHERE seg_id = ?",
+        params![seg_id],
+    )?;
+    Ok(())
+}
+
+/// One `UNION ALL` arm presenting a table in the `EVENT_COLUMNS` shape.
+/// Interned segments join their dictionary ids back to text; the base table
+/// and pre-interning segments pass through as-is.
+fn view_arm(conn: &Connection, table: &str) -> Result<String> {
+    if table != "events" && segment_interned(conn, table)? {
+        Ok(format!(
+            "SELECT s.rowid AS rowid, {} FROM {} s \
+             JOIN event_function_names fn_names ON fn_names.rowid = s.function_name_id \
+             LEFT JOIN event_raw_names raw_names ON raw_names.rowid = s.function_name_raw_id \
+             LEFT JOIN event_source_files src_files ON src_files.rowid = s.source_file_id",
+            INTERNED_VIEW_COLUMNS, table
+        ))
+    } else {
+        Ok(format!(
+            "SELECT rowid AS rowid, {} FROM {}",
+            EVENT_COLUMNS, table
+        ))
+    }
+}
+
+/// Recreate `events_all` as a UNION ALL over the base table and live segments.
+/// Every arm presents the `EVENT_COLUMNS` shape, so read SQL never sees a
+/// dictionary id.
+pub(crate) fn rebuild_view(conn: &Connection) -> Result<()> {
+    let mut arms = vec![view_arm(conn, "events")?];
+    for seg_id in live_segments(conn)? {
+        arms.push(view_arm(conn, &segment_table(seg_id))?);
+    }
+    conn.execute("DROP VIEW IF EXISTS events_all", [])?;
+    conn.execute(
+        &format!("CREATE VIEW events_all AS {}", arms.join(" UNION ALL ")),
+        [],
+    )?;
+    Ok(())
+}
+
+/// Inclusive `timestamp_ns` bounds of a session's rows in one table, or `None`
+/// when the session has none there. Each bound is a single descent of the
+/// table's `(session_id, timestamp_ns)` index — SQLite's min/max optimization
+/// applies per table, but not through the flattened `events_all` view, which
+/// is why callers probe tables individually.
+pub(crate) fn table_time_bounds(
+    conn: &Connection,
+    table: &str,
+    session_id: &str,
+) -> Result<Option<(i64, i64)>> {
+    let min_ts: Option<i64> = conn.query_row(
+        &format!(
+            "SELECT MIN(timestamp_ns) FROM {} WHERE session_id = ?",
+            table
+        ),
+        params![session_id],
+        |row| row.get(0),
+    )?;
+    let max_ts: Option<i64> = conn.query_row(
+        &format!(
+            "SELECT MAX(timestamp_ns) FROM {} WHERE session_id = ?",
+            table
+        ),
+        params![session_id],
+        |row| row.get(0),
+    )?;
+    Ok(min_ts.zip(max_ts))
+}
+
+/// A FROM-clause source equivalent to `events_all`, but containing only the
+/// arms whose timestamp bounds overlap `[from, to]` for this session. Segments
+/// fill in rough timestamp order, so a narrow window typically keeps one or
+/// two arms and the query never touches the rest of the timeline. The bounds
+/// probes are index descents, cheap relative to scanning a skipped segment.
+pub(crate) fn pruned_union_sql(
+    conn: &Connection,
+    session_id: &str,
+    from: Option<i64>,
+    to: Option<i64>,
+) -> Result<String> {
+    let mut tables = vec!["events".to_string()];
+    tables.extend(live_segments(conn)?.into_iter().map(segment_table));
+
+    let mut arms = Vec::new();
+    for table in tables {
+        match table_time_bounds(conn, &table, session_id)? {
+            Some((min_ts, max_ts)) => {
+                let before_window = from.is_some_and(|f| max_ts < f);
+                let after_window = to.is_some_and(|t| min_ts > t);
+                if !before_window && !after_window {
+                    arms.push(view_arm(conn, &table)?);
+                }
+            }
+            None => {} // no rows for this session here
+        }
+    }
+    if arms.is_empty() {
+        // No table overlaps the window; keep the surrounding SQL valid.
+        arms.push(format!(
+            "SELECT rowid AS rowid, {} FROM events WHERE 0",
+            EVENT_COLUMNS
+        ));
+    }
+    Ok(format!("({})", arms.join(" UNION ALL ")))
+}
+
+/// Reserve `n` consecutive rowids from the global sequence; returns the first.
+/// Callers hold the connection lock, so read-then-bump is race-free.
+pub(crate) fn allocate_rowids(conn: &Connection, n: usize) -> Result<i64> {
+    let first: i64 = conn.query_row(
+        "SELECT next_rowid FROM event_rowid_seq WHERE id = 1",
+        [],
+        |row| row.get(0),
+    )?;
+    conn.execute(
+        "UPDATE event_rowid_seq SET next_rowid = next_rowid + ? WHERE id = 1",
+        params![n as i64],
+    )?;
+    Ok(first)
+}
+
+pub(crate) fn segment_row_count(conn: &Connection, seg_id: i64) -> Result<i64> {
+    let count: i64 = conn.query_row(
+        &format!("SELECT COUNT(*) FROM {}", segment_table(seg_id)),
+        [],
+        |row| row.get(0),
+    )?;
+    Ok(count)
+}
+
+/// Rotate to a fresh segment once the active one reaches capacity.
+pub(crate) fn rotate_if_full(conn: &Connection, capacity: usize) -> Result<bool> {
+    let active = active_segment(conn)?;
+    if segment_row_count(conn, active)? < capacity as i64 {
+        return Ok(false);
+    }
+    create_segment(conn, active + 1)?;
+    rebuild_view(conn)?;
+    Ok(true)
+}
+
+/// Delete specific event ids from one table, chunked to stay under SQLite's
+/// bound-parameter limit. Returns the number of rows actually deleted (ids
+/// living in other tables are simply not matched).
+pub(crate) fn delete_ids(
+    conn: &Connection,
+    table: &str,
+    session_id: &str,
+    ids: &[String],
+) -> Result<usize> {
+    let mut deleted = 0;
+    for chunk in ids.chunks(500) {
+        let placeholders = vec!["?"; chunk.len()].join(", ");
+        let sql = format!(
+            "DELETE FROM {} WHERE session_id = ? AND id IN ({})",
+            table, placeholders
+        );
+        let mut params_vec: Vec<&dyn rusqlite::ToSql> = vec![&session_id];
+        for id in chunk {
+            params_vec.push(id);
+        }
+        deleted += conn.execute(&sql, params_vec.as_slice())?;
+    }
+    Ok(deleted)
+}
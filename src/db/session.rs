@@ -196,9 +196,67 @@ impl Database {
         Ok(())
     }
 
+    /// Copy a session row into a per-session database so its events foreign
+    /// key resolves there. Synthesizes a minimal row when the shared database
+    /// no longer has one (e.g. a straggler batch after delete).
+    pub(crate) fn mirror_session_row(&self, id: &str, session: Option<Session>) -> Result<()> {
+        let conn = self.connection();
+        match session {
+            Some(s) => conn.execute(
+                "INSERT OR IGNORE INTO sessions (id, binary_path, project_root, pid, started_at, ended_at, status)
+                 VALUES (?, ?, ?, ?, ?, ?, ?)",
+                params![
+                    s.id,
+                    s.binary_path,
+                    s.project_root,
+                    s.pid,
+                    s.started_at,
+                    s.ended_at,
+                    s.status.as_str()
+                ],
+            )?,
+            None => conn.execute(
+                "INSERT OR IGNORE INTO sessions (id, binary_path, project_root, pid, started_at, status)
+                 VALUES (?, '', '', 0, ?, 'running')",
+                params![id, chrono::Utc::now().timestamp()],
+            )?,
+        };
+        Ok(())
+    }
+
     pub fn delete_session(&self, id: &str) -> Result<()> {
+        // Per-session storage: the session's events are one file, so this
+        // unlink replaces every per-row delete below. The shared-table sweep
+        // still runs to cover rows left behind by a pre-migration daemon.
+        self.remove_session_db(id)?;
+        // The output ring file (and its metadata here) goes with the session.
+        self.remove_output_ring(id)?;
+
         let conn = self.connection();
+        super::output_ring::delete_session(&conn, id)?;
+        super::checkpoint::delete(&conn, id)?;
         conn.execute("DELETE FROM events WHERE session_id = ?", params![id])?;
+        for seg_id in super::segments::live_segments(&conn)? {
+            conn.execute(
+                &format!(
+                    "DELETE FROM {} WHERE session_id = ?",
+                    super::segments::segment_table(seg_id)
+                ),
+                params![id],
+            )?;
+        }
+        // Reclaim any non-active segments this left empty.
+        let active = super::segments::active_segment(&conn)?;
+        let mut dropped = false;
+        for seg_id in super::segments::live_segments(&conn)? {
+            if seg_id != active && super::segments::segment_row_count(&conn, seg_id)? == 0 {
+                super::segments::drop_segment(&conn, seg_id)?;
+                dropped = true;
+            }
+        }
+        if dropped {
+            super::segments::rebuild_view(&conn)?;
+        }
         conn.execute("DELETE FROM sessions WHERE id = ?", params![id])?;
         Ok(())
     }
@@ -208,10 +266,26 @@ impl Database {
     }
 
     pub fn mark_session_retained(&self, id: &str) -> Result<()> {
-        let conn = self.connection();
         let retained_at = chrono::Utc::now().timestamp();
 
-        // Calculate session size (includes all text/JSON columns for accuracy)
+        let size = match self.existing_events_db(id)? {
+            Some(db) => db.session_events_size(id)?,
+            None => self.session_events_size(id)?,
+        };
+
+        let conn = self.connection();
+        conn.execute(
+            "UPDATE sessions SET retained_at = ?, size_bytes = ? WHERE id = ?",
+            params![retained_at, size, id],
+        )?;
+
+        Ok(())
+    }
+
+    /// Approximate on-disk size of a session's events (all text/JSON columns
+    /// plus per-row overhead).
+    fn session_events_size(&self, id: &str) -> Result<i64> {
+        let conn = self.connection();
         let size: i64 = conn.query_row(
             "SELECT COALESCE(SUM(
                 LENGTH(id) + LENGTH(session_id) + LENGTH(COALESCE(function_name,''))
@@ -222,17 +296,11 @@ impl Database {
                 + LENGTH(COALESCE(fault_address,'')) + LENGTH(COALESCE(registers,''))
                 + LENGTH(COALESCE(backtrace,'')) + LENGTH(COALESCE(locals,''))
                 + 100
-            ), 0) FROM events WHERE session_id = ?",
+            ), 0) FROM events_all WHERE session_id = ?",
             params![id],
             |row| row.get(0),
         )?;
-
-        conn.execute(
-            "UPDATE sessions SET retained_at = ?, size_bytes = ? WHERE id = ?",
-            params![retained_at, size, id],
-        )?;
-
-        Ok(())
+        Ok(size)
     }
 
     pub fn list_retained_sessions(&self) -> Result<Vec<Session>> {
@@ -268,6 +336,8 @@ impl Database {
             .query_map([], |row| Ok((row.get(0)?, row.get(1)?)))?
             .collect::<std::result::Result<Vec<_>, _>>()?;
         drop(stmt);
+        // Release the connection before delete_session re-acquires it.
+        drop(conn);
 
         let mut remaining = total;
         for (session_id, size) in sessions {
@@ -0,0 +1,326 @@
+//! Persistent on-disk cache for parsed DWARF indexes.
+//!
+//! Parsing a large debug binary can take tens of seconds, and the in-memory
+//! cache in `SessionManager` dies with the daemon (30min idle timeout). This
+//! module snapshots the expensive parse output — function/variable tables and
+//! lazy struct offsets — to a file under `~/.strobe/dwarf-cache/`, keyed by
+//! binary path + mtime + size, so a warm daemon restart rehydrates the index
+//! from an mmap'd file instead of re-walking every compilation unit.
+//!
+//! The cheap derived indexes (name maps, sorted address table) are rebuilt at
+//! load time; line rows (per-CU, via the cached offsets) and struct member
+//! layouts stay lazy as before, re-reading the DWARF file on demand.
+//! Everything here is best-effort: any I/O or format problem is a cache
+//! miss, never an error.
+
+use super::parser::{CuLineInfo, DwarfParser};
+use super::{FunctionInfo, VariableInfo};
+use memmap2::Mmap;
+use serde::{Deserialize, Serialize};
+use std::collections::hash_map::DefaultHasher;
+use std::collections::HashMap;
+use std::fs::File;
+use std::hash::{Hash, Hasher};
+use std::path::{Path, PathBuf};
+
+/// Bump when the on-disk layout or the cached structs change shape.
+/// Old-version files are treated as misses and overwritten.
+const CACHE_FORMAT_VERSION: u32 = 2;
+
+/// Serialized snapshot of a completed DWARF parse.
+#[derive(Serialize, Deserialize)]
+struct CacheFile {
+    version: u32,
+    /// Identity of the binary the parse was keyed on (the target executable,
+    /// not necessarily the file containing DWARF).
+    binary_path: String,
+    binary_mtime_secs: u64,
+    binary_size: u64,
+    /// Explicit symbols path the parse was performed with, if any.
+    symbols_path: Option<String>,
+    /// The file the DWARF sections were actually read from (binary itself,
+    /// or the dSYM inner file on macOS). Lazy line-table / struct-member
+    /// resolution re-opens this path, so it must still exist on load.
+    dwarf_file_path: String,
+    image_base: u64,
+    functions: Vec<FunctionInfo>,
+    variables: Vec<VariableInfo>,
+    lazy_struct_info: HashMap<String, (usize, usize)>,
+    /// Per-CU line-program offsets and file tables, so a rehydrated parser
+    /// keeps decoding line rows lazily per CU instead of all at once.
+    cu_line_info: Vec<CuLineInfo>,
+}
+
+/// (mtime seconds, size) of a file, or None if it can't be stat'd.
+fn file_identity(path: &Path) -> Option<(u64, u64)> {
+    let meta = std::fs::metadata(path).ok()?;
+    let mtime = meta
+        .modified()
+        .ok()?
+        .duration_since(std::time::UNIX_EPOCH)
+        .ok()?
+        .as_secs();
+    Some((mtime, meta.len()))
+}
+
+fn default_cache_dir() -> Option<PathBuf> {
+    dirs::home_dir().map(|h| h.join(".strobe").join("dwarf-cache"))
+}
+
+/// Cache file path for a binary. The name combines the binary's file stem
+/// (for human inspection of the cache dir) with a hash of the full path and
+/// symbols override, so distinct binaries with the same name don't collide.
+fn cache_path(dir: &Path, binary_path: &Path, symbols_path: Option<&Path>) -> PathBuf {
+    let mut hasher = DefaultHasher::new();
+    binary_path.hash(&mut hasher);
+    symbols_path.hash(&mut hasher);
+    let stem = binary_path
+        .file_stem()
+        .map(|s| s.to_string_lossy().into_owned())
+        .unwrap_or_else(|| "binary".to_string());
+    dir.join(format!("{}-{:016x}.json", stem, hasher.finish()))
+}
+
+/// Try to rehydrate a parser from the default cache directory.
+/// Returns None on any miss: no cache file, stale binary, version mismatch,
+/// or a dwarf file that no longer exists.
+pub fn load(binary_path: &Path, symbols_path: Option<&Path>) -> Option<DwarfParser> {
+    load_from_dir(&default_cache_dir()?, binary_path, symbols_path)
+}
+
+/// Best-effort snapshot of a completed parse to the default cache directory.
+pub fn store(parser: &DwarfParser, binary_path: &Path, symbols_path: Option<&Path>) {
+    if let Some(dir) = default_cache_dir() {
+        store_in_dir(&dir, parser, binary_path, symbols_path);
+    }
+}
+
+fn load_from_dir(
+    dir: &Path,
+    binary_path: &Path,
+    symbols_path: Option<&Path>,
+) -> Option<DwarfParser> {
+    let path = cache_path(dir, binary_path, symbols_path);
+    let file = File::open(&path).ok()?;
+    // mmap instead of read_to_string: the kernel pages the file in on demand
+    // and serde_json deserializes straight out of the mapping.
+    let mmap = unsafe { Mmap::map(&file) }.ok()?;
+    let cached: CacheFile = serde_json::from_slice(&mmap).ok()?;
+
+    if cached.version != CACHE_FORMAT_VERSION {
+        return None;
+    }
+    if cached.binary_path != binary_path.to_string_lossy() {
+        return None;
+    }
+    let (mtime, size) = file_identity(binary_path)?;
+    if cached.binary_mtime_secs != mtime || cached.binary_size != size {
+        return None;
+    }
+    if cached.symbols_path.as_deref() != symbols_path.map(|p| p.to_string_lossy()).as_deref() {
+        return None;
+    }
+    // Lazy resolution re-opens the dwarf file — a vanished dSYM means the
+    // snapshot is unusable even if the binary itself is unchanged.
+    let dwarf_file = PathBuf::from(&cached.dwarf_file_path);
+    if !dwarf_file.exists() {
+        return None;
+    }
+
+    tracing::info!(
+        "DWARF cache hit for {} ({} functions, {} variables)",
+        binary_path.display(),
+        cached.functions.len(),
+        cached.variables.len()
+    );
+
+    Some(DwarfParser::from_parts(
+        cached.functions,
+        cached.variables,
+        cached.lazy_struct_info,
+        cached.cu_line_info,
+        cached.image_base,
+        Some(dwarf_file),
+    ))
+}
+
+fn store_in_dir(dir: &Path, parser: &DwarfParser, binary_path: &Path, symbols_path: Option<&Path>) {
+    // Nothing worth caching without a dwarf file to lazy-resolve against.
+    let dwarf_file = match &parser.binary_path {
+        Some(p) => p.clone(),
+        None => return,
+    };
+    let Some((mtime, size)) = file_identity(binary_path) else {
+        return;
+    };
+    if std::fs::create_dir_all(dir).is_err() {
+        return;
+    }
+
+    let cached = CacheFile {
+        version: CACHE_FORMAT_VERSION,
+        binary_path: binary_path.to_string_lossy().into_owned(),
+        binary_mtime_secs: mtime,
+        binary_size: size,
+        symbols_path: symbols_path.map(|p| p.to_string_lossy().into_owned()),
+        dwarf_file_path: dwarf_file.to_string_lossy().into_owned(),
+        image_base: parser.image_base,
+        functions: parser.functions.clone(),
+        variables: parser.variables.clone(),
+        lazy_struct_info: parser.lazy_struct_info.clone(),
+        cu_line_info: parser.cu_line_info.clone(),
+    };
+
+    let path = cache_path(dir, binary_path, symbols_path);
+    // Write to a temp file and rename so a crashed daemon never leaves a
+    // truncated cache for the next one to choke on.
+    let tmp = path.with_extension("json.tmp");
+    let Ok(bytes) = serde_json::to_vec(&cached) else {
+        return;
+    };
+    if std::fs::write(&tmp, &bytes).is_ok() {
+        if std::fs::rename(&tmp, &path).is_ok() {
+            tracing::debug!(
+                "Cached DWARF index for {} ({} bytes)",
+                binary_path.display(),
+                bytes.len()
+            );
+        } else {
+            let _ = std::fs::remove_file(&tmp);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::dwarf::TypeKind;
+    use tempfile::tempdir;
+
+    fn make_parser(dwarf_file: PathBuf) -> DwarfParser {
+        let functions = vec![
+            FunctionInfo {
+                name: "audio::process".to_string(),
+                name_raw: Some("_ZN5audio7processEv".to_string()),
+                low_pc: 0x1000,
+                high_pc: 0x1100,
+                source_file: Some("/src/audio.cpp".to_string()),
+                line_number: Some(42),
+            },
+            FunctionInfo {
+                name: "midi::note_on".to_string(),
+                name_raw: None,
+                low_pc: 0x2000,
+                high_pc: 0x2080,
+                source_file: None,
+                line_number: None,
+            },
+        ];
+        let variables = vec![VariableInfo {
+            name: "gCounter".to_string(),
+            name_raw: None,
+            short_name: Some("gCounter".to_string()),
+            address: 0x5000,
+            byte_size: 4,
+            type_name: Some("uint32_t".to_string()),
+            type_kind: TypeKind::Integer { signed: false },
+            source_file: None,
+        }];
+        let mut lazy = HashMap::new();
+        lazy.insert("gClock".to_string(), (0x40usize, 0x80usize));
+        let cu_line_info = vec![CuLineInfo {
+            debug_info_offset: 0x0b,
+            low_pc: 0x1000,
+            high_pc: 0x2080,
+            files: vec!["/src/audio.cpp".to_string()],
+        }];
+        DwarfParser::from_parts(
+            functions,
+            variables,
+            lazy,
+            cu_line_info,
+            0x100000,
+            Some(dwarf_file),
+        )
+    }
+
+    /// Create a fake "binary" file so file_identity has something to stat.
+    fn make_binary(dir: &Path) -> PathBuf {
+        let path = dir.join("target_app");
+        std::fs::write(&path, b"not really a binary").unwrap();
+        path
+    }
+
+    #[test]
+    fn test_round_trip() {
+        let dir = tempdir().unwrap();
+        let binary = make_binary(dir.path());
+        let cache_dir = dir.path().join("cache");
+        let parser = make_parser(binary.clone());
+
+        store_in_dir(&cache_dir, &parser, &binary, None);
+        let loaded = load_from_dir(&cache_dir, &binary, None).expect("cache hit expected");
+
+        assert_eq!(loaded.functions.len(), 2);
+        assert_eq!(loaded.functions[0].name, "audio::process");
+        assert_eq!(loaded.variables.len(), 1);
+        assert_eq!(loaded.image_base, 0x100000);
+        // Derived indexes must be rebuilt, not just the raw tables
+        assert_eq!(loaded.find_by_name("midi::note_on").len(), 1);
+        assert!(loaded.find_variable_by_name("gCounter").is_some());
+        assert_eq!(loaded.lazy_struct_info.get("gClock"), Some(&(0x40, 0x80)));
+        // Per-CU line metadata must survive so line decoding stays lazy per CU
+        assert_eq!(loaded.cu_line_info.len(), 1);
+        assert_eq!(loaded.cu_line_info[0].debug_info_offset, 0x0b);
+        assert_eq!(loaded.cu_line_info[0].files, vec!["/src/audio.cpp"]);
+    }
+
+    #[test]
+    fn test_stale_binary_is_a_miss() {
+        let dir = tempdir().unwrap();
+        let binary = make_binary(dir.path());
+        let cache_dir = dir.path().join("cache");
+        let parser = make_parser(binary.clone());
+        store_in_dir(&cache_dir, &parser, &binary, None);
+
+        // Rebuilding the binary (different size → different identity) invalidates
+        std::fs::write(&binary, b"recompiled with more bytes than before").unwrap();
+        assert!(load_from_dir(&cache_dir, &binary, None).is_none());
+    }
+
+    #[test]
+    fn test_symbols_path_is_part_of_key() {
+        let dir = tempdir().unwrap();
+        let binary = make_binary(dir.path());
+        let cache_dir = dir.path().join("cache");
+        let parser = make_parser(binary.clone());
+        store_in_dir(&cache_dir, &parser, &binary, None);
+
+        // Same binary, explicit symbols override — must not hit the no-symbols entry
+        let sym = dir.path().join("app.dSYM");
+        assert!(load_from_dir(&cache_dir, &binary, Some(&sym)).is_none());
+    }
+
+    #[test]
+    fn test_missing_dwarf_file_is_a_miss() {
+        let dir = tempdir().unwrap();
+        let binary = make_binary(dir.path());
+        let cache_dir = dir.path().join("cache");
+        // Parser claims DWARF came from a file that no longer exists
+        let parser = make_parser(dir.path().join("vanished.dSYM"));
+        store_in_dir(&cache_dir, &parser, &binary, None);
+
+        assert!(load_from_dir(&cache_dir, &binary, None).is_none());
+    }
+
+    #[test]
+    fn test_corrupt_cache_file_is_a_miss() {
+        let dir = tempdir().unwrap();
+        let binary = make_binary(dir.path());
+        let cache_dir = dir.path().join("cache");
+        std::fs::create_dir_all(&cache_dir).unwrap();
+        std::fs::write(cache_path(&cache_dir, &binary, None), b"truncated {").unwrap();
+
+        assert!(load_from_dir(&cache_dir, &binary, None).is_none());
+    }
+}
@@ -89,11 +89,14 @@ mod tests {
             functions: vec![],
             functions_by_name: std::collections::HashMap::new(),
             functions_by_addr: vec![],
+            symbol_index: crate::dwarf::parser::SymbolIndex::build(&[]),
             variables: vec![],
             variables_by_name: std::collections::HashMap::new(),
             struct_members: std::sync::Mutex::new(std::collections::HashMap::new()),
             lazy_struct_info: std::collections::HashMap::new(),
-            line_table: std::sync::Mutex::new(None),
+            cu_line_info: vec![],
+            line_table: std::sync::Mutex::new(Default::default()),
+            locals_cache: std::sync::Mutex::new(std::collections::HashMap::new()),
             image_base: 0x100000,
             binary_path: None,
         })
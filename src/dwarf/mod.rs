@@ -1,3 +1,4 @@
+mod cache;
 mod function;
 mod handle;
 mod parser;
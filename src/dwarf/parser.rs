@@ -137,6 +137,30 @@ pub struct LineEntry {
     pub is_statement: bool,
 }
 
+/// Per-CU line-program metadata recorded during the initial parallel CU walk.
+/// Line rows are only decoded lazily, one CU at a time, when a resolution
+/// query actually touches that CU's files or address range.
+#[derive(Debug, Clone, serde::Serialize, serde::Deserialize)]
+pub(crate) struct CuLineInfo {
+    /// Absolute `.debug_info` offset — used to re-find the CU on demand.
+    pub debug_info_offset: usize,
+    /// Address span of the CU's functions (0/0 when it contributes no code).
+    pub low_pc: u64,
+    pub high_pc: u64,
+    /// Full paths from the CU's line-program file table.
+    pub files: Vec<String>,
+}
+
+/// Lazily accumulated line table: rows merged from the CUs decoded so far,
+/// kept sorted by address for binary search.
+#[derive(Default)]
+pub(crate) struct LineTableState {
+    entries: Vec<LineEntry>,
+    parsed_cus: std::collections::HashSet<usize>,
+    /// Every CU decoded — no further ensure call has work to do.
+    all_parsed: bool,
+}
+
 #[derive(Debug, Clone)]
 pub(crate) struct StructMember {
     pub name: String,
@@ -148,11 +172,61 @@ pub(crate) struct StructMember {
     pub pointed_struct_members: Option<Vec<StructMember>>,
 }
 
+/// Sorted-name symbol index backing glob pattern queries.
+///
+/// `find_by_pattern` used to scan the full function table per call, which
+/// against multi-million-symbol binaries costs seconds — and `debug_trace`
+/// issues several such queries. Patterns almost always carry a literal run
+/// before the first wildcard (`juce::Audio**`), so a table of (name, function
+/// index) pairs sorted by name turns the query into a binary search for the
+/// prefix range followed by glob matching within it — the trie-traversal
+/// shape without a trie. Both demangled and raw mangled names are indexed;
+/// patterns opening with a wildcard still fall back to the full scan.
+pub(crate) struct SymbolIndex {
+    sorted: Vec<(String, usize)>,
+}
+
+impl SymbolIndex {
+    pub(crate) fn build(functions: &[FunctionInfo]) -> Self {
+        let mut sorted: Vec<(String, usize)> = Vec::with_capacity(functions.len());
+        for (idx, func) in functions.iter().enumerate() {
+            sorted.push((func.name.clone(), idx));
+            if let Some(ref raw) = func.name_raw {
+                if raw != &func.name {
+                    sorted.push((raw.clone(), idx));
+                }
+            }
+        }
+        sorted.sort_unstable_by(|a, b| a.0.cmp(&b.0));
+        Self { sorted }
+    }
+
+    /// Longest literal run before the first wildcard. Empty means the pattern
+    /// cannot be prefix-pruned and the caller must scan the full table.
+    pub(crate) fn literal_prefix(pattern: &str) -> &str {
+        match pattern.find('*') {
+            Some(i) => &pattern[..i],
+            None => pattern,
+        }
+    }
+
+    /// All (name, function index) entries whose name starts with `prefix`,
+    /// located by binary search. Entries sharing a function index can appear
+    /// twice (demangled + mangled) — callers dedup.
+    pub(crate) fn prefix_range(&self, prefix: &str) -> &[(String, usize)] {
+        let start = self.sorted.partition_point(|(n, _)| n.as_str() < prefix);
+        let len = self.sorted[start..].partition_point(|(n, _)| n.starts_with(prefix));
+        &self.sorted[start..start + len]
+    }
+}
+
 pub struct DwarfParser {
     pub functions: Vec<FunctionInfo>,
     pub(crate) functions_by_name: HashMap<String, Vec<usize>>,
     /// Sorted by low_pc for binary search in address-to-function lookups.
-    pub(crate) functions_by_addr: Vec<(u64, u64)>, // (low_pc, high_pc)
+    pub(crate) functions_by_addr: Vec<(u64, u64, usize)>, // (low_pc, high_pc, functions index)
+    /// Sorted by name for prefix-pruned glob pattern queries.
+    pub(crate) symbol_index: SymbolIndex,
     pub variables: Vec<VariableInfo>,
     pub(crate) variables_by_name: HashMap<String, Vec<usize>>,
     /// Cache of lazily-resolved struct member layouts for pointer variables.
@@ -166,8 +240,17 @@ pub struct DwarfParser {
     pub image_base: u64,
     /// Path to the binary (or dSYM) for re-parsing on demand (e.g., crash locals)
     pub(crate) binary_path: Option<std::path::PathBuf>,
-    /// Parsed line table entries, sorted by address. Lazily populated on first line query.
-    pub(crate) line_table: Mutex<Option<Vec<LineEntry>>>,
+    /// Per-CU line-program offsets and file tables from the initial CU walk.
+    /// Empty for parsers rehydrated without this metadata — those fall back
+    /// to decoding every CU on the first line query.
+    pub(crate) cu_line_info: Vec<CuLineInfo>,
+    /// Line rows decoded so far, per-CU lazily on first resolution request.
+    pub(crate) line_table: Mutex<LineTableState>,
+    /// Locals resolved at a crash/breakpoint stop, cached by the containing
+    /// function's (low_pc, high_pc) range. The first stop in a function pays
+    /// the targeted DWARF re-walk; later stops in the same function resolve
+    /// from here.
+    pub(crate) locals_cache: Mutex<HashMap<(u64, u64), Vec<LocalVariableInfo>>>,
 }
 
 impl DwarfParser {
@@ -183,6 +266,22 @@ impl DwarfParser {
         binary_path: &Path,
         search_root: Option<&Path>,
         symbols_path: Option<&Path>,
+    ) -> Result<Self> {
+        // Warm path: rehydrate a previous parse from the on-disk cache
+        // (keyed by binary path + mtime + size, see dwarf::cache).
+        if let Some(parser) = super::cache::load(binary_path, symbols_path) {
+            return Ok(parser);
+        }
+
+        let parser = Self::parse_with_options_uncached(binary_path, search_root, symbols_path)?;
+        super::cache::store(&parser, binary_path, symbols_path);
+        Ok(parser)
+    }
+
+    fn parse_with_options_uncached(
+        binary_path: &Path,
+        search_root: Option<&Path>,
+        symbols_path: Option<&Path>,
     ) -> Result<Self> {
         // Extract image base from the original binary (needed for ASLR adjustment)
         let image_base = Self::extract_image_base(binary_path).unwrap_or(0);
@@ -409,6 +508,11 @@ impl DwarfParser {
                     gimli::UnitSectionOffset::DebugInfoOffset(o) => o.0,
                     gimli::UnitSectionOffset::DebugTypesOffset(o) => o.0,
                 };
+                // Only .debug_info CUs can carry a line program we re-find later
+                let debug_info_offset = match unit.header.offset() {
+                    gimli::UnitSectionOffset::DebugInfoOffset(o) => Some(o.0),
+                    _ => None,
+                };
                 let mut functions = Vec::new();
                 let mut variables = Vec::new();
                 let mut lazy_infos: Vec<(String, (usize, usize))> = Vec::new();
@@ -551,7 +655,42 @@ impl DwarfParser {
                     }
                 }
 
-                Some((functions, variables, lazy_infos, declarations, unresolved))
+                // Record line-program metadata for lazy per-CU row decoding.
+                // The header (file table) is already parsed as part of the
+                // unit; only row execution is deferred.
+                let cu_line = debug_info_offset.and_then(|offset| {
+                    let files = Self::collect_line_files(&dwarf, &unit);
+                    if files.is_empty() {
+                        return None;
+                    }
+                    let mut low = u64::MAX;
+                    let mut high = 0u64;
+                    for f in &functions {
+                        if f.low_pc > 0 {
+                            low = low.min(f.low_pc);
+                            high = high.max(f.high_pc);
+                        }
+                    }
+                    for u in &unresolved {
+                        low = low.min(u.low_pc);
+                        high = high.max(u.high_pc);
+                    }
+                    Some(CuLineInfo {
+                        debug_info_offset: offset,
+                        low_pc: if low == u64::MAX { 0 } else { low },
+                        high_pc: high,
+                        files,
+                    })
+                });
+
+                Some((
+                    functions,
+                    variables,
+                    lazy_infos,
+                    declarations,
+                    unresolved,
+                    cu_line,
+                ))
             })
             .collect();
 
@@ -561,12 +700,14 @@ impl DwarfParser {
         let mut lazy_struct_info = HashMap::new();
         let mut declaration_map: HashMap<usize, String> = HashMap::new();
         let mut all_unresolved: Vec<UnresolvedFunc> = Vec::new();
-        for (funcs, vars, infos, decls, unres) in results {
+        let mut cu_line_info: Vec<CuLineInfo> = Vec::new();
+        for (funcs, vars, infos, decls, unres, cu_line) in results {
             functions.extend(funcs);
             variables.extend(vars);
             lazy_struct_info.extend(infos);
             declaration_map.extend(decls);
             all_unresolved.extend(unres);
+            cu_line_info.extend(cu_line);
         }
 
         // Resolve cross-CU function references: match unresolved functions
@@ -597,7 +738,29 @@ impl DwarfParser {
             }
         }
 
-        // Build indexes
+        // image_base is set by parse() from the actual binary
+        Ok(Self::from_parts(
+            functions,
+            variables,
+            lazy_struct_info,
+            cu_line_info,
+            0,
+            Some(path.to_path_buf()),
+        ))
+    }
+
+    /// Assemble a parser from its raw tables, rebuilding the derived indexes
+    /// (name maps, sorted address table). Used after a fresh CU walk and when
+    /// rehydrating from the on-disk cache — index building is cheap relative
+    /// to parsing, so the cache only stores the raw tables.
+    pub(crate) fn from_parts(
+        functions: Vec<FunctionInfo>,
+        variables: Vec<VariableInfo>,
+        lazy_struct_info: HashMap<String, (usize, usize)>,
+        cu_line_info: Vec<CuLineInfo>,
+        image_base: u64,
+        binary_path: Option<std::path::PathBuf>,
+    ) -> Self {
         let mut functions_by_name: HashMap<String, Vec<usize>> = HashMap::new();
         for (idx, func) in functions.iter().enumerate() {
             functions_by_name
@@ -623,25 +786,31 @@ impl DwarfParser {
         }
 
         // Build sorted address index for O(log N) address-to-function lookups
-        let mut functions_by_addr: Vec<(u64, u64)> = functions
+        let mut functions_by_addr: Vec<(u64, u64, usize)> = functions
             .iter()
-            .filter(|f| f.low_pc > 0 && f.high_pc > f.low_pc)
-            .map(|f| (f.low_pc, f.high_pc))
+            .enumerate()
+            .filter(|(_, f)| f.low_pc > 0 && f.high_pc > f.low_pc)
+            .map(|(idx, f)| (f.low_pc, f.high_pc, idx))
             .collect();
-        functions_by_addr.sort_unstable_by_key(|&(low, _)| low);
+        functions_by_addr.sort_unstable_by_key(|&(low, _, _)| low);
 
-        Ok(Self {
+        let symbol_index = SymbolIndex::build(&functions);
+
+        Self {
             functions,
             functions_by_name,
             functions_by_addr,
+            symbol_index,
             variables,
             variables_by_name,
             struct_members: Mutex::new(HashMap::new()),
             lazy_struct_info,
-            image_base: 0, // Set by parse() from the actual binary
-            binary_path: Some(path.to_path_buf()),
-            line_table: Mutex::new(None),
-        })
+            image_base,
+            binary_path,
+            cu_line_info,
+            line_table: Mutex::new(LineTableState::default()),
+            locals_cache: Mutex::new(HashMap::new()),
+        }
     }
 
     /// Resolve a string attribute from an entry, handling DWARF v4/v5 string forms.
@@ -1078,6 +1247,34 @@ impl DwarfParser {
         }
     }
 
+    /// All full paths in a CU's line-program file table. Reads only the
+    /// already-parsed header — row execution stays deferred.
+    fn collect_line_files<R: gimli::Reader>(
+        dwarf: &gimli::Dwarf<R>,
+        unit: &gimli::Unit<R>,
+    ) -> Vec<String> {
+        let mut files = Vec::new();
+        if let Some(line_program) = &unit.line_program {
+            let header = line_program.header();
+            for file in header.file_names() {
+                let mut path = String::new();
+                if let Some(dir) = file.directory(header) {
+                    if let Ok(s) = dwarf.attr_string(unit, dir) {
+                        path.push_str(&s.to_string_lossy().unwrap_or_default());
+                        path.push('/');
+                    }
+                }
+                if let Ok(s) = dwarf.attr_string(unit, file.path_name()) {
+                    path.push_str(&s.to_string_lossy().unwrap_or_default());
+                }
+                if !path.is_empty() {
+                    files.push(path);
+                }
+            }
+        }
+        files
+    }
+
     /// Follow type chain (through typedefs, const, volatile) to find a struct/class
     /// and parse its members.
     fn parse_struct_members_from_type<R: gimli::Reader>(
@@ -1421,10 +1618,32 @@ impl DwarfParser {
 
     pub fn find_by_pattern(&self, pattern: &str) -> Vec<&FunctionInfo> {
         let matcher = PatternMatcher::new(pattern);
-        self.functions
+
+        // Prefix-pruned path: any matching name must start with the pattern's
+        // literal prefix (glob matching is char-by-char until the first
+        // wildcard, and C++ parameter stripping only shortens a name), so the
+        // sorted index narrows the candidate set before the glob runs.
+        let prefix = SymbolIndex::literal_prefix(pattern);
+        if prefix.is_empty() {
+            // Leading wildcard — nothing to prune on
+            return self
+                .functions
+                .iter()
+                .filter(|f| matcher.matches(&f.name))
+                .collect();
+        }
+
+        let mut indices: Vec<usize> = self
+            .symbol_index
+            .prefix_range(prefix)
             .iter()
-            .filter(|f| matcher.matches(&f.name))
-            .collect()
+            .filter(|&&(_, idx)| matcher.matches(&self.functions[idx].name))
+            .map(|&(_, idx)| idx)
+            .collect();
+        // Restore table order and drop demangled/mangled duplicates
+        indices.sort_unstable();
+        indices.dedup();
+        indices.into_iter().map(|i| &self.functions[i]).collect()
     }
 
     pub fn user_code_functions(&self, project_root: &str) -> Vec<&FunctionInfo> {
@@ -1448,8 +1667,34 @@ impl DwarfParser {
     }
 
     /// Parse local variables for the function containing the given PC address.
-    /// Re-opens the DWARF file and does a targeted parse. Only called on crash (rare).
+    /// The first stop in a function re-opens the DWARF file for a targeted
+    /// parse; the result is cached by function range, so repeated crash or
+    /// breakpoint stops in the same function skip the re-walk entirely.
     pub fn parse_locals_at_pc(&self, crash_pc: u64) -> Result<Vec<LocalVariableInfo>> {
+        let func_range = self.function_containing(crash_pc);
+        if let Some(range) = func_range {
+            if let Some(cached) = self.locals_cache.lock().unwrap().get(&range) {
+                return Ok(cached.clone());
+            }
+        }
+
+        let locals = self.parse_locals_at_pc_uncached(crash_pc)?;
+
+        if let Some(range) = func_range {
+            // Empty results are cached too — a function with no recoverable
+            // locals shouldn't pay the re-walk on every stop.
+            self.locals_cache
+                .lock()
+                .unwrap()
+                .insert(range, locals.clone());
+        }
+        Ok(locals)
+    }
+
+    /// The slow path: re-open the DWARF file and walk CUs until the function
+    /// containing the PC is found. Variable location expressions are resolved
+    /// into the compact LocalVarLocation forms as they're encountered.
+    fn parse_locals_at_pc_uncached(&self, crash_pc: u64) -> Result<Vec<LocalVariableInfo>> {
         let binary_path = self
             .binary_path
             .as_ref()
@@ -1576,9 +1821,9 @@ impl DwarfParser {
     /// Resolve file:line to instruction address. Snaps to nearest is_statement line.
     /// Returns (address, actual_line) or None if no code at that location.
     pub fn resolve_line(&self, file: &str, line: u32) -> Option<(u64, u32)> {
-        self.ensure_line_table();
+        self.ensure_line_table_for_file(file);
         let table = self.line_table.lock().unwrap();
-        let entries = table.as_ref()?;
+        let entries = &table.entries;
 
         // Find entries matching file.
         // Use path-component-aware matching: require separator before the match
@@ -1610,12 +1855,9 @@ impl DwarfParser {
 
     /// Find nearest valid line numbers for error messages
     pub fn find_nearest_lines(&self, file: &str, target_line: u32, count: usize) -> String {
-        self.ensure_line_table();
+        self.ensure_line_table_for_file(file);
         let table = self.line_table.lock().unwrap();
-        let entries = match table.as_ref() {
-            Some(e) => e,
-            None => return "unknown".to_string(),
-        };
+        let entries = &table.entries;
 
         // Get all unique statement lines for this file
         let sep_file = format!("/{}", file);
@@ -1659,13 +1901,13 @@ impl DwarfParser {
     fn function_containing(&self, address: u64) -> Option<(u64, u64)> {
         let idx = match self
             .functions_by_addr
-            .binary_search_by_key(&address, |&(low, _)| low)
+            .binary_search_by_key(&address, |&(low, _, _)| low)
         {
             Ok(idx) => idx,        // Exact match on low_pc
             Err(0) => return None, // Before all functions
             Err(idx) => idx - 1,   // Check preceding function
         };
-        let (low, high) = self.functions_by_addr[idx];
+        let (low, high, _) = self.functions_by_addr[idx];
         if address >= low && address < high {
             Some((low, high))
         } else {
@@ -1673,14 +1915,30 @@ impl DwarfParser {
         }
     }
 
+    /// O(log N) lookup: address → the FunctionInfo whose [low_pc, high_pc)
+    /// range contains it. Used to lazily symbolize raw backtrace frames
+    /// captured by the agent's native frame-pointer unwinder.
+    pub fn function_at_address(&self, address: u64) -> Option<&FunctionInfo> {
+        let idx = match self
+            .functions_by_addr
+            .binary_search_by_key(&address, |&(low, _, _)| low)
+        {
+            Ok(idx) => idx,
+            Err(0) => return None,
+            Err(idx) => idx - 1,
+        };
+        let (low, high, func_idx) = self.functions_by_addr[idx];
+        (address >= low && address < high).then(|| &self.functions[func_idx])
+    }
+
     /// Reverse lookup: address → (file, line, column).
     /// For addresses between line entries, returns the closest preceding entry
     /// (the line that "contains" that address). Only returns a result if the
     /// address falls within a known function boundary.
     pub fn resolve_address(&self, address: u64) -> Option<(String, u32, u32)> {
-        self.ensure_line_table();
+        self.ensure_line_table_for_address(address);
         let table = self.line_table.lock().unwrap();
-        let entries = table.as_ref()?;
+        let entries = &table.entries;
 
         let idx = match entries.binary_search_by_key(&address, |e| e.address) {
             Ok(idx) => idx,        // Exact match
@@ -1713,9 +1971,9 @@ impl DwarfParser {
         address: u64,
         min_offset: u64,
     ) -> Option<(u64, String, u32)> {
-        self.ensure_line_table();
+        self.ensure_line_table_for_address(address);
         let table = self.line_table.lock().unwrap();
-        let entries = table.as_ref()?;
+        let entries = &table.entries;
 
         // Find current entry (use closest preceding for non-exact addresses)
         let idx = match entries.binary_search_by_key(&address, |e| e.address) {
@@ -1753,10 +2011,29 @@ impl DwarfParser {
     pub fn callee_entry_addresses(&self, _address: u64) -> Vec<u64> {
         Vec::new()
     }
-    /// Parse line table on first access (lazy initialization)
-    fn ensure_line_table(&self) {
+    /// Decode line rows for the CUs whose file table mentions `file`.
+    fn ensure_line_table_for_file(&self, file: &str) {
+        let sep_file = format!("/{}", file);
+        let sep_file_win = format!("\\{}", file);
+        self.ensure_line_table_for(|cu| {
+            cu.files
+                .iter()
+                .any(|f| f == file || f.ends_with(&sep_file) || f.ends_with(&sep_file_win))
+        });
+    }
+
+    /// Decode line rows for the CU whose address range contains `address`.
+    fn ensure_line_table_for_address(&self, address: u64) {
+        self.ensure_line_table_for(|cu| cu.low_pc <= address && address < cu.high_pc);
+    }
+
+    /// Decode line programs for the CUs selected by `wanted`, merging their
+    /// rows into the accumulated table. Each CU is decoded at most once.
+    /// Without per-CU metadata (parser rehydrated from an older source),
+    /// the first call falls back to decoding every CU as before.
+    fn ensure_line_table_for(&self, wanted: impl Fn(&CuLineInfo) -> bool) {
         let mut guard = self.line_table.lock().unwrap();
-        if guard.is_some() {
+        if guard.all_parsed {
             return;
         }
 
@@ -1768,10 +2045,41 @@ impl DwarfParser {
             }
         };
 
-        match self.parse_line_table(binary_path) {
-            Ok(entries) => {
-                tracing::info!("Parsed {} line table entries", entries.len());
-                *guard = Some(entries);
+        if self.cu_line_info.is_empty() {
+            match self.parse_line_table(binary_path, None) {
+                Ok(entries) => {
+                    tracing::info!("Parsed {} line table entries", entries.len());
+                    guard.entries = entries;
+                }
+                Err(e) => {
+                    tracing::error!("Failed to parse line table: {}", e);
+                }
+            }
+            guard.all_parsed = true;
+            return;
+        }
+
+        let selected: Vec<usize> = self
+            .cu_line_info
+            .iter()
+            .filter(|cu| !guard.parsed_cus.contains(&cu.debug_info_offset) && wanted(cu))
+            .map(|cu| cu.debug_info_offset)
+            .collect();
+        if selected.is_empty() {
+            return;
+        }
+
+        match self.parse_line_table(binary_path, Some(&selected)) {
+            Ok(mut entries) => {
+                tracing::debug!(
+                    "Decoded line programs for {} CU(s): {} entries",
+                    selected.len(),
+                    entries.len()
+                );
+                guard.entries.append(&mut entries);
+                guard.entries.sort_by_key(|e| e.address);
+                guard.parsed_cus.extend(selected);
+                guard.all_parsed = guard.parsed_cus.len() >= self.cu_line_info.len();
             }
             Err(e) => {
                 tracing::error!("Failed to parse line table: {}", e);
@@ -1779,15 +2087,33 @@ impl DwarfParser {
         }
     }
 
-    /// Parse DWARF .debug_line section via gimli
-    fn parse_line_table(&self, binary_path: &Path) -> Result<Vec<LineEntry>> {
+    /// Parse DWARF .debug_line rows via gimli. With `only`, restricts row
+    /// execution to the CUs at those `.debug_info` offsets; the remaining
+    /// units are skipped after the (cheap) header parse.
+    fn parse_line_table(
+        &self,
+        binary_path: &Path,
+        only: Option<&[usize]>,
+    ) -> Result<Vec<LineEntry>> {
         let loaded = load_dwarf_sections(binary_path)?;
         let dwarf = loaded.borrow();
+        let only: Option<std::collections::HashSet<usize>> =
+            only.map(|offsets| offsets.iter().copied().collect());
 
         let mut entries = Vec::new();
 
         let mut units_iter = dwarf.units();
         while let Ok(Some(header)) = units_iter.next() {
+            if let Some(ref wanted_offsets) = only {
+                let offset = match header.offset() {
+                    gimli::UnitSectionOffset::DebugInfoOffset(o) => o.0,
+                    _ => continue,
+                };
+                if !wanted_offsets.contains(&offset) {
+                    continue;
+                }
+            }
+
             let unit = match dwarf.unit(header) {
                 Ok(u) => u,
                 Err(_) => continue,
@@ -2099,6 +2425,145 @@ mod pattern_tests {
     }
 }
 
+#[cfg(test)]
+mod locals_cache_tests {
+    use super::*;
+
+    fn parser_with_function(low_pc: u64, high_pc: u64) -> DwarfParser {
+        let func = FunctionInfo {
+            name: "app::process".to_string(),
+            name_raw: None,
+            low_pc,
+            high_pc,
+            source_file: Some("/src/app.rs".to_string()),
+            line_number: Some(10),
+        };
+        // No binary_path: the uncached path errors, so any successful
+        // resolution in these tests must have come from the cache.
+        DwarfParser::from_parts(vec![func], vec![], HashMap::new(), vec![], 0, None)
+    }
+
+    fn local(name: &str) -> LocalVariableInfo {
+        LocalVariableInfo {
+            name: name.to_string(),
+            byte_size: 4,
+            type_kind: TypeKind::Integer { signed: true },
+            type_name: Some("int32_t".to_string()),
+            location: LocalVarLocation::FrameBaseRelative(-8),
+        }
+    }
+
+    #[test]
+    fn test_cached_locals_skip_dwarf_reparse() {
+        let parser = parser_with_function(0x1000, 0x1100);
+        parser
+            .locals_cache
+            .lock()
+            .unwrap()
+            .insert((0x1000, 0x1100), vec![local("num_samples")]);
+
+        // Any PC inside the function hits the same cache entry
+        let locals = parser.parse_locals_at_pc(0x1050).unwrap();
+        assert_eq!(locals.len(), 1);
+        assert_eq!(locals[0].name, "num_samples");
+        let locals = parser.parse_locals_at_pc(0x10ff).unwrap();
+        assert_eq!(locals[0].name, "num_samples");
+    }
+
+    #[test]
+    fn test_cache_miss_falls_through_to_reparse() {
+        let parser = parser_with_function(0x1000, 0x1100);
+        // Empty cache + no binary path: the slow path runs and fails
+        assert!(parser.parse_locals_at_pc(0x1050).is_err());
+    }
+
+    #[test]
+    fn test_pc_outside_known_functions_is_not_cached() {
+        let parser = parser_with_function(0x1000, 0x1100);
+        assert!(parser.parse_locals_at_pc(0x9000).is_err());
+        assert!(parser.locals_cache.lock().unwrap().is_empty());
+    }
+}
+
+#[cfg(test)]
+mod symbol_index_tests {
+    use super::*;
+
+    fn func(name: &str, name_raw: Option<&str>) -> FunctionInfo {
+        FunctionInfo {
+            name: name.to_string(),
+            name_raw: name_raw.map(|s| s.to_string()),
+            low_pc: 0,
+            high_pc: 0,
+            source_file: None,
+            line_number: None,
+        }
+    }
+
+    fn test_parser() -> DwarfParser {
+        DwarfParser::from_parts(
+            vec![
+                func("audio::process_buffer(audio::AudioBuffer*)", None),
+                func("audio::generate_sine(float)", None),
+                func("midi::note_on", Some("_ZN4midi7note_onEhh")),
+                func("midi::engine::tick", None),
+                func("main", None),
+            ],
+            vec![],
+            HashMap::new(),
+            vec![],
+            0,
+            None,
+        )
+    }
+
+    #[test]
+    fn test_literal_prefix() {
+        assert_eq!(SymbolIndex::literal_prefix("audio::*"), "audio::");
+        assert_eq!(SymbolIndex::literal_prefix("**::tick"), "");
+        assert_eq!(SymbolIndex::literal_prefix("main"), "main");
+    }
+
+    #[test]
+    fn test_prefix_range_narrows_candidates() {
+        let parser = test_parser();
+        let range = parser.symbol_index.prefix_range("audio::");
+        assert_eq!(range.len(), 2);
+        assert!(range.iter().all(|(n, _)| n.starts_with("audio::")));
+        assert!(parser.symbol_index.prefix_range("zzz").is_empty());
+        // Mangled names are indexed alongside demangled ones
+        assert_eq!(parser.symbol_index.prefix_range("_ZN4midi").len(), 1);
+    }
+
+    #[test]
+    fn test_find_by_pattern_matches_scan_results() {
+        let parser = test_parser();
+
+        // Prefix-pruned queries return the same results as a full scan,
+        // in table order
+        let hits = parser.find_by_pattern("audio::*");
+        assert_eq!(hits.len(), 2);
+        assert_eq!(hits[0].name, "audio::process_buffer(audio::AudioBuffer*)");
+
+        // Exact pattern through C++ parameter stripping
+        assert_eq!(parser.find_by_pattern("midi::note_on").len(), 1);
+
+        // Shallow * does not cross :: even within the prefix range
+        let shallow = parser.find_by_pattern("midi::*");
+        assert_eq!(shallow.len(), 1);
+        assert_eq!(shallow[0].name, "midi::note_on");
+        assert_eq!(parser.find_by_pattern("midi::**").len(), 2);
+
+        // Leading wildcard falls back to the scan path
+        let deep = parser.find_by_pattern("**::tick");
+        assert_eq!(deep.len(), 1);
+        assert_eq!(deep[0].name, "midi::engine::tick");
+
+        // No demangled/mangled duplicates in results
+        assert_eq!(parser.find_by_pattern("midi::note_on**").len(), 1);
+    }
+}
+
 #[cfg(test)]
 mod struct_expansion_tests {
     use super::*;
@@ -8,6 +8,160 @@ pub enum HookMode {
     Light, // enter + exit, adaptive sampling
 }
 
+/// Comparison operator for an argument predicate. The numeric codes are
+/// shared with the CModule's `func_pred_op` table, where 0 means "no
+/// predicate" — so codes start at 1.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+pub enum PredicateOp {
+    Eq,
+    Ne,
+    Lt,
+    Gt,
+    Le,
+    Ge,
+}
+
+impl PredicateOp {
+    pub fn code(self) -> u8 {
+        match self {
+            Self::Eq => 1,
+            Self::Ne => 2,
+            Self::Lt => 3,
+            Self::Gt => 4,
+            Self::Le => 5,
+            Self::Ge => 6,
+        }
+    }
+}
+
+/// An argument predicate parsed from a trace pattern suffix, e.g.
+/// `processBlock(arg1 != 512)` or `getNextBlock(arg0 == null)`. Compiled
+/// into the native hook so non-matching calls cost a few instructions and
+/// never produce an event.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+pub struct ArgPredicate {
+    pub arg_index: u8,
+    pub op: PredicateOp,
+    pub value: i64,
+}
+
+/// Split an optional `(argN <op> value)` predicate suffix off a trace
+/// pattern. Returns the base pattern (what resolution and mode
+/// classification see) and the parsed predicate, if any.
+///
+/// Values are signed decimal, hex (`0x...`), or `null` (pointer null check,
+/// `==`/`!=` only). Arg indices run 0..=7 — integer/pointer register
+/// arguments; float and stack-spilled arguments aren't reachable from the
+/// hook's argument accessor.
+pub fn split_pattern_predicate(pattern: &str) -> crate::Result<(String, Option<ArgPredicate>)> {
+    if !pattern.ends_with(')') {
+        return Ok((pattern.to_string(), None));
+    }
+    // Find the '(' opening the trailing group. Demangled C++ names can
+    // contain nested parens, so balance from the end.
+    let bytes = pattern.as_bytes();
+    let mut depth = 0usize;
+    let mut open = None;
+    for i in (0..bytes.len()).rev() {
+        match bytes[i] {
+            b')' => depth += 1,
+            b'(' => {
+                depth -= 1;
+                if depth == 0 {
+                    open = Some(i);
+                    break;
+                }
+            }
+            _ => {}
+        }
+    }
+    let open = match open {
+        Some(i) if i > 0 => i,
+        _ => return Ok((pattern.to_string(), None)),
+    };
+    let inner = pattern[open + 1..pattern.len() - 1].trim();
+    // Only a trailing group that reads like `argN ...` is a predicate;
+    // anything else is part of the name (e.g. a demangled signature).
+    let looks_like_predicate = inner
+        .strip_prefix("arg")
+        .map(|r| r.starts_with(|c: char| c.is_ascii_digit()))
+        .unwrap_or(false);
+    if !looks_like_predicate {
+        return Ok((pattern.to_string(), None));
+    }
+
+    let invalid = |reason: String| crate::Error::InvalidPattern {
+        pattern: pattern.to_string(),
+        reason,
+    };
+
+    let rest = &inner[3..]; // past "arg"
+    let digits_end = rest
+        .find(|c: char| !c.is_ascii_digit())
+        .unwrap_or(rest.len());
+    let arg_index: u8 = rest[..digits_end]
+        .parse()
+        .map_err(|_| invalid("argument index must be 0-7".to_string()))?;
+    if arg_index > 7 {
+        return Err(invalid(format!(
+            "argument index {} out of range (predicates support arg0-arg7)",
+            arg_index
+        )));
+    }
+
+    let rest = rest[digits_end..].trim_start();
+    let (op, rest) = if let Some(r) = rest.strip_prefix("==") {
+        (PredicateOp::Eq, r)
+    } else if let Some(r) = rest.strip_prefix("!=") {
+        (PredicateOp::Ne, r)
+    } else if let Some(r) = rest.strip_prefix("<=") {
+        (PredicateOp::Le, r)
+    } else if let Some(r) = rest.strip_prefix(">=") {
+        (PredicateOp::Ge, r)
+    } else if let Some(r) = rest.strip_prefix('<') {
+        (PredicateOp::Lt, r)
+    } else if let Some(r) = rest.strip_prefix('>') {
+        (PredicateOp::Gt, r)
+    } else {
+        return Err(invalid(
+            "expected ==, !=, <, >, <= or >= after the argument index".to_string(),
+        ));
+    };
+
+    let value_str = rest.trim();
+    let value = if value_str == "null" {
+        if op != PredicateOp::Eq && op != PredicateOp::Ne {
+            return Err(invalid("null only supports == and !=".to_string()));
+        }
+        0
+    } else if let Some(hex) = value_str
+        .strip_prefix("0x")
+        .or_else(|| value_str.strip_prefix("0X"))
+    {
+        // Hex values are raw bit patterns (pointers), parsed unsigned and
+        // reinterpreted — the hook compares as signed 64-bit.
+        u64::from_str_radix(hex, 16)
+            .map(|v| v as i64)
+            .map_err(|_| invalid(format!("invalid hex value '{}'", value_str)))?
+    } else {
+        value_str.parse::<i64>().map_err(|_| {
+            invalid(format!(
+                "expected an integer, 0x hex, or null — got '{}'",
+                value_str
+            ))
+        })?
+    };
+
+    Ok((
+        pattern[..open].trim_end().to_string(),
+        Some(ArgPredicate {
+            arg_index,
+            op,
+            value,
+        }),
+    ))
+}
+
 pub struct HookManager {
     active_patterns: HashSet<String>,
 }
@@ -174,4 +328,86 @@ mod tests {
         assert_eq!(full_count, 4); // foo::bar(1) + @file:tiny(3)
         assert_eq!(light_count, 250); // foo::**(50) + @file:big(200)
     }
+
+    #[test]
+    fn test_predicate_plain_pattern_passes_through() {
+        let (base, pred) = split_pattern_predicate("foo::bar").unwrap();
+        assert_eq!(base, "foo::bar");
+        assert_eq!(pred, None);
+    }
+
+    #[test]
+    fn test_predicate_parses_comparison() {
+        let (base, pred) = split_pattern_predicate("processBlock(arg1 != 512)").unwrap();
+        assert_eq!(base, "processBlock");
+        assert_eq!(
+            pred,
+            Some(ArgPredicate {
+                arg_index: 1,
+                op: PredicateOp::Ne,
+                value: 512,
+            })
+        );
+    }
+
+    #[test]
+    fn test_predicate_parses_null_check() {
+        let (base, pred) = split_pattern_predicate("getNextBlock(arg0 == null)").unwrap();
+        assert_eq!(base, "getNextBlock");
+        assert_eq!(
+            pred,
+            Some(ArgPredicate {
+                arg_index: 0,
+                op: PredicateOp::Eq,
+                value: 0,
+            })
+        );
+    }
+
+    #[test]
+    fn test_predicate_parses_hex_and_negative() {
+        let (_, pred) = split_pattern_predicate("f(arg2 >= 0x1000)").unwrap();
+        assert_eq!(pred.unwrap().value, 0x1000);
+        let (_, pred) = split_pattern_predicate("f(arg0 < -1)").unwrap();
+        assert_eq!(pred.unwrap().value, -1);
+    }
+
+    #[test]
+    fn test_predicate_spacing_is_flexible() {
+        let (base, pred) = split_pattern_predicate("audio::*::process(arg1<=4096)").unwrap();
+        assert_eq!(base, "audio::*::process");
+        let pred = pred.unwrap();
+        assert_eq!(pred.op, PredicateOp::Le);
+        assert_eq!(pred.value, 4096);
+    }
+
+    #[test]
+    fn test_predicate_signature_parens_are_not_predicates() {
+        // Demangled signatures contain parens but don't read like `argN op`.
+        let (base, pred) = split_pattern_predicate("Foo::bar(int, float)").unwrap();
+        assert_eq!(base, "Foo::bar(int, float)");
+        assert_eq!(pred, None);
+    }
+
+    #[test]
+    fn test_predicate_rejects_bad_operator_and_range() {
+        assert!(split_pattern_predicate("f(arg0 ~ 1)").is_err());
+        assert!(split_pattern_predicate("f(arg8 == 1)").is_err());
+        assert!(split_pattern_predicate("f(arg0 == banana)").is_err());
+    }
+
+    #[test]
+    fn test_predicate_null_rejects_ordering_ops() {
+        assert!(split_pattern_predicate("f(arg0 < null)").is_err());
+    }
+
+    #[test]
+    fn test_predicate_op_codes_match_cmodule_table() {
+        assert_eq!(PredicateOp::Eq.code(), 1);
+        assert_eq!(PredicateOp::Ne.code(), 2);
+        assert_eq!(PredicateOp::Lt.code(), 3);
+        assert_eq!(PredicateOp::Gt.code(), 4);
+        assert_eq!(PredicateOp::Le.code(), 5);
+        assert_eq!(PredicateOp::Ge.code(), 6);
+    }
 }
@@ -1,13 +1,18 @@
 mod hooks;
+mod shm_reader;
 mod spawner;
 
+pub use hooks::split_pattern_predicate;
+pub use hooks::ArgPredicate;
 pub use hooks::HookManager;
 pub use hooks::HookMode;
+pub use hooks::PredicateOp;
 pub use spawner::ExprWatchTarget;
 pub use spawner::FridaSpawner;
 pub use spawner::HookResult;
 pub use spawner::PauseNotification;
 pub use spawner::PauseNotifyTx;
+pub use spawner::ShardedEventTx;
 pub use spawner::WatchTarget;
 
 #[cfg(test)]
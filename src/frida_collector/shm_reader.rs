@@ -0,0 +1,840 @@
+//! Shared-memory ring buffer transport for trace events.
+//!
+//! The agent's CModule writes fixed-size `TraceEntry` records into a POSIX
+//! shared-memory region (see `agent/src/shm-transport.ts`). When the daemon
+//! successfully maps the same region, the agent stops decoding entries in JS
+//! and the daemon drains them here directly — no JSON serialization on the
+//! target's hot path.
+//!
+//! Handoff protocol (header `shm_state` field, offset 20):
+//!   0 = agent owns the ring and drains it via JS + send() (fallback path)
+//!   1 = daemon mapped the region and requests ownership
+//!   2 = agent acknowledged; daemon drains from the current read index
+//!
+//! The agent keeps the send() path until state reaches 2, so platforms where
+//! shm setup or daemon-side mapping fails lose nothing — they just stay on
+//! the JSON channel.
+
+use crate::db::{Event, EventType};
+use crate::Result;
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
+use std::thread;
+use tokio::sync::mpsc;
+
+/// Header layout — must match HEADER offsets in agent/src/cmodule-tracer.ts.
+const WRITE_IDX_OFFSET: usize = 0;
+const READ_IDX_OFFSET: usize = 4;
+const SHM_STATE_OFFSET: usize = 20;
+
+/// shm_state values for the ownership handoff.
+const SHM_STATE_DAEMON_REQUEST: u32 = 1;
+const SHM_STATE_AGENT_ACKED: u32 = 2;
+
+const DRAIN_INTERVAL_MS: u64 = 10;
+
+/// TraceEntry field offsets — must match the CModule struct layout.
+const ENTRY_TIMESTAMP: usize = 0;
+const ENTRY_ARG0: usize = 8;
+const ENTRY_ARG1: usize = 16;
+const ENTRY_RETVAL: usize = 24;
+const ENTRY_FUNC_ID: usize = 32;
+const ENTRY_THREAD_ID: usize = 36;
+const ENTRY_DEPTH: usize = 40;
+const ENTRY_EVENT_TYPE: usize = 44;
+const ENTRY_SAMPLED: usize = 45;
+const ENTRY_WATCH_COUNT: usize = 46;
+const ENTRY_STACK_COUNT: usize = 47;
+const ENTRY_WATCH0: usize = 48;
+const ENTRY_STACK0: usize = 80;
+const STACK_SLOTS: usize = 8;
+
+/// Function metadata registered by the agent via `shm_func` messages
+/// (sent at hook-install time, not on the hot path).
+#[derive(Debug, Clone)]
+pub struct ShmFuncInfo {
+    pub name: String,
+    pub name_raw: Option<String>,
+    pub source_file: Option<String>,
+    pub line_number: Option<u32>,
+}
+
+/// Watch slot configuration registered by the agent via `shm_watches`.
+/// Mirrors the agent's WatchConfig so raw 8-byte slot values can be
+/// formatted daemon-side.
+#[derive(Debug, Clone)]
+pub struct ShmWatchConfig {
+    pub label: String,
+    /// "int" | "uint" | "float" | "pointer"
+    pub type_kind: String,
+    pub size: u8,
+    pub is_global: bool,
+    pub func_ids: std::collections::HashSet<u32>,
+}
+
+/// Shared decode state fed by agent messages while the reader runs.
+type FuncRegistry = Arc<Mutex<HashMap<u32, ShmFuncInfo>>>;
+type WatchTable = Arc<Mutex<Vec<Option<ShmWatchConfig>>>>;
+
+/// Per-thread call stack entry used to pair enters with exits and assign
+/// parent event IDs — a port of the agent's JS drain logic.
+struct StackEntry {
+    event_id: String,
+    depth: u32,
+    timestamp_ns: i64,
+}
+
+/// Decoder state that persists across drain cycles.
+struct DecodeState {
+    session_id: String,
+    pid: u32,
+    ticks_to_ns: f64,
+    event_counter: u64,
+    thread_stacks: HashMap<u32, Vec<StackEntry>>,
+    thread_names: HashMap<u32, Option<String>>,
+}
+
+impl DecodeState {
+    fn next_event_id(&mut self) -> String {
+        self.event_counter += 1;
+        format!("{}-shm-{}", self.session_id, self.event_counter)
+    }
+
+    fn thread_name(&mut self, thread_id: u32) -> Option<String> {
+        let pid = self.pid;
+        self.thread_names
+            .entry(thread_id)
+            .or_insert_with(|| read_thread_name(pid, thread_id))
+            .clone()
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn read_thread_name(pid: u32, thread_id: u32) -> Option<String> {
+    let path = format!("/proc/{}/task/{}/comm", pid, thread_id);
+    std::fs::read_to_string(path)
+        .ok()
+        .map(|s| s.trim().to_string())
+        .filter(|s| !s.is_empty())
+}
+
+#[cfg(not(target_os = "linux"))]
+fn read_thread_name(_pid: u32, _thread_id: u32) -> Option<String> {
+    None
+}
+
+/// Format a raw 8-byte watch slot value the same way the agent's
+/// formatWatchValue does.
+fn format_watch_value(raw: u64, cfg: &ShmWatchConfig) -> serde_json::Value {
+    match cfg.type_kind.as_str() {
+        "float" => {
+            if cfg.size == 4 {
+                serde_json::json!(f32::from_bits(raw as u32) as f64)
+            } else {
+                serde_json::json!(f64::from_bits(raw))
+            }
+        }
+        "int" => {
+            let val = match cfg.size {
+                1 => raw as u8 as i8 as i64,
+                2 => raw as u16 as i16 as i64,
+                4 => raw as u32 as i32 as i64,
+                _ => raw as i64,
+            };
+            serde_json::json!(val)
+        }
+        _ => serde_json::json!(raw),
+    }
+}
+
+/// Decode one ring buffer entry into an Event, updating per-thread stacks.
+/// Returns None for entries whose funcId has no registered metadata yet.
+fn decode_entry(
+    entry: &[u8],
+    state: &mut DecodeState,
+    registry: &HashMap<u32, ShmFuncInfo>,
+    watches: &[Option<ShmWatchConfig>],
+    aslr_slide: u64,
+) -> Option<Event> {
+    let read_u64 = |off: usize| u64::from_le_bytes(entry[off..off + 8].try_into().unwrap());
+    let read_u32 = |off: usize| u32::from_le_bytes(entry[off..off + 4].try_into().unwrap());
+
+    let timestamp = read_u64(ENTRY_TIMESTAMP);
+    let func_id = read_u32(ENTRY_FUNC_ID);
+    let thread_id = read_u32(ENTRY_THREAD_ID);
+    let depth = read_u32(ENTRY_DEPTH);
+    let event_type = entry[ENTRY_EVENT_TYPE];
+    let sampled = entry[ENTRY_SAMPLED] != 0;
+    let watch_entry_count = entry[ENTRY_WATCH_COUNT] as usize;
+
+    // Timer-driven watch sample from the CModule's sampler thread: sentinel
+    // func_id 0 (real funcIds start at 1), no function or thread context.
+    // Handled before the registry lookup, which would otherwise drop it.
+    if event_type == 2 {
+        let mut watch_values = serde_json::Map::new();
+        for (w, cfg) in watches.iter().enumerate().take(watch_entry_count.min(4)) {
+            let Some(cfg) = cfg else { continue };
+            let raw = read_u64(ENTRY_WATCH0 + w * 8);
+            watch_values.insert(cfg.label.clone(), format_watch_value(raw, cfg));
+        }
+        if watch_values.is_empty() {
+            return None;
+        }
+        let timestamp_ns = (timestamp as f64 * state.ticks_to_ns).round() as i64;
+        let event_id = state.next_event_id();
+        return Some(Event {
+            id: event_id,
+            session_id: state.session_id.clone(),
+            timestamp_ns,
+            thread_id: 0,
+            event_type: EventType::VariableSnapshot,
+            function_name: String::new(),
+            watch_values: Some(serde_json::Value::Object(watch_values)),
+            pid: Some(state.pid),
+            ..Event::default()
+        });
+    }
+
+    let func = registry.get(&func_id)?;
+
+    let timestamp_ns = (timestamp as f64 * state.ticks_to_ns).round() as i64;
+    let event_id = state.next_event_id();
+    let thread_name = state.thread_name(thread_id);
+    let pid = state.pid;
+    let session_id = state.session_id.clone();
+
+    let stack = state.thread_stacks.entry(thread_id).or_default();
+
+    if event_type == 0 {
+        // function_enter — pop entries at depth >= current (missed exits),
+        // parent is the caller on top of the stack.
+        while stack.last().is_some_and(|e| e.depth >= depth) {
+            stack.pop();
+        }
+        let parent_event_id = stack.last().map(|e| e.event_id.clone());
+        stack.push(StackEntry {
+            event_id: event_id.clone(),
+            depth,
+            timestamp_ns,
+        });
+
+        // Watch values are only attached to enter events (mirrors JS drain).
+        let mut watch_values = serde_json::Map::new();
+        for (w, cfg) in watches.iter().enumerate().take(watch_entry_count.min(4)) {
+            let Some(cfg) = cfg else { continue };
+            if !cfg.is_global && !cfg.func_ids.contains(&func_id) {
+                continue;
+            }
+            let raw = read_u64(ENTRY_WATCH0 + w * 8);
+            watch_values.insert(cfg.label.clone(), format_watch_value(raw, cfg));
+        }
+
+        // Raw return addresses from the CModule's frame-pointer walk,
+        // rebased to static addresses and stored unsymbolized — DWARF
+        // resolution happens at query time, not here. The length guard
+        // keeps 80-byte entries from pre-stack agents decoding unchanged.
+        let stack_count = entry[ENTRY_STACK_COUNT] as usize;
+        let backtrace =
+            (stack_count > 0 && entry.len() >= ENTRY_STACK0 + STACK_SLOTS * 8).then(|| {
+                serde_json::Value::Array(
+                    (0..stack_count.min(STACK_SLOTS))
+                        .map(|s| {
+                            let raw = read_u64(ENTRY_STACK0 + s * 8);
+                            serde_json::json!({
+                                "address": format!("0x{:x}", raw.wrapping_sub(aslr_slide)),
+                            })
+                        })
+                        .collect(),
+                )
+            });
+
+        Some(Event {
+            id: event_id,
+            session_id,
+            timestamp_ns,
+            thread_id: thread_id as i64,
+            thread_name,
+            parent_event_id,
+            event_type: EventType::FunctionEnter,
+            function_name: func.name.clone(),
+            function_name_raw: func.name_raw.clone(),
+            source_file: func.source_file.clone(),
+            line_number: func.line_number.map(|n| n as i32),
+            arguments: Some(serde_json::json!([
+                format!("0x{:x}", read_u64(ENTRY_ARG0)),
+                format!("0x{:x}", read_u64(ENTRY_ARG1)),
+            ])),
+            sampled: sampled.then_some(true),
+            watch_values: (!watch_values.is_empty())
+                .then(|| serde_json::Value::Object(watch_values)),
+            backtrace,
+            pid: Some(pid),
+            ..Event::default()
+        })
+    } else {
+        // function_exit — pair with the enter on top of the stack.
+        let mut parent_event_id = None;
+        let mut duration_ns = None;
+        if stack.last().is_some_and(|e| e.depth == depth) {
+            let enter = stack.pop().unwrap();
+            parent_event_id = Some(enter.event_id);
+            let d = timestamp_ns - enter.timestamp_ns;
+            if d >= 0 {
+                duration_ns = Some(d);
+            }
+        }
+
+        Some(Event {
+            id: event_id,
+            session_id,
+            timestamp_ns,
+            thread_id: thread_id as i64,
+            thread_name,
+            parent_event_id,
+            event_type: EventType::FunctionExit,
+            function_name: func.name.clone(),
+            function_name_raw: func.name_raw.clone(),
+            source_file: func.source_file.clone(),
+            line_number: func.line_number.map(|n| n as i32),
+            return_value: Some(serde_json::json!(format!("0x{:x}", read_u64(ENTRY_RETVAL)))),
+            duration_ns,
+            sampled: sampled.then_some(true),
+            pid: Some(pid),
+            ..Event::default()
+        })
+    }
+}
+
+/// Mapped shared-memory region. Unmapped on drop; the agent owns the
+/// shm name and unlinks it at teardown.
+struct ShmMapping {
+    base: *mut u8,
+    size: usize,
+}
+
+// The mapping is only dereferenced by the reader thread.
+unsafe impl Send for ShmMapping {}
+
+impl ShmMapping {
+    /// Map an existing POSIX shm object by name (e.g. "/strobe-1234-5678").
+    fn open(name: &str, size: usize) -> std::result::Result<Self, String> {
+        let c_name = std::ffi::CString::new(name).map_err(|e| e.to_string())?;
+        unsafe {
+            let fd = libc::shm_open(c_name.as_ptr(), libc::O_RDWR, 0);
+            if fd < 0 {
+                return Err(format!(
+                    "shm_open({}) failed: {}",
+                    name,
+                    std::io::Error::last_os_error()
+                ));
+            }
+            let base = libc::mmap(
+                std::ptr::null_mut(),
+                size,
+                libc::PROT_READ | libc::PROT_WRITE,
+                libc::MAP_SHARED,
+                fd,
+                0,
+            );
+            libc::close(fd);
+            if base == libc::MAP_FAILED {
+                return Err(format!(
+                    "mmap of {} failed: {}",
+                    name,
+                    std::io::Error::last_os_error()
+                ));
+            }
+            Ok(Self {
+                base: base as *mut u8,
+                size,
+            })
+        }
+    }
+
+    fn read_header_u32(&self, offset: usize) -> u32 {
+        unsafe { std::ptr::read_volatile(self.base.add(offset) as *const u32) }
+    }
+
+    fn write_header_u32(&self, offset: usize, value: u32) {
+        unsafe { std::ptr::write_volatile(self.base.add(offset) as *mut u32, value) }
+    }
+
+    /// Copy one entry out of the data region. A copy (rather than a borrow)
+    /// because the CModule may be concurrently writing neighbouring slots.
+    fn copy_entry(&self, header_size: usize, entry_size: usize, slot: usize, out: &mut [u8]) {
+        unsafe {
+            std::ptr::copy_nonoverlapping(
+                self.base.add(header_size + slot * entry_size),
+                out.as_mut_ptr(),
+                entry_size,
+            );
+        }
+    }
+}
+
+impl Drop for ShmMapping {
+    fn drop(&mut self) {
+        unsafe {
+            libc::munmap(self.base as *mut std::ffi::c_void, self.size);
+        }
+    }
+}
+
+/// Geometry of the ring buffer, taken from the agent's `shm_ready` payload
+/// so both sides always agree on the layout.
+#[derive(Debug, Clone, Copy)]
+pub struct ShmGeometry {
+    pub size: usize,
+    pub capacity: usize,
+    pub entry_size: usize,
+    pub header_size: usize,
+}
+
+impl ShmGeometry {
+    pub fn from_payload(payload: &serde_json::Value) -> Option<Self> {
+        let size = payload.get("size")?.as_u64()? as usize;
+        let capacity = payload.get("capacity")?.as_u64()? as usize;
+        let entry_size = payload.get("entrySize")?.as_u64()? as usize;
+        let header_size = payload.get("headerSize")?.as_u64()? as usize;
+        // Sanity-check against a hostile or corrupt payload before mmap.
+        if capacity == 0
+            || entry_size < ENTRY_WATCH0 + 32
+            || header_size < 24
+            || header_size + capacity * entry_size > size
+        {
+            return None;
+        }
+        Some(Self {
+            size,
+            capacity,
+            entry_size,
+            header_size,
+        })
+    }
+}
+
+/// Daemon-side shared-memory ring reader for one session.
+/// Drains TraceEntry records on a dedicated thread and forwards decoded
+/// Events into the same channel the JSON message path uses.
+pub struct ShmReader {
+    stop: Arc<AtomicBool>,
+    handle: Option<thread::JoinHandle<()>>,
+    registry: FuncRegistry,
+    watches: WatchTable,
+}
+
+impl ShmReader {
+    pub fn start(
+        session_id: &str,
+        pid: u32,
+        name: &str,
+        geometry: ShmGeometry,
+        ticks_to_ns: f64,
+        aslr_slide: Arc<AtomicU64>,
+        event_tx: mpsc::Sender<Event>,
+    ) -> Result<Self> {
+        let mapping = ShmMapping::open(name, geometry.size)
+            .map_err(|e| crate::Error::Frida(format!("shm transport unavailable: {}", e)))?;
+
+        let registry: FuncRegistry = Arc::new(Mutex::new(HashMap::new()));
+        let watches: WatchTable = Arc::new(Mutex::new(vec![None, None, None, None]));
+        let stop = Arc::new(AtomicBool::new(false));
+
+        let mut state = DecodeState {
+            session_id: session_id.to_string(),
+            pid,
+            ticks_to_ns,
+            event_counter: 0,
+            thread_stacks: HashMap::new(),
+            thread_names: HashMap::new(),
+        };
+
+        let thread_registry = registry.clone();
+        let thread_watches = watches.clone();
+        let thread_stop = stop.clone();
+        let sid = session_id.to_string();
+
+        let handle = thread::spawn(move || {
+            // Request ring ownership; the agent keeps draining via send()
+            // until it acknowledges, so no entries are double-consumed.
+            mapping.write_header_u32(SHM_STATE_OFFSET, SHM_STATE_DAEMON_REQUEST);
+
+            loop {
+                if thread_stop.load(Ordering::Acquire) {
+                    break;
+                }
+                thread::sleep(std::time::Duration::from_millis(DRAIN_INTERVAL_MS));
+
+                if mapping.read_header_u32(SHM_STATE_OFFSET) != SHM_STATE_AGENT_ACKED {
+                    continue;
+                }
+
+                // Backpressure: if the write-behind writer's channel is
+                // saturated, skip this cycle instead of dropping events.
+                // The ring backlog grows, the agent's adaptive sampler sees
+                // it and raises its sample interval — closing the loop all
+                // the way back to the target process.
+                if event_tx.capacity() == 0 {
+                    continue;
+                }
+
+                let write_idx = mapping.read_header_u32(WRITE_IDX_OFFSET);
+                let read_idx = mapping.read_header_u32(READ_IDX_OFFSET);
+                if write_idx == read_idx {
+                    continue;
+                }
+
+                // Unsigned wraparound-safe count; cap at capacity on overflow
+                // (oldest entries were overwritten).
+                let mut count = write_idx.wrapping_sub(read_idx) as usize;
+                if count > geometry.capacity {
+                    count = geometry.capacity;
+                }
+
+                let registry_snapshot = thread_registry.lock().unwrap().clone();
+                let watches_snapshot = thread_watches.lock().unwrap().clone();
+                // Slide arrives via `shm_slide` once the agent learns the
+                // static image base; until then raw addresses pass through.
+                let slide = aslr_slide.load(Ordering::Relaxed);
+                let mut entry_buf = vec![0u8; geometry.entry_size];
+
+                for i in 0..count {
+                    let slot = (read_idx as usize + i) % geometry.capacity;
+                    mapping.copy_entry(
+                        geometry.header_size,
+                        geometry.entry_size,
+                        slot,
+                        &mut entry_buf,
+                    );
+                    if let Some(event) = decode_entry(
+                        &entry_buf,
+                        &mut state,
+                        &registry_snapshot,
+                        &watches_snapshot,
+                        slide,
+                    ) {
+                        crate::daemon::metrics::metrics().record_received(1);
+                        if let Err(e) = event_tx.try_send(event) {
+                            crate::daemon::metrics::metrics().record_dropped(1);
+                            tracing::warn!("Shm trace event dropped for [{}]: {}", sid, e);
+                        }
+                    }
+                }
+
+                mapping.write_header_u32(READ_IDX_OFFSET, write_idx);
+
+                // Periodic cleanup mirroring the agent drain: bound stack
+                // growth from missed exits.
+                if state.event_counter % 50_000 < count as u64 {
+                    state.thread_stacks.clear();
+                }
+            }
+        });
+
+        Ok(Self {
+            stop,
+            handle: Some(handle),
+            registry,
+            watches,
+        })
+    }
+
+    /// Register function metadata from an agent `shm_func` message.
+    pub fn register_function(&self, func_id: u32, info: ShmFuncInfo) {
+        self.registry.lock().unwrap().insert(func_id, info);
+    }
+
+    /// Replace the watch slot table from an agent `shm_watches` message.
+    pub fn set_watches(&self, configs: Vec<Option<ShmWatchConfig>>) {
+        let mut guard = self.watches.lock().unwrap();
+        *guard = configs;
+        guard.resize(4, None);
+    }
+}
+
+impl Drop for ShmReader {
+    fn drop(&mut self) {
+        self.stop.store(true, Ordering::Release);
+        if let Some(handle) = self.handle.take() {
+            let _ = handle.join();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const TEST_ENTRY_SIZE: usize = 80;
+
+    fn make_entry(
+        timestamp: u64,
+        func_id: u32,
+        thread_id: u32,
+        depth: u32,
+        event_type: u8,
+        retval: u64,
+    ) -> Vec<u8> {
+        let mut e = vec![0u8; TEST_ENTRY_SIZE];
+        e[ENTRY_TIMESTAMP..ENTRY_TIMESTAMP + 8].copy_from_slice(&timestamp.to_le_bytes());
+        e[ENTRY_RETVAL..ENTRY_RETVAL + 8].copy_from_slice(&retval.to_le_bytes());
+        e[ENTRY_FUNC_ID..ENTRY_FUNC_ID + 4].copy_from_slice(&func_id.to_le_bytes());
+        e[ENTRY_THREAD_ID..ENTRY_THREAD_ID + 4].copy_from_slice(&thread_id.to_le_bytes());
+        e[ENTRY_DEPTH..ENTRY_DEPTH + 4].copy_from_slice(&depth.to_le_bytes());
+        e[ENTRY_EVENT_TYPE] = event_type;
+        e
+    }
+
+    fn make_state() -> DecodeState {
+        DecodeState {
+            session_id: "s1".to_string(),
+            pid: 0,
+            ticks_to_ns: 1.0,
+            event_counter: 0,
+            thread_stacks: HashMap::new(),
+            thread_names: HashMap::new(),
+        }
+    }
+
+    fn make_registry() -> HashMap<u32, ShmFuncInfo> {
+        let mut r = HashMap::new();
+        r.insert(
+            1,
+            ShmFuncInfo {
+                name: "outer".to_string(),
+                name_raw: Some("_Z5outerv".to_string()),
+                source_file: Some("/src/main.cpp".to_string()),
+                line_number: Some(10),
+            },
+        );
+        r.insert(
+            2,
+            ShmFuncInfo {
+                name: "inner".to_string(),
+                name_raw: None,
+                source_file: None,
+                line_number: None,
+            },
+        );
+        r
+    }
+
+    #[test]
+    fn test_decode_enter_exit_pairing() {
+        let mut state = make_state();
+        let registry = make_registry();
+        let watches = vec![None, None, None, None];
+
+        let enter = decode_entry(
+            &make_entry(1000, 1, 7, 1, 0, 0),
+            &mut state,
+            &registry,
+            &watches,
+            0,
+        )
+        .unwrap();
+        assert_eq!(enter.event_type, EventType::FunctionEnter);
+        assert_eq!(enter.function_name, "outer");
+        assert_eq!(enter.parent_event_id, None);
+        assert_eq!(enter.timestamp_ns, 1000);
+
+        let exit = decode_entry(
+            &make_entry(3500, 1, 7, 1, 1, 0x2a),
+            &mut state,
+            &registry,
+            &watches,
+            0,
+        )
+        .unwrap();
+        assert_eq!(exit.event_type, EventType::FunctionExit);
+        assert_eq!(exit.parent_event_id, Some(enter.id.clone()));
+        assert_eq!(exit.duration_ns, Some(2500));
+        assert_eq!(exit.return_value, Some(serde_json::json!("0x2a")));
+    }
+
+    #[test]
+    fn test_decode_nested_calls_assign_parents() {
+        let mut state = make_state();
+        let registry = make_registry();
+        let watches = vec![None, None, None, None];
+
+        let outer = decode_entry(
+            &make_entry(100, 1, 7, 1, 0, 0),
+            &mut state,
+            &registry,
+            &watches,
+            0,
+        )
+        .unwrap();
+        let inner = decode_entry(
+            &make_entry(200, 2, 7, 2, 0, 0),
+            &mut state,
+            &registry,
+            &watches,
+            0,
+        )
+        .unwrap();
+        assert_eq!(inner.parent_event_id, Some(outer.id.clone()));
+        assert_eq!(inner.function_name, "inner");
+    }
+
+    #[test]
+    fn test_decode_unknown_func_id_skipped() {
+        let mut state = make_state();
+        let registry = make_registry();
+        let watches = vec![None, None, None, None];
+
+        let event = decode_entry(
+            &make_entry(100, 99, 7, 1, 0, 0),
+            &mut state,
+            &registry,
+            &watches,
+            0,
+        );
+        assert!(event.is_none());
+    }
+
+    #[test]
+    fn test_decode_ticks_conversion() {
+        let mut state = make_state();
+        state.ticks_to_ns = 2.5;
+        let registry = make_registry();
+        let watches = vec![None, None, None, None];
+
+        let event = decode_entry(
+            &make_entry(1000, 1, 7, 1, 0, 0),
+            &mut state,
+            &registry,
+            &watches,
+            0,
+        )
+        .unwrap();
+        assert_eq!(event.timestamp_ns, 2500);
+    }
+
+    #[test]
+    fn test_decode_watch_values_on_enter() {
+        let mut state = make_state();
+        let registry = make_registry();
+        let mut watches = vec![None, None, None, None];
+        watches[0] = Some(ShmWatchConfig {
+            label: "gClock".to_string(),
+            type_kind: "int".to_string(),
+            size: 4,
+            is_global: true,
+            func_ids: Default::default(),
+        });
+
+        let mut entry = make_entry(100, 1, 7, 1, 0, 0);
+        entry[ENTRY_WATCH_COUNT] = 1;
+        entry[ENTRY_WATCH0..ENTRY_WATCH0 + 8].copy_from_slice(&(-5i64 as u64).to_le_bytes());
+
+        let event = decode_entry(&entry, &mut state, &registry, &watches, 0).unwrap();
+        let wv = event.watch_values.unwrap();
+        assert_eq!(wv["gClock"], serde_json::json!(-5));
+    }
+
+    #[test]
+    fn test_decode_sampler_entry_without_function() {
+        let mut state = make_state();
+        let registry = make_registry();
+        let mut watches = vec![None, None, None, None];
+        watches[0] = Some(ShmWatchConfig {
+            label: "gPhase".to_string(),
+            type_kind: "float".to_string(),
+            size: 8,
+            is_global: true,
+            func_ids: Default::default(),
+        });
+
+        // Sampler entries carry the sentinel func_id 0, which is never in
+        // the registry — they must decode anyway.
+        let mut entry = make_entry(500, 0, 0, 0, 2, 0);
+        entry[ENTRY_WATCH_COUNT] = 1;
+        entry[ENTRY_WATCH0..ENTRY_WATCH0 + 8].copy_from_slice(&0.25f64.to_bits().to_le_bytes());
+
+        let event = decode_entry(&entry, &mut state, &registry, &watches, 0).unwrap();
+        assert_eq!(event.event_type, EventType::VariableSnapshot);
+        assert_eq!(event.function_name, "");
+        assert_eq!(event.timestamp_ns, 500);
+        assert_eq!(
+            event.watch_values.unwrap()["gPhase"],
+            serde_json::json!(0.25)
+        );
+
+        // A sampler tick with no decodable watch slots produces nothing.
+        let empty = make_entry(600, 0, 0, 0, 2, 0);
+        assert!(decode_entry(&empty, &mut state, &registry, &vec![None; 4], 0).is_none());
+    }
+
+    #[test]
+    fn test_decode_stack_rebased_by_slide() {
+        let mut state = make_state();
+        let registry = make_registry();
+        let watches = vec![None, None, None, None];
+
+        // 144-byte entry with two raw return addresses at the stack slots
+        let mut entry = make_entry(100, 1, 7, 1, 0, 0);
+        entry.resize(ENTRY_STACK0 + STACK_SLOTS * 8, 0);
+        entry[ENTRY_STACK_COUNT] = 2;
+        entry[ENTRY_STACK0..ENTRY_STACK0 + 8].copy_from_slice(&0x5000u64.to_le_bytes());
+        entry[ENTRY_STACK0 + 8..ENTRY_STACK0 + 16].copy_from_slice(&0x6000u64.to_le_bytes());
+
+        let event = decode_entry(&entry, &mut state, &registry, &watches, 0x1000).unwrap();
+        let frames = event.backtrace.unwrap();
+        let frames = frames.as_array().unwrap();
+        assert_eq!(frames.len(), 2);
+        assert_eq!(frames[0]["address"], serde_json::json!("0x4000"));
+        assert_eq!(frames[1]["address"], serde_json::json!("0x5000"));
+        // Addresses only — symbolization is deferred to query time
+        assert!(frames[0].get("functionName").is_none());
+    }
+
+    #[test]
+    fn test_decode_legacy_entry_has_no_backtrace() {
+        let mut state = make_state();
+        let registry = make_registry();
+        let watches = vec![None, None, None, None];
+
+        // 80-byte entry from a pre-stack agent: no room for stack slots
+        let event = decode_entry(
+            &make_entry(100, 1, 7, 1, 0, 0),
+            &mut state,
+            &registry,
+            &watches,
+            0x1000,
+        )
+        .unwrap();
+        assert!(event.backtrace.is_none());
+    }
+
+    #[test]
+    fn test_format_watch_value_float() {
+        let cfg = ShmWatchConfig {
+            label: "tempo".to_string(),
+            type_kind: "float".to_string(),
+            size: 8,
+            is_global: true,
+            func_ids: Default::default(),
+        };
+        let raw = 120.5f64.to_bits();
+        assert_eq!(format_watch_value(raw, &cfg), serde_json::json!(120.5));
+    }
+
+    #[test]
+    fn test_geometry_rejects_bad_payload() {
+        // header + capacity*entry must fit in size
+        let bad = serde_json::json!({
+            "size": 100, "capacity": 16384, "entrySize": 80, "headerSize": 128,
+        });
+        assert!(ShmGeometry::from_payload(&bad).is_none());
+
+        let good = serde_json::json!({
+            "size": 128 + 16384 * 80, "capacity": 16384, "entrySize": 80, "headerSize": 128,
+        });
+        let g = ShmGeometry::from_payload(&good).unwrap();
+        assert_eq!(g.capacity, 16384);
+        assert_eq!(g.entry_size, 80);
+    }
+}
@@ -73,7 +73,7 @@ unsafe fn detach_and_unref_session(
 unsafe extern "C" fn raw_on_message(
     _script: *mut frida_sys::_FridaScript,
     message: *const i8,
-    _data: *const frida_sys::_GBytes,
+    data: *const frida_sys::_GBytes,
     user_data: *mut c_void,
 ) {
     let handler = &mut *(user_data as *mut AgentMessageHandler);
@@ -103,7 +103,13 @@ unsafe extern "C" fn raw_on_message(
             // Extract the payload from `{ "type": "send", "payload": { ... } }`
             if let Some(payload) = parsed.get("payload") {
                 if let Some(inner_type) = payload.get("type").and_then(|v| v.as_str()) {
-                    handler.handle_payload(inner_type, payload);
+                    if inner_type == "read_chunk" {
+                        // Binary frame of a streaming memory read — the bytes
+                        // ride the out-of-band data payload, not the JSON.
+                        handler.handle_read_chunk(payload, data);
+                    } else {
+                        handler.handle_payload(inner_type, payload);
+                    }
                 }
             }
         }
@@ -141,16 +147,8 @@ unsafe fn session_raw_ptr(session: &frida::Session) -> *mut frida_sys::_FridaSes
     *(session as *const frida::Session as *const *mut frida_sys::_FridaSession)
 }
 
-/// Create a Frida script using frida-sys directly (bypasses frida::Script).
-/// Returns the raw script pointer.
-unsafe fn create_script_raw(
-    session_ptr: *mut frida_sys::_FridaSession,
-    source: &str,
-    language: Language,
-) -> std::result::Result<*mut frida_sys::_FridaScript, String> {
-    create_script_raw_with_options(session_ptr, source, language, false)
-}
-
+/// Create a Frida script from source using frida-sys directly (bypasses
+/// frida::Script). Returns the raw script pointer.
 unsafe fn create_script_raw_with_options(
     session_ptr: *mut frida_sys::_FridaSession,
     source: &str,
@@ -195,6 +193,121 @@ unsafe fn create_script_raw_with_options(
     Ok(script_ptr)
 }
 
+/// Process-wide cache of the agent compiled to QuickJS bytecode.
+///
+/// Compiling the ~200KB agent source inside the target adds 400-700ms before
+/// the first event — too slow for short-lived CLI processes. frida-core can
+/// only compile through a live session, so the first native session pays the
+/// compile once and every later session (including gated children) loads the
+/// cached bytecode instead. `None` means compilation failed and all sessions
+/// fall back to source. Bytecode is QuickJS-only: V8 (Node) and JSC (Bun)
+/// sessions always load source.
+static AGENT_BYTECODE: std::sync::OnceLock<Option<Vec<u8>>> = std::sync::OnceLock::new();
+
+/// Compile the embedded agent to QuickJS bytecode via the given session.
+unsafe fn compile_agent_bytecode(session_ptr: *mut frida_sys::_FridaSession) -> Option<Vec<u8>> {
+    let source_cstr = CString::new(AGENT_CODE).ok()?;
+    let opt = frida_sys::frida_script_options_new();
+    if opt.is_null() {
+        return None;
+    }
+
+    let mut error: *mut frida_sys::GError = std::ptr::null_mut();
+    let t = std::time::Instant::now();
+    let bytes = frida_sys::frida_session_compile_script_sync(
+        session_ptr,
+        source_cstr.as_ptr(),
+        opt,
+        std::ptr::null_mut(),
+        &mut error,
+    );
+    frida_sys::frida_unref(opt as *mut c_void);
+
+    if let Err(msg) = check_gerror(error) {
+        tracing::warn!("Agent bytecode compilation failed: {} — using source", msg);
+        return None;
+    }
+    if bytes.is_null() {
+        return None;
+    }
+
+    let mut size: frida_sys::gsize = 0;
+    let data = frida_sys::g_bytes_get_data(bytes, &mut size);
+    let compiled = if data.is_null() || size == 0 {
+        None
+    } else {
+        Some(std::slice::from_raw_parts(data as *const u8, size as usize).to_vec())
+    };
+    frida_sys::g_bytes_unref(bytes);
+
+    if let Some(ref b) = compiled {
+        tracing::info!(
+            "Agent compiled to {} bytes of bytecode in {:?} — cached for daemon lifetime",
+            b.len(),
+            t.elapsed()
+        );
+    }
+    compiled
+}
+
+/// Create a script from precompiled bytecode.
+unsafe fn create_script_from_bytes_raw(
+    session_ptr: *mut frida_sys::_FridaSession,
+    bytecode: &[u8],
+) -> std::result::Result<*mut frida_sys::_FridaScript, String> {
+    let gbytes = frida_sys::g_bytes_new(
+        bytecode.as_ptr() as *const c_void,
+        bytecode.len() as frida_sys::gsize,
+    );
+    let opt = frida_sys::frida_script_options_new();
+    if opt.is_null() {
+        frida_sys::g_bytes_unref(gbytes);
+        return Err("Failed to create script options".to_string());
+    }
+
+    let mut error: *mut frida_sys::GError = std::ptr::null_mut();
+    let script_ptr = frida_sys::frida_session_create_script_from_bytes_sync(
+        session_ptr,
+        gbytes,
+        opt,
+        std::ptr::null_mut(),
+        &mut error,
+    );
+    frida_sys::frida_unref(opt as *mut c_void);
+    frida_sys::g_bytes_unref(gbytes);
+
+    check_gerror(error)?;
+    if script_ptr.is_null() {
+        return Err("script_ptr is null".to_string());
+    }
+    Ok(script_ptr)
+}
+
+/// Create the agent script, preferring cached bytecode for QuickJS sessions.
+/// Falls back to source compilation on any bytecode failure (e.g. a frida-core
+/// upgrade invalidating the format mid-flight).
+unsafe fn create_agent_script_raw(
+    session_ptr: *mut frida_sys::_FridaSession,
+    language: Language,
+    is_bun: bool,
+) -> std::result::Result<*mut frida_sys::_FridaScript, String> {
+    if language == Language::Native || language == Language::Python {
+        let cached = AGENT_BYTECODE.get_or_init(|| compile_agent_bytecode(session_ptr));
+        if let Some(bytecode) = cached {
+            match create_script_from_bytes_raw(session_ptr, bytecode) {
+                Ok(ptr) => return Ok(ptr),
+                Err(e) => {
+                    tracing::warn!(
+                        "Bytecode script load failed: {} — falling back to source",
+                        e
+                    )
+                }
+            }
+        }
+    }
+    create_script_raw_with_options(session_ptr, AGENT_CODE, language, is_bun)
+}
+
 /// C callback to free the AgentMessageHandler when the signal is disconnected.
 unsafe extern "C" fn destroy_handler(data: *mut c_void, _closure: *mut frida_sys::_GClosure) {
     if !data.is_null() {
@@ -241,11 +354,43 @@ unsafe fn device_raw_ptr(device: &frida::Device) -> *mut frida_sys::_FridaDevice
     *(device as *const frida::Device as *const *mut frida_sys::_FridaDevice)
 }
 
+/// Cloneable fan-out over a session's per-shard writer channels (see
+/// `event_writer::WRITER_SHARDS`). Producers resolve their PID to a shard
+/// once, at handler construction: all events from one process stay ordered on
+/// one channel, while sibling processes in a fork storm fill independent
+/// shards instead of contending for (and dropping on) a single queue.
+#[derive(Clone)]
+pub struct ShardedEventTx {
+    shards: Arc<Vec<mpsc::Sender<Event>>>,
+}
+
+impl ShardedEventTx {
+    pub fn new(shards: Vec<mpsc::Sender<Event>>) -> Self {
+        assert!(!shards.is_empty(), "at least one writer shard required");
+        Self {
+            shards: Arc::new(shards),
+        }
+    }
+
+    /// Wrap a single channel — callers that don't shard (tests, tools).
+    pub fn single(tx: mpsc::Sender<Event>) -> Self {
+        Self::new(vec![tx])
+    }
+
+    /// The shard channel events from `pid` should use.
+    pub fn sender_for(&self, pid: u32) -> mpsc::Sender<Event> {
+        self.shards[pid as usize % self.shards.len()].clone()
+    }
+}
+
 /// Context for mapping PIDs to session info in the output callback.
 struct OutputContext {
     pid: u32,
     session_id: String,
     event_tx: mpsc::Sender<Event>,
+    /// Full shard set for the session — children forked from this process
+    /// resolve their own shard from it in `dispatch_child_spawn`.
+    shards: ShardedEventTx,
     event_counter: AtomicU64,
     start_ns: i64,
     /// Accumulated stderr output — shared with process_death_monitor for ASAN parsing.
@@ -403,6 +548,20 @@ struct AgentMessageHandler {
     /// Wall-clock epoch nanos at process start, subtracted from event timestamps
     /// to produce process-relative timestamps consistent with trace events.
     start_ns: i64,
+    /// Target PID — needed by the shm reader for /proc thread-name lookups.
+    pid: u32,
+    /// Shared-memory ring reader, created when the agent reports `shm_ready`.
+    /// None until then (and stays None when shm setup/mapping fails — the
+    /// JSON `events` path above remains the transport).
+    shm_reader: Mutex<Option<super::shm_reader::ShmReader>>,
+    /// ASLR slide reported by the agent (`shm_slide`) once it learns the
+    /// static image base. The shm reader uses it to rebase raw stack
+    /// addresses from the CModule's frame-pointer walk to static addresses.
+    aslr_slide: Arc<AtomicU64>,
+    /// Reassembly buffers for streaming memory reads, keyed by recipe label.
+    /// Large `bytes` reads arrive as binary `read_chunk` frames; buffers are
+    /// drained into the matching `read_response` (see `merge_read_chunks`).
+    read_chunks: Mutex<HashMap<String, Vec<u8>>>,
 }
 
 impl AgentMessageHandler {
@@ -425,7 +584,9 @@ impl AgentMessageHandler {
                                     self.session_id
                                 );
                             }
+                            crate::daemon::metrics::metrics().record_received(1);
                             if let Err(e) = self.event_tx.try_send(event) {
+                                crate::daemon::metrics::metrics().record_dropped(1);
                                 tracing::warn!(
                                     "Agent trace event dropped for [{}]: {}",
                                     self.session_id,
@@ -479,8 +640,19 @@ impl AgentMessageHandler {
                     .and_then(|v| v.as_f64())
                     .unwrap_or(1.0);
                 let rate_pct = (sample_rate * 100.0) as u32;
+                let aggregating = payload
+                    .get("mode")
+                    .and_then(|v| v.as_str())
+                    .map(|m| m == "aggregate")
+                    .unwrap_or(false);
 
-                if enabled {
+                if enabled && aggregating {
+                    tracing::warn!(
+                        "[{}] Hot function detected: '{}' - aggregating (periodic count/duration summaries)",
+                        self.session_id,
+                        func_name
+                    );
+                } else if enabled {
                     tracing::warn!(
                         "[{}] Hot function detected: '{}' - auto-sampling at {}%",
                         self.session_id,
@@ -513,9 +685,10 @@ impl AgentMessageHandler {
                 }
             }
             "read_response" | "eval_response" => {
+                let payload = self.merge_read_chunks(payload);
                 if let Ok(mut guard) = self.read_response.lock() {
                     if let Some(tx) = guard.take() {
-                        let _ = tx.send(payload.clone());
+                        let _ = tx.send(payload);
                     }
                 }
             }
@@ -739,11 +912,234 @@ impl AgentMessageHandler {
                     lims
                 );
             }
+            "shm_ready" => {
+                // Agent set up a shared-memory ring for trace events. Map it
+                // and start the daemon-side reader; on failure stay on the
+                // JSON `events` path (the agent never hands the ring off
+                // until the reader acknowledges via the header state field).
+                let name = payload.get("name").and_then(|v| v.as_str());
+                let geometry = super::shm_reader::ShmGeometry::from_payload(payload);
+                let ticks_to_ns = payload
+                    .get("ticksToNs")
+                    .and_then(|v| v.as_f64())
+                    .unwrap_or(1.0);
+                match (name, geometry) {
+                    (Some(name), Some(geometry)) => {
+                        match super::shm_reader::ShmReader::start(
+                            &self.session_id,
+                            self.pid,
+                            name,
+                            geometry,
+                            ticks_to_ns,
+                            self.aslr_slide.clone(),
+                            self.event_tx.clone(),
+                        ) {
+                            Ok(reader) => {
+                                tracing::info!(
+                                    "Shm event transport active for session {} ({})",
+                                    self.session_id,
+                                    name
+                                );
+                                *self.shm_reader.lock().unwrap() = Some(reader);
+                            }
+                            Err(e) => {
+                                tracing::warn!(
+                                    "Shm transport for session {} unavailable, using send() fallback: {}",
+                                    self.session_id,
+                                    e
+                                );
+                            }
+                        }
+                    }
+                    _ => {
+                        tracing::warn!(
+                            "Malformed shm_ready payload for session {}, ignoring",
+                            self.session_id
+                        );
+                    }
+                }
+            }
+            "shm_func" => {
+                // Function metadata for shm-mode decoding, sent at hook
+                // install time (never on the hot path).
+                if let Some(reader) = self.shm_reader.lock().unwrap().as_ref() {
+                    let func_id = payload.get("funcId").and_then(|v| v.as_u64());
+                    let name = payload.get("name").and_then(|v| v.as_str());
+                    if let (Some(func_id), Some(name)) = (func_id, name) {
+                        reader.register_function(
+                            func_id as u32,
+                            super::shm_reader::ShmFuncInfo {
+                                name: name.to_string(),
+                                name_raw: payload
+                                    .get("nameRaw")
+                                    .and_then(|v| v.as_str())
+                                    .map(|s| s.to_string()),
+                                source_file: payload
+                                    .get("sourceFile")
+                                    .and_then(|v| v.as_str())
+                                    .map(|s| s.to_string()),
+                                line_number: payload
+                                    .get("lineNumber")
+                                    .and_then(|v| v.as_u64())
+                                    .map(|n| n as u32),
+                            },
+                        );
+                    }
+                }
+            }
+            "shm_watches" => {
+                // Watch slot table for shm-mode decoding — mirrors the
+                // agent's resolved WatchConfigs including pattern→funcId
+                // resolution (which only the agent can perform).
+                if let Some(reader) = self.shm_reader.lock().unwrap().as_ref() {
+                    let configs: Vec<Option<super::shm_reader::ShmWatchConfig>> = payload
+                        .get("watches")
+                        .and_then(|v| v.as_array())
+                        .map(|arr| {
+                            arr.iter()
+                                .map(|w| {
+                                    let label = w.get("label")?.as_str()?.to_string();
+                                    Some(super::shm_reader::ShmWatchConfig {
+                                        label,
+                                        type_kind: w
+                                            .get("typeKind")
+                                            .and_then(|v| v.as_str())
+                                            .unwrap_or("uint")
+                                            .to_string(),
+                                        size: w.get("size").and_then(|v| v.as_u64()).unwrap_or(8)
+                                            as u8,
+                                        is_global: w
+                                            .get("isGlobal")
+                                            .and_then(|v| v.as_bool())
+                                            .unwrap_or(true),
+                                        func_ids: w
+                                            .get("funcIds")
+                                            .and_then(|v| v.as_array())
+                                            .map(|ids| {
+                                                ids.iter()
+                                                    .filter_map(|i| i.as_u64())
+                                                    .map(|i| i as u32)
+                                                    .collect()
+                                            })
+                                            .unwrap_or_default(),
+                                    })
+                                })
+                                .collect()
+                        })
+                        .unwrap_or_default();
+                    reader.set_watches(configs);
+                }
+            }
+            "shm_slide" => {
+                // ASLR slide for rebasing raw stack addresses decoded from
+                // the ring. Sent by the agent when it learns the static
+                // image base, which may land before or after shm_ready —
+                // the shared atomic covers both orderings.
+                if let Some(slide) = payload
+                    .get("slide")
+                    .and_then(|v| v.as_str())
+                    .and_then(|s| u64::from_str_radix(s.trim_start_matches("0x"), 16).ok())
+                {
+                    self.aslr_slide.store(slide, Ordering::Relaxed);
+                }
+            }
             _ => {
                 tracing::debug!("Unknown message type from agent: {}", msg_type);
             }
         }
     }
+
+    /// Stash a binary frame of a streaming memory read. The agent sends large
+    /// `bytes` reads as out-of-band chunks (never hex-in-JSON), ordered before
+    /// the `read_response` that references them by label.
+    fn handle_read_chunk(&self, payload: &serde_json::Value, data: *const frida_sys::_GBytes) {
+        let Some(label) = payload.get("label").and_then(|v| v.as_str()) else {
+            return;
+        };
+        if data.is_null() {
+            tracing::warn!("read_chunk for '{}' arrived without data payload", label);
+            return;
+        }
+        let total = payload
+            .get("totalSize")
+            .and_then(|v| v.as_u64())
+            .unwrap_or(0) as usize;
+
+        let mut size: frida_sys::gsize = 0;
+        let bytes_ptr =
+            unsafe { frida_sys::g_bytes_get_data(data as *mut frida_sys::GBytes, &mut size) };
+        if bytes_ptr.is_null() || size == 0 {
+            return;
+        }
+        let slice = unsafe { std::slice::from_raw_parts(bytes_ptr as *const u8, size as usize) };
+
+        if let Ok(mut chunks) = self.read_chunks.lock() {
+            chunks
+                .entry(label.to_string())
+                .or_insert_with(|| Vec::with_capacity(total))
+                .extend_from_slice(slice);
+        }
+    }
+
+    /// Fill `chunked` placeholders in a read_response with the hex of their
+    /// reassembled frames. Hex is produced once here — the payload never
+    /// crossed the JSON channel at 2x size, which is what made large reads
+    /// slow (and tripled daemon RSS) before.
+    fn merge_read_chunks(&self, payload: &serde_json::Value) -> serde_json::Value {
+        let mut chunks = match self.read_chunks.lock() {
+            Ok(c) => c,
+            Err(_) => return payload.clone(),
+        };
+        if chunks.is_empty() {
+            return payload.clone();
+        }
+
+        let mut payload = payload.clone();
+        if let Some(results) = payload.get_mut("results").and_then(|v| v.as_array_mut()) {
+            for result in results {
+                if !result
+                    .get("chunked")
+                    .and_then(|v| v.as_bool())
+                    .unwrap_or(false)
+                {
+                    continue;
+                }
+                let Some(label) = result
+                    .get("label")
+                    .and_then(|v| v.as_str())
+                    .map(|s| s.to_string())
+                else {
+                    continue;
+                };
+                match chunks.remove(&label) {
+                    Some(buf) => {
+                        result["value"] = serde_json::Value::String(hex_encode(&buf));
+                    }
+                    None => {
+                        result["error"] =
+                            serde_json::json!("Streaming read chunks were lost in transit");
+                    }
+                }
+            }
+        }
+        // Orphaned buffers (a read that errored mid-stream) are dropped here
+        // rather than leaking until the session ends.
+        chunks.clear();
+        payload
+    }
+}
+
+/// Lowercase hex, matching the agent's `_arrayBufferToHex` output for the
+/// non-streamed path. Table lookup: a 64MB read hex-encodes in well under
+/// 100ms, versus seconds for per-byte formatting.
+fn hex_encode(bytes: &[u8]) -> String {
+    const HEX: &[u8; 16] = b"0123456789abcdef";
+    let mut out = Vec::with_capacity(bytes.len() * 2);
+    for &b in bytes {
+        out.push(HEX[(b >> 4) as usize]);
+        out.push(HEX[(b & 0x0f) as usize]);
+    }
+    String::from_utf8(out).expect("hex output is ASCII")
 }
 
 /// Result of a hook installation attempt
@@ -753,20 +1149,37 @@ pub struct HookResult {
     pub warnings: Vec<String>,
 }
 
-/// Safety limits for hook installation.
-/// Empirically determined on ARM64 with 79MB binary:
-///   ~50 hooks: fast install (~5s), rock solid
-///   ~100 hooks: install ~10s, stable
-///   ~150+ hooks: crash risk with hot functions
-const MAX_HOOKS_PER_CALL: usize = 100;
-const CHUNK_SIZE: usize = 50;
-const TIMEOUT_PER_CHUNK_SECS: u64 = 45;
+/// Safety limit for hook installation.
+///
+/// Every hook shares one CModule listener — per-hook state is a data
+/// pointer plus rule-table slots, and the whole resolved set rides to the
+/// agent in a single message installed in one interceptor transaction. The
+/// marginal cost per hook is Frida's inline trampoline (~a page of patched
+/// code per target) and a table entry, so the ceiling is set by install
+/// latency and event volume rather than memory. Measured on ARM64 with a
+/// 79MB binary: ~100 hooks install in ~2s batched, ~1000 in ~15s. Beyond
+/// that, installs start colliding with the watchdog and broad patterns
+/// drown the event budget anyway — use rate rules and aggregation, not
+/// more hooks.
+const MAX_HOOKS_PER_CALL: usize = 1000;
+const TIMEOUT_HOOK_INSTALL_SECS: u64 = 120;
 
 /// Wrapper to move raw script pointer across threads.
 /// Safety: each session's script is only accessed by its dedicated worker thread.
 struct SendScriptPtr(*mut frida_sys::_FridaScript);
 unsafe impl Send for SendScriptPtr {}
 
+/// Raw session pointer reported back from a child-attach worker. Safe to send:
+/// ownership transfers to the coordinator, which alone detaches/unrefs it.
+struct SendSessionPtr(*mut frida_sys::_FridaSession);
+unsafe impl Send for SendSessionPtr {}
+
+/// Raw device pointer handed to child-attach workers. The coordinator joins
+/// the pool before dropping the device, so the pointer outlives every job.
+#[derive(Clone, Copy)]
+struct SendDevicePtr(*mut frida_sys::_FridaDevice);
+unsafe impl Send for SendDevicePtr {}
+
 /// Result returned by coordinator after spawning a process.
 struct SpawnResult {
     pid: u32,
@@ -784,10 +1197,13 @@ enum CoordinatorCommand {
         args: Vec<String>,
         cwd: Option<String>,
         env: Option<HashMap<String, String>>,
-        event_tx: mpsc::Sender<Event>,
+        event_shards: ShardedEventTx,
         defer_resume: bool,
         pause_notify_tx: Option<PauseNotifyTx>,
         language: Language,
+        /// When set, skip spawning: the target is already running (session
+        /// resume after a daemon restart) and we only attach to this PID.
+        attach_pid: Option<u32>,
         response: oneshot::Sender<Result<SpawnResult>>,
     },
     Resume {
@@ -803,9 +1219,13 @@ enum CoordinatorCommand {
 /// Commands for per-session worker threads (script-level operations).
 enum SessionCommand {
     AddPatterns {
-        functions: Vec<FunctionTarget>,
+        /// Full-mode and light-mode targets travel together: the whole set
+        /// goes to the agent in one message so interceptor attachment is a
+        /// single pass (Frida flushes the batch once when the handler
+        /// returns) instead of one round-trip per chunk.
+        full_functions: Vec<FunctionTarget>,
+        light_functions: Vec<FunctionTarget>,
         image_base: u64,
-        mode: HookMode,
         serialization_depth: Option<u32>,
         response: oneshot::Sender<Result<u32>>,
     },
@@ -863,6 +1283,9 @@ pub struct WatchTarget {
     pub on_patterns: Option<Vec<String>>,
     /// If true, address is already absolute (user-provided) — don't apply ASLR slide.
     pub no_slide: bool,
+    /// Time-driven sampling rate in Hz: the agent's native sampler thread
+    /// re-reads this watch at that rate, independent of traced calls.
+    pub sample_hz: Option<u32>,
 }
 
 #[derive(Clone)]
@@ -880,6 +1303,9 @@ struct FunctionTarget {
     name_raw: Option<String>,
     source_file: Option<String>,
     line_number: Option<u32>,
+    /// Argument predicate from the pattern suffix — compiled into the
+    /// native hook so non-matching calls never produce an event.
+    predicate: Option<super::hooks::ArgPredicate>,
 }
 
 impl From<&FunctionInfo> for FunctionTarget {
@@ -890,6 +1316,7 @@ impl From<&FunctionInfo> for FunctionTarget {
             name_raw: f.name_raw.clone(),
             source_file: f.source_file.clone(),
             line_number: f.line_number,
+            predicate: None,
         }
     }
 }
@@ -995,10 +1422,40 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
     // We must explicitly detach + unref them during StopSession.
     let mut session_ptrs: HashMap<u32, *mut frida_sys::_FridaSession> = HashMap::new();
 
+    // Child-attach pool: agent injection into forked children runs off the
+    // coordinator thread, so a fork storm (build tools spawning dozens of
+    // short-lived compilers) attaches in parallel instead of queueing each
+    // child behind the previous one's script load. frida-core's *_sync API is
+    // thread-safe, so workers drive the device directly via raw FFI.
+    let (attach_job_tx, attach_job_rx) = std::sync::mpsc::channel::<ChildAttachJob>();
+    let (attach_done_tx, attach_done_rx) = std::sync::mpsc::channel::<(u32, SendSessionPtr)>();
+    let attach_worker_handles = spawn_child_attach_pool(attach_job_rx);
+
     loop {
         // Check for spawn notifications (non-blocking)
         while let Ok(child_pid) = spawn_rx.try_recv() {
-            handle_child_spawn(&mut device, child_pid, &output_registry, &mut session_ptrs);
+            dispatch_child_spawn(
+                &mut device,
+                child_pid,
+                &output_registry,
+                &attach_job_tx,
+                &attach_done_tx,
+            );
+        }
+
+        // Harvest completed child attaches so StopSession can detach them.
+        // If the session was stopped while the attach was in flight, the
+        // output context is already gone — release the session immediately.
+        while let Ok((pid, session_ptr)) = attach_done_rx.try_recv() {
+            let still_active = output_registry
+                .lock()
+                .map(|reg| reg.contains_key(&pid))
+                .unwrap_or(false);
+            if still_active {
+                session_ptrs.insert(pid, session_ptr.0);
+            } else {
+                unsafe { detach_and_unref_session(session_ptr.0, pid, "late-child-attach") };
+            }
         }
 
         // Wait for commands with timeout so we periodically check for spawns
@@ -1021,24 +1478,52 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
                 args,
                 cwd,
                 env,
-                event_tx,
+                event_shards,
                 defer_resume,
                 pause_notify_tx,
                 language,
+                attach_pid,
                 response,
             } => {
                 let result = (|| -> Result<SpawnResult> {
                     let spawn_start = std::time::Instant::now();
                     let max_attempts = 5u32;
                     let is_interpreted = language != Language::Native;
-                    let needs_self_spawn = language == Language::Python;
-                    let used_device_spawn = !needs_self_spawn;
+                    let spawned_here = attach_pid.is_none();
+                    let needs_self_spawn = spawned_here && language == Language::Python;
+                    let used_device_spawn = spawned_here && !needs_self_spawn;
 
                     // -------------------------------------------------------
                     // Step 1: Spawn process — method depends on language type
                     // -------------------------------------------------------
                     let stderr_buffer_outer = Arc::new(Mutex::new(String::new()));
-                    let pid = if needs_self_spawn {
+                    let pid = if let Some(existing_pid) = attach_pid {
+                        // Re-attach path: the target survived a daemon restart
+                        // and is already running. Register an output context so
+                        // device-level stdout/stderr capture resumes, then fall
+                        // through to the common attach + script steps.
+                        let output_ctx = Arc::new(OutputContext {
+                            pid: existing_pid,
+                            session_id: session_id.clone(),
+                            event_tx: event_shards.sender_for(existing_pid),
+                            shards: event_shards.clone(),
+                            event_counter: AtomicU64::new(0),
+                            start_ns: std::time::SystemTime::now()
+                                .duration_since(std::time::UNIX_EPOCH)
+                                .unwrap_or_default()
+                                .as_nanos() as i64,
+                            stderr_buffer: stderr_buffer_outer.clone(),
+                        });
+                        if let Ok(mut reg) = output_registry.lock() {
+                            reg.insert(existing_pid, output_ctx);
+                        }
+                        tracing::info!(
+                            "Re-attaching to running PID {} (session {})",
+                            existing_pid,
+                            session_id
+                        );
+                        existing_pid
+                    } else if needs_self_spawn {
                         // Self-spawn only for Python.
                         //
                         // Frida's device.spawn() has a broken-pipe issue with
@@ -1071,6 +1556,7 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
                             ))
                         })?;
                         let pid = child.id();
+                        let event_tx = event_shards.sender_for(pid);
                         tracing::info!(
                             "Self-spawned {} with PID {} (interpreted runtime: {:?})",
                             command,
@@ -1175,6 +1661,7 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
                             pid,
                             session_id: session_id.clone(),
                             event_tx: event_tx.clone(),
+                            shards: event_shards.clone(),
                             event_counter: AtomicU64::new(0),
                             start_ns,
                             stderr_buffer: stderr_buffer_outer.clone(),
@@ -1269,7 +1756,8 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
                         let output_ctx = Arc::new(OutputContext {
                             pid,
                             session_id: session_id.clone(),
-                            event_tx: event_tx.clone(),
+                            event_tx: event_shards.sender_for(pid),
+                            shards: event_shards.clone(),
                             event_counter: AtomicU64::new(0),
                             start_ns: std::time::SystemTime::now()
                                 .duration_since(std::time::UNIX_EPOCH)
@@ -1287,6 +1775,11 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
                         pid
                     };
 
+                    // The spawned process's own shard: used by its message
+                    // handler and monitors. Children get their own in
+                    // `dispatch_child_spawn`.
+                    let event_tx = event_shards.sender_for(pid);
+
                     // -------------------------------------------------------
                     // Step 2: Attach Frida to the process (common path)
                     // -------------------------------------------------------
@@ -1346,8 +1839,13 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
                             if let Ok(mut reg) = output_registry.lock() {
                                 reg.remove(&pid);
                             }
-                            // Kill the spawned process so it doesn't linger
-                            let _ = device.kill(pid);
+                            // Kill the spawned process so it doesn't linger —
+                            // but never a pre-existing process we only attached
+                            // to (re-attach failure must not take the target
+                            // down with it).
+                            if spawned_here {
+                                let _ = device.kill(pid);
+                            }
                             tracing::warn!(
                                 "Cleaned up leaked Frida session for PID {} after spawn failure",
                                 pid
@@ -1363,23 +1861,22 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
                         .and_then(|n| n.to_str())
                         .unwrap_or("");
                     let is_bun = cmd_basename.contains("bun");
-                    let script_ptr = match unsafe {
-                        create_script_raw_with_options(raw_session, AGENT_CODE, language, is_bun)
-                    } {
-                        Ok(ptr) => ptr,
-                        Err(e) => {
-                            cleanup_session_on_error(
-                                &mut session_ptrs,
-                                &output_registry,
-                                pid,
-                                &mut device,
-                            );
-                            return Err(crate::Error::FridaAttachFailed(format!(
-                                "Script creation failed: {}",
-                                e
-                            )));
-                        }
-                    };
+                    let script_ptr =
+                        match unsafe { create_agent_script_raw(raw_session, language, is_bun) } {
+                            Ok(ptr) => ptr,
+                            Err(e) => {
+                                cleanup_session_on_error(
+                                    &mut session_ptrs,
+                                    &output_registry,
+                                    pid,
+                                    &mut device,
+                                );
+                                return Err(crate::Error::FridaAttachFailed(format!(
+                                    "Script creation failed: {}",
+                                    e
+                                )));
+                            }
+                        };
                     tracing::debug!("PERF: create_script took {:?}", t.elapsed());
 
                     let t = std::time::Instant::now();
@@ -1401,6 +1898,10 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
                             .duration_since(std::time::UNIX_EPOCH)
                             .unwrap_or_default()
                             .as_nanos() as i64,
+                        pid,
+                        shm_reader: Mutex::new(None),
+                        aslr_slide: Arc::new(AtomicU64::new(0)),
+                        read_chunks: Mutex::new(HashMap::new()),
                     };
 
                     unsafe { register_handler_raw(script_ptr, handler) };
@@ -1565,6 +2066,13 @@ fn coordinator_worker(cmd_rx: std::sync::mpsc::Receiver<CoordinatorCommand>) {
             }
         }
     }
+
+    // Attach workers hold a raw pointer to `device`; drain and join the pool
+    // before the device drops with this thread.
+    drop(attach_job_tx);
+    for handle in attach_worker_handles {
+        let _ = handle.join();
+    }
 }
 
 /// Per-session worker thread: handles script-level operations that may block.
@@ -1588,9 +2096,9 @@ fn session_worker(
 
         match cmd {
             SessionCommand::AddPatterns {
-                functions,
+                full_functions,
+                light_functions,
                 image_base,
-                mode,
                 serialization_depth,
                 response,
             } => {
@@ -1598,9 +2106,9 @@ fn session_worker(
                     raw_ptr,
                     &hooks_ready,
                     &session_id,
-                    &functions,
+                    &full_functions,
+                    &light_functions,
                     image_base,
-                    mode,
                     serialization_depth,
                 );
                 let _ = response.send(result);
@@ -1816,47 +2324,63 @@ fn handle_add_patterns(
     script_ptr: *mut frida_sys::_FridaScript,
     hooks_ready: &HooksReadySignal,
     session_id: &str,
-    functions: &[FunctionTarget],
+    full_functions: &[FunctionTarget],
+    light_functions: &[FunctionTarget],
     image_base: u64,
-    mode: HookMode,
     serialization_depth: Option<u32>,
 ) -> Result<u32> {
     tracing::info!(
-        "AddPatterns: {} functions ({:?} mode) for session {}",
-        functions.len(),
-        mode,
+        "AddPatterns: {} full + {} light functions for session {}",
+        full_functions.len(),
+        light_functions.len(),
         session_id
     );
 
-    // Split targets: native (address > 0) vs interpreted (address == 0)
+    // Split targets: native (address > 0) vs interpreted (address == 0).
+    // Both modes ride in the same message with a per-entry "mode" tag so the
+    // agent installs everything in one pass — Interceptor batches the
+    // attaches and flushes once when the handler returns.
     let mut native_funcs: Vec<serde_json::Value> = Vec::new();
     let mut interpreted_targets: Vec<serde_json::Value> = Vec::new();
 
-    for f in functions {
-        if f.address == 0 {
-            // Interpreted language target (Python, JS, etc.)
-            interpreted_targets.push(serde_json::json!({
-                "file": f.source_file,
-                "line": f.line_number,
-                "name": f.name,
-            }));
-        } else {
-            // Native binary target
-            native_funcs.push(serde_json::json!({
-                "address": format!("0x{:x}", f.address),
-                "name": f.name,
-                "nameRaw": f.name_raw,
-                "sourceFile": f.source_file,
-                "lineNumber": f.line_number,
-            }));
+    for (functions, mode_str) in [(full_functions, "full"), (light_functions, "light")] {
+        for f in functions {
+            if f.address == 0 {
+                // Interpreted language target (Python, JS, etc.)
+                interpreted_targets.push(serde_json::json!({
+                    "file": f.source_file,
+                    "line": f.line_number,
+                    "name": f.name,
+                    "mode": mode_str,
+                }));
+            } else {
+                // Native binary target
+                let mut entry = serde_json::json!({
+                    "address": format!("0x{:x}", f.address),
+                    "name": f.name,
+                    "nameRaw": f.name_raw,
+                    "sourceFile": f.source_file,
+                    "lineNumber": f.line_number,
+                    "mode": mode_str,
+                });
+                if let Some(p) = &f.predicate {
+                    // value rides as a string: JSON numbers round-trip
+                    // through f64 in the agent and would lose 64-bit values.
+                    entry["predicate"] = serde_json::json!({
+                        "arg": p.arg_index,
+                        "op": p.op.code(),
+                        "value": p.value.to_string(),
+                    });
+                }
+                native_funcs.push(entry);
+            }
         }
     }
 
     tracing::info!(
-        "Split targets: {} native + {} interpreted targets ({:?} mode)",
+        "Split targets: {} native + {} interpreted targets",
         native_funcs.len(),
-        interpreted_targets.len(),
-        mode
+        interpreted_targets.len()
     );
 
     // Debug: log first interpreted target if any
@@ -1873,15 +2397,9 @@ fn handle_add_patterns(
         *guard = Some(signal_tx);
     }
 
-    let mode_str = match mode {
-        HookMode::Full => "full",
-        HookMode::Light => "light",
-    };
-
     let mut hooks_msg = serde_json::json!({
         "type": "hooks",
         "action": "add",
-        "mode": mode_str,
     });
 
     // Add native functions if any
@@ -1910,7 +2428,7 @@ fn handle_add_patterns(
             .map_err(|e| crate::Error::Frida(format!("Failed to send hooks: {}", e)))?;
     }
 
-    match signal_rx.recv_timeout(std::time::Duration::from_secs(TIMEOUT_PER_CHUNK_SECS)) {
+    match signal_rx.recv_timeout(std::time::Duration::from_secs(TIMEOUT_HOOK_INSTALL_SECS)) {
         Ok(count) => {
             tracing::info!("Agent confirmed {} hooks active after add", count);
             Ok(count as u32)
@@ -1918,11 +2436,11 @@ fn handle_add_patterns(
         Err(_) => {
             tracing::warn!(
                 "Timed out waiting for hooks confirmation ({}s)",
-                TIMEOUT_PER_CHUNK_SECS
+                TIMEOUT_HOOK_INSTALL_SECS
             );
             Err(crate::Error::Frida(format!(
                 "Agent did not respond within {}s — hooks may not be installed",
-                TIMEOUT_PER_CHUNK_SECS
+                TIMEOUT_HOOK_INSTALL_SECS
             )))
         }
     }
@@ -1984,7 +2502,7 @@ fn handle_remove_patterns(
             .map_err(|e| crate::Error::Frida(format!("Failed to send hooks: {}", e)))?;
     }
 
-    match signal_rx.recv_timeout(std::time::Duration::from_secs(TIMEOUT_PER_CHUNK_SECS)) {
+    match signal_rx.recv_timeout(std::time::Duration::from_secs(TIMEOUT_HOOK_INSTALL_SECS)) {
         Ok(count) => {
             tracing::info!("Agent confirmed {} hooks active after remove", count);
             Ok(count as u32)
@@ -1992,7 +2510,7 @@ fn handle_remove_patterns(
         Err(_) => {
             tracing::warn!(
                 "Timed out waiting for remove confirmation ({}s)",
-                TIMEOUT_PER_CHUNK_SECS
+                TIMEOUT_HOOK_INSTALL_SECS
             );
             Ok(0)
         }
@@ -2069,6 +2587,17 @@ fn handle_set_watches(
     if !expr_watch_list.is_empty() {
         watches_msg["exprWatches"] = serde_json::json!(expr_watch_list);
     }
+    // The CModule sampler reads the whole watch table per tick, so the fastest
+    // requested rate drives it; omitting the field parks the sampler thread.
+    if let Some(hz) = watches.iter().filter_map(|w| w.sample_hz).max() {
+        let interval_us = (1_000_000 / hz.max(1)).max(1);
+        watches_msg["sampleIntervalUs"] = serde_json::json!(interval_us);
+        tracing::info!(
+            "Watch sampler enabled: {} Hz ({} µs interval)",
+            hz,
+            interval_us
+        );
+    }
 
     tracing::debug!("Posting watches message to agent");
     unsafe {
@@ -2213,13 +2742,57 @@ fn get_ppid(pid: u32) -> Option<u32> {
         })
 }
 
-/// Handle a child process spawned via fork/exec.
-/// Attaches Frida to the child, loads the agent, and registers it for output capture.
-fn handle_child_spawn(
+/// Work order for the child-attach pool: everything a worker needs to attach
+/// and inject the agent into one forked child.
+struct ChildAttachJob {
+    child_pid: u32,
+    session_id: String,
+    /// Shard-resolved sender for this child's PID.
+    event_tx: mpsc::Sender<Event>,
+    device_ptr: SendDevicePtr,
+    done_tx: std::sync::mpsc::Sender<(u32, SendSessionPtr)>,
+}
+
+/// Child-attach pool size. Sized for fork storms: enough workers that a build
+/// tool spawning compilers attaches several children concurrently, few enough
+/// that idle daemons don't carry dead weight.
+const CHILD_ATTACH_WORKERS: usize = 4;
+
+/// Spawn the child-attach worker pool, sharing one job queue.
+fn spawn_child_attach_pool(
+    job_rx: std::sync::mpsc::Receiver<ChildAttachJob>,
+) -> Vec<thread::JoinHandle<()>> {
+    let job_rx = Arc::new(Mutex::new(job_rx));
+    (0..CHILD_ATTACH_WORKERS)
+        .map(|i| {
+            let rx = Arc::clone(&job_rx);
+            thread::Builder::new()
+                .name(format!("strobe-child-attach-{}", i))
+                .spawn(move || loop {
+                    // Hold the queue lock only for the recv, not the attach.
+                    let job = match rx.lock() {
+                        Ok(guard) => guard.recv(),
+                        Err(_) => break,
+                    };
+                    match job {
+                        Ok(job) => attach_child(job),
+                        Err(_) => break, // queue closed — coordinator exiting
+                    }
+                })
+                .expect("failed to spawn child-attach worker")
+        })
+        .collect()
+}
+
+/// Resolve a gated child to its session and hand it to the attach pool.
+/// Runs on the coordinator thread; only does the registry lookup and context
+/// registration, so a fork storm never queues children behind script loads.
+fn dispatch_child_spawn(
     device: &mut frida::Device,
     child_pid: u32,
     output_registry: &OutputRegistry,
-    session_ptrs: &mut HashMap<u32, *mut frida_sys::_FridaSession>,
+    attach_job_tx: &std::sync::mpsc::Sender<ChildAttachJob>,
+    attach_done_tx: &std::sync::mpsc::Sender<(u32, SendSessionPtr)>,
 ) {
     // Find which session this child belongs to by checking the output registry.
     // Use the child's PPID to find the correct parent session.
@@ -2244,10 +2817,10 @@ fn handle_child_spawn(
                 None
             }
         });
-        ctx.map(|c| (c.session_id.clone(), c.event_tx.clone(), c.start_ns))
+        ctx.map(|c| (c.session_id.clone(), c.shards.clone(), c.start_ns))
     };
 
-    let (session_id, event_tx, start_ns) = match parent_info {
+    let (session_id, shards, start_ns) = match parent_info {
         Some(info) => info,
         None => {
             tracing::debug!(
@@ -2259,17 +2832,17 @@ fn handle_child_spawn(
         }
     };
 
-    tracing::info!(
-        "Attaching to child process {} (session: {})",
-        child_pid,
-        session_id
-    );
+    // Each child gets its own writer shard, so sibling compilers in a fork
+    // storm don't funnel through the parent's channel.
+    let event_tx = shards.sender_for(child_pid);
 
-    // Register output context for the child
+    // Register output context before the attach completes, so grandchildren
+    // forked in the meantime still resolve their session by PPID.
     let output_ctx = Arc::new(OutputContext {
         pid: child_pid,
         session_id: session_id.clone(),
         event_tx: event_tx.clone(),
+        shards,
         event_counter: AtomicU64::new(0),
         start_ns,
         stderr_buffer: Arc::new(Mutex::new(String::new())),
@@ -2278,69 +2851,121 @@ fn handle_child_spawn(
         reg.insert(child_pid, output_ctx);
     }
 
-    // Attach to child
-    match device.attach(child_pid) {
-        Ok(frida_session) => {
-            let raw_session = unsafe { session_raw_ptr(&frida_session) };
-            std::mem::forget(frida_session);
-            session_ptrs.insert(child_pid, raw_session);
-
-            // Create and load agent script in child
-            // Child processes from fork/exec use Native runtime (default)
-            match unsafe { create_script_raw(raw_session, AGENT_CODE, Language::Native) } {
-                Ok(script_ptr) => {
-                    let hooks_ready: HooksReadySignal = Arc::new(Mutex::new(None));
-                    let read_response: ReadResponseSignal = Arc::new(Mutex::new(None));
-                    let write_response: WriteResponseSignal = Arc::new(Mutex::new(None));
-                    let handler = AgentMessageHandler {
-                        event_tx: event_tx.clone(),
-                        session_id: session_id.clone(),
-                        hooks_ready: hooks_ready.clone(),
-                        read_response: read_response.clone(),
-                        write_response: write_response.clone(),
-                        crash_reported: Arc::new(AtomicBool::new(false)),
-                        pause_notify_tx: None,
-                        start_ns: std::time::SystemTime::now()
-                            .duration_since(std::time::UNIX_EPOCH)
-                            .unwrap_or_default()
-                            .as_nanos() as i64,
-                    };
-                    unsafe {
+    let job = ChildAttachJob {
+        child_pid,
+        session_id,
+        event_tx,
+        device_ptr: SendDevicePtr(unsafe { device_raw_ptr(device) }),
+        done_tx: attach_done_tx.clone(),
+    };
+    if attach_job_tx.send(job).is_err() {
+        tracing::warn!(
+            "Child-attach pool gone; resuming child {} unhooked",
+            child_pid
+        );
+        let _ = device.resume(child_pid);
+    }
+}
+
+/// Attach Frida to one forked child and load the agent. Runs on a pool worker;
+/// uses frida-core's thread-safe *_sync FFI directly since the safe `Device`
+/// wrapper lives on the coordinator thread. Always resumes the child — a
+/// failed attach must not leave it gated forever.
+fn attach_child(job: ChildAttachJob) {
+    let ChildAttachJob {
+        child_pid,
+        session_id,
+        event_tx,
+        device_ptr,
+        done_tx,
+    } = job;
+
+    tracing::info!(
+        "Attaching to child process {} (session: {})",
+        child_pid,
+        session_id
+    );
+
+    unsafe {
+        let mut error: *mut frida_sys::GError = std::ptr::null_mut();
+        let session_ptr = frida_sys::frida_device_attach_sync(
+            device_ptr.0,
+            child_pid,
+            std::ptr::null_mut(),
+            std::ptr::null_mut(),
+            &mut error,
+        );
+        match check_gerror(error) {
+            Ok(()) if !session_ptr.is_null() => {
+                // Create and load agent script in child.
+                // Child processes from fork/exec use Native runtime (default).
+                match create_agent_script_raw(session_ptr, Language::Native, false) {
+                    Ok(script_ptr) => {
+                        let hooks_ready: HooksReadySignal = Arc::new(Mutex::new(None));
+                        let read_response: ReadResponseSignal = Arc::new(Mutex::new(None));
+                        let write_response: WriteResponseSignal = Arc::new(Mutex::new(None));
+                        let handler = AgentMessageHandler {
+                            event_tx,
+                            session_id: session_id.clone(),
+                            hooks_ready: hooks_ready.clone(),
+                            read_response: read_response.clone(),
+                            write_response: write_response.clone(),
+                            crash_reported: Arc::new(AtomicBool::new(false)),
+                            pause_notify_tx: None,
+                            start_ns: std::time::SystemTime::now()
+                                .duration_since(std::time::UNIX_EPOCH)
+                                .unwrap_or_default()
+                                .as_nanos() as i64,
+                            pid: child_pid,
+                            shm_reader: Mutex::new(None),
+                            aslr_slide: Arc::new(AtomicU64::new(0)),
+                            read_chunks: Mutex::new(HashMap::new()),
+                        };
                         register_handler_raw(script_ptr, handler);
                         if let Err(e) = load_script_raw(script_ptr) {
                             tracing::error!("Failed to load script in child {}: {}", child_pid, e);
                             frida_sys::frida_unref(script_ptr as *mut std::ffi::c_void);
-                            let _ = device.resume(child_pid);
-                            return;
+                        } else {
+                            // Initialize agent in child
+                            let init_msg = serde_json::json!({
+                                "type": "initialize",
+                                "sessionId": session_id,
+                            });
+                            let _ = post_message_raw(
+                                script_ptr,
+                                &serde_json::to_string(&init_msg).unwrap(),
+                            );
+                            tracing::info!("Agent loaded in child process {}", child_pid);
                         }
                     }
-
-                    // Initialize agent in child
-                    let init_msg = serde_json::json!({
-                        "type": "initialize",
-                        "sessionId": session_id,
-                    });
-                    unsafe {
-                        let _ = post_message_raw(
-                            script_ptr,
-                            &serde_json::to_string(&init_msg).unwrap(),
-                        );
+                    Err(e) => {
+                        tracing::error!("Failed to create script in child {}: {}", child_pid, e);
                     }
-
-                    tracing::info!("Agent loaded in child process {}", child_pid);
-                }
-                Err(e) => {
-                    tracing::error!("Failed to create script in child {}: {}", child_pid, e);
                 }
+                // Hand the session to the coordinator for StopSession cleanup
+                // even when the script failed — the attach itself must be
+                // detached/unreffed eventually either way.
+                let _ = done_tx.send((child_pid, SendSessionPtr(session_ptr)));
+            }
+            Ok(()) => {
+                tracing::error!("Attach to child {} returned null session", child_pid);
+            }
+            Err(e) => {
+                tracing::error!("Failed to attach to child {}: {}", child_pid, e);
             }
         }
-        Err(e) => {
-            tracing::error!("Failed to attach to child {}: {}", child_pid, e);
+
+        let mut resume_error: *mut frida_sys::GError = std::ptr::null_mut();
+        frida_sys::frida_device_resume_sync(
+            device_ptr.0,
+            child_pid,
+            std::ptr::null_mut(),
+            &mut resume_error,
+        );
+        if let Err(e) = check_gerror(resume_error) {
+            tracing::debug!("Resume of child {}: {}", child_pid, e);
         }
     }
-
-    // Resume the child process
-    let _ = device.resume(child_pid);
 }
 
 fn parse_event(session_id: &str, json: &serde_json::Value) -> Option<Event> {
@@ -2354,6 +2979,7 @@ fn parse_event(session_id: &str, json: &serde_json::Value) -> Option<Event> {
         "pause" => EventType::Pause,
         "logpoint" => EventType::Logpoint,
         "condition_error" => EventType::ConditionError,
+        "aggregate_summary" => EventType::AggregateSummary,
         _ => return None,
     };
 
@@ -2382,6 +3008,33 @@ fn parse_event(session_id: &str, json: &serde_json::Value) -> Option<Event> {
         });
     }
 
+    if event_type == EventType::AggregateSummary {
+        return Some(Event {
+            id: json.get("id")?.as_str()?.to_string(),
+            session_id: session_id.to_string(),
+            timestamp_ns: json.get("timestampNs")?.as_i64()?,
+            thread_id: json.get("threadId")?.as_i64()?,
+            event_type,
+            function_name: json.get("functionName")?.as_str()?.to_string(),
+            function_name_raw: json
+                .get("functionNameRaw")
+                .and_then(|v| v.as_str())
+                .map(|s| s.to_string()),
+            source_file: json
+                .get("sourceFile")
+                .and_then(|v| v.as_str())
+                .map(|s| s.to_string()),
+            line_number: json
+                .get("lineNumber")
+                .and_then(|v| v.as_i64())
+                .map(|n| n as i32),
+            // Statistics payload (callCount, min/max/mean, histogram)
+            arguments: json.get("data").cloned(),
+            pid,
+            ..Event::default()
+        });
+    }
+
     if event_type == EventType::Crash {
         return Some(Event {
             id: json
@@ -2529,6 +3182,19 @@ fn parse_event(session_id: &str, json: &serde_json::Value) -> Option<Event> {
         duration_ns: json.get("durationNs").and_then(|v| v.as_i64()),
         sampled: json.get("sampled").and_then(|v| v.as_bool()),
         watch_values: json.get("watchValues").cloned(),
+        // Raw static return addresses from the agent drain's frame-pointer
+        // capture. Stored as bare address frames — symbolization is deferred
+        // to the daemon at query time. (Shm-mode entries arrive with
+        // backtrace already populated by the shm reader.)
+        backtrace: json.get("stack").and_then(|v| v.as_array()).map(|frames| {
+            serde_json::Value::Array(
+                frames
+                    .iter()
+                    .filter_map(|a| a.as_str())
+                    .map(|a| serde_json::json!({ "address": a }))
+                    .collect(),
+            )
+        }),
         pid,
         ..Event::default()
     })
@@ -2925,6 +3591,10 @@ pub struct FridaSession {
     hook_manager: HookManager,
     dwarf_handle: DwarfHandle,
     image_base: u64,
+    /// Resolved targets per pattern as last installed (true = full mode).
+    /// Snapshot source for session checkpoints — lets a restarted daemon
+    /// replay hooks by address without re-resolving against the binary.
+    resolved_hooks: HashMap<String, Vec<(FunctionTarget, bool)>>,
 }
 
 /// Spawner that communicates with the coordinator and per-session worker threads
@@ -2973,10 +3643,89 @@ impl FridaSpawner {
         env: Option<&HashMap<String, String>>,
         dwarf_handle: DwarfHandle,
         image_base: u64,
-        event_sender: mpsc::Sender<Event>,
+        event_shards: ShardedEventTx,
+        defer_resume: bool,
+        pause_notify_tx: Option<PauseNotifyTx>,
+        language: Language,
+    ) -> Result<u32> {
+        self.spawn_inner(
+            session_id,
+            command,
+            args,
+            cwd,
+            project_root,
+            env,
+            dwarf_handle,
+            image_base,
+            event_shards,
+            defer_resume,
+            pause_notify_tx,
+            language,
+            None,
+        )
+        .await
+    }
+
+    /// Re-attach to a still-running target after a daemon restart. Skips the
+    /// spawn step entirely — the coordinator attaches to `pid`, injects a
+    /// fresh agent script, and the session gets the same worker/state setup
+    /// as a normal launch. Hook replay is a separate step (see
+    /// `replay_hooks`); a failed re-attach never kills the target.
+    #[allow(clippy::too_many_arguments)]
+    pub async fn reattach(
+        &self,
+        session_id: &str,
+        binary_path: &str,
+        project_root: &str,
+        pid: u32,
+        dwarf_handle: DwarfHandle,
+        image_base: u64,
+        event_shards: ShardedEventTx,
+        pause_notify_tx: Option<PauseNotifyTx>,
+        language: Language,
+    ) -> Result<u32> {
+        self.spawn_inner(
+            session_id,
+            binary_path,
+            &[],
+            None,
+            project_root,
+            None,
+            dwarf_handle,
+            image_base,
+            event_shards,
+            false,
+            pause_notify_tx,
+            language,
+            Some(pid),
+        )
+        .await
+    }
+
+    /// Whether this spawner has live worker state for a session.
+    pub fn has_session(&self, session_id: &str) -> bool {
+        self.session_workers
+            .read()
+            .unwrap()
+            .contains_key(session_id)
+    }
+
+    #[allow(clippy::too_many_arguments)]
+    async fn spawn_inner(
+        &self,
+        session_id: &str,
+        command: &str,
+        args: &[String],
+        cwd: Option<&str>,
+        project_root: &str,
+        env: Option<&HashMap<String, String>>,
+        dwarf_handle: DwarfHandle,
+        image_base: u64,
+        event_shards: ShardedEventTx,
         defer_resume: bool,
         pause_notify_tx: Option<PauseNotifyTx>,
         language: Language,
+        attach_pid: Option<u32>,
     ) -> Result<u32> {
         let (response_tx, response_rx) = oneshot::channel();
 
@@ -2987,10 +3736,11 @@ impl FridaSpawner {
                 args: args.to_vec(),
                 cwd: cwd.map(|s| s.to_string()),
                 env: env.cloned(),
-                event_tx: event_sender,
+                event_shards,
                 defer_resume,
                 pause_notify_tx,
                 language,
+                attach_pid,
                 response: response_tx,
             })
             .map_err(|_| crate::Error::Frida("Coordinator thread died".to_string()))?;
@@ -3032,6 +3782,7 @@ impl FridaSpawner {
             hook_manager: HookManager::new(),
             dwarf_handle,
             image_base,
+            resolved_hooks: HashMap::new(),
         };
 
         self.sessions
@@ -3064,6 +3815,12 @@ impl FridaSpawner {
         serialization_depth: Option<u32>,
         resolver: Option<&dyn crate::symbols::SymbolResolver>,
     ) -> Result<HookResult> {
+        // Validate predicate syntax up front — before the pattern strings
+        // are recorded as active.
+        for pattern in patterns {
+            super::hooks::split_pattern_predicate(pattern)?;
+        }
+
         // Brief write lock: update hook_manager state and extract session data
         let (mut dwarf_handle, image_base, project_root) = {
             let mut sessions = self.sessions.write().unwrap();
@@ -3081,21 +3838,40 @@ impl FridaSpawner {
         // Group functions by mode — no lock held during expensive DWARF/resolver work
         let mut full_funcs: Vec<FunctionTarget> = Vec::new();
         let mut light_funcs: Vec<FunctionTarget> = Vec::new();
+        let mut warnings: Vec<String> = Vec::new();
+        // Per-pattern resolved sets, recorded for session checkpoints.
+        let mut resolved_by_pattern: Vec<(String, Vec<(FunctionTarget, bool)>)> = Vec::new();
 
         // Use SymbolResolver if available, otherwise fall back to DWARF
         if let Some(resolver) = resolver {
             use std::path::Path;
             for pattern in patterns {
-                let targets = resolver.resolve_pattern(pattern, Path::new(&project_root))?;
-                let mode = HookManager::classify_with_count(pattern, targets.len());
+                // Predicates are a native-hook feature; interpreted tracers
+                // can't evaluate them, so resolve the base and warn.
+                let (base, predicate) = super::hooks::split_pattern_predicate(pattern)?;
+                let targets = resolver.resolve_pattern(&base, Path::new(&project_root))?;
+                let mode = HookManager::classify_with_count(&base, targets.len());
                 tracing::info!(
                     "Pattern '{}' -> {:?} mode ({} targets, resolver)",
                     pattern,
                     mode,
                     targets.len()
                 );
+                if predicate.is_some()
+                    && targets
+                        .iter()
+                        .any(|t| matches!(t, crate::symbols::ResolvedTarget::SourceLocation { .. }))
+                {
+                    warnings.push(format!(
+                        "Pattern '{}': argument predicates only apply to native hooks — \
+                         interpreted targets are traced unfiltered.",
+                        pattern
+                    ));
+                }
 
-                let target_list = if mode == HookMode::Full {
+                let is_full = mode == HookMode::Full;
+                let mut entry: Vec<(FunctionTarget, bool)> = Vec::new();
+                let target_list = if is_full {
                     &mut full_funcs
                 } else {
                     &mut light_funcs
@@ -3103,13 +3879,16 @@ impl FridaSpawner {
                 for target in targets {
                     match target {
                         crate::symbols::ResolvedTarget::SourceLocation { file, line, name } => {
-                            target_list.push(FunctionTarget {
+                            let t = FunctionTarget {
                                 address: 0, // No address for interpreted
                                 name: name.clone(),
                                 name_raw: Some(name.clone()),
                                 source_file: Some(file),
                                 line_number: Some(line),
-                            });
+                                predicate: None,
+                            };
+                            entry.push((t.clone(), is_full));
+                            target_list.push(t);
                         }
                         crate::symbols::ResolvedTarget::Address {
                             address,
@@ -3127,23 +3906,28 @@ impl FridaSpawner {
                                 );
                                 continue;
                             }
-                            target_list.push(FunctionTarget {
+                            let t = FunctionTarget {
                                 address,
                                 name: name.clone(),
                                 name_raw: name_raw.clone(),
                                 source_file: file.clone(),
                                 line_number: line,
-                            });
+                                predicate: predicate.clone(),
+                            };
+                            entry.push((t.clone(), is_full));
+                            target_list.push(t);
                         }
                     }
                 }
+                resolved_by_pattern.push((pattern.clone(), entry));
             }
         } else {
             // For native binaries (C++/Rust) - use DWARF
             let dwarf = dwarf_handle.get().await?;
             for pattern in patterns {
-                let matches: Vec<&FunctionInfo> = resolve_pattern(&dwarf, pattern, &project_root);
-                let mode = HookManager::classify_with_count(pattern, matches.len());
+                let (base, predicate) = super::hooks::split_pattern_predicate(pattern)?;
+                let matches: Vec<&FunctionInfo> = resolve_pattern(&dwarf, &base, &project_root);
+                let mode = HookManager::classify_with_count(&base, matches.len());
                 tracing::info!(
                     "Pattern '{}' -> {:?} mode ({} functions, DWARF)",
                     pattern,
@@ -3151,7 +3935,9 @@ impl FridaSpawner {
                     matches.len()
                 );
 
-                let target = if mode == HookMode::Full {
+                let is_full = mode == HookMode::Full;
+                let mut entry: Vec<(FunctionTarget, bool)> = Vec::new();
+                let target = if is_full {
                     &mut full_funcs
                 } else {
                     &mut light_funcs
@@ -3161,13 +3947,27 @@ impl FridaSpawner {
                         tracing::debug!("Skipping unhookable function {} (low_pc 0x0)", func.name);
                         continue;
                     }
-                    target.push(FunctionTarget::from(func));
+                    let mut t = FunctionTarget::from(func);
+                    t.predicate = predicate.clone();
+                    entry.push((t.clone(), is_full));
+                    target.push(t);
+                }
+                resolved_by_pattern.push((pattern.clone(), entry));
+            }
+        }
+
+        // Record the resolved sets so checkpoints can replay them by address
+        // after a daemon restart (see snapshot_resolved_hooks).
+        {
+            let mut sessions = self.sessions.write().unwrap();
+            if let Some(session) = sessions.get_mut(session_id) {
+                for (pattern, entry) in resolved_by_pattern {
+                    session.resolved_hooks.insert(pattern, entry);
                 }
             }
         }
 
         let matched = (full_funcs.len() + light_funcs.len()) as u32;
-        let mut warnings: Vec<String> = Vec::new();
 
         // Enforce hook cap — truncate light funcs first (cheaper to skip), then full
         let total = full_funcs.len() + light_funcs.len();
@@ -3194,35 +3994,26 @@ impl FridaSpawner {
             );
         }
 
-        // image_base already extracted above from sessions lock
-        let mut total_hooks = 0u32;
-
-        // Send chunks for both modes (serialization_depth only on the first chunk overall)
-        let mut depth_sent = false;
-        let batches: [(Vec<FunctionTarget>, HookMode); 2] =
-            [(full_funcs, HookMode::Full), (light_funcs, HookMode::Light)];
-
-        'outer: for (funcs, mode) in &batches {
-            for chunk in funcs.chunks(CHUNK_SIZE) {
-                let depth = if !depth_sent {
-                    depth_sent = true;
-                    serialization_depth
-                } else {
-                    None
-                };
-                match self
-                    .send_add_chunk(session_id, chunk.to_vec(), image_base, *mode, depth)
-                    .await
-                {
-                    // activeCount is the total hooks active (not delta), so use latest value
-                    Ok(count) => total_hooks = count,
-                    Err(e) => {
-                        warnings.push(format!("Hook installation error: {}", e));
-                        break 'outer;
-                    }
-                }
+        // image_base already extracted above from sessions lock.
+        // Single round-trip: the entire resolved set (both modes) goes to
+        // the agent in one message, so the full hook budget installs in one
+        // interceptor pass instead of paying a confirmation wait per chunk.
+        let total_hooks = match self
+            .send_add_bulk(
+                session_id,
+                full_funcs,
+                light_funcs,
+                image_base,
+                serialization_depth,
+            )
+            .await
+        {
+            Ok(count) => count,
+            Err(e) => {
+                warnings.push(format!("Hook installation error: {}", e));
+                0
             }
-        }
+        };
 
         Ok(HookResult {
             installed: total_hooks,
@@ -3231,12 +4022,12 @@ impl FridaSpawner {
         })
     }
 
-    async fn send_add_chunk(
+    async fn send_add_bulk(
         &self,
         session_id: &str,
-        functions: Vec<FunctionTarget>,
+        full_functions: Vec<FunctionTarget>,
+        light_functions: Vec<FunctionTarget>,
         image_base: u64,
-        mode: HookMode,
         serialization_depth: Option<u32>,
     ) -> Result<u32> {
         let (response_tx, response_rx) = oneshot::channel();
@@ -3248,9 +4039,9 @@ impl FridaSpawner {
                 .ok_or_else(|| crate::Error::SessionNotFound(session_id.to_string()))?;
             worker_tx
                 .send(SessionCommand::AddPatterns {
-                    functions,
+                    full_functions,
+                    light_functions,
                     image_base,
-                    mode,
                     serialization_depth,
                     response: response_tx,
                 })
@@ -3262,6 +4053,121 @@ impl FridaSpawner {
             .map_err(|_| crate::Error::Frida("Session worker response lost".to_string()))?
     }
 
+    /// Flattened snapshot of the session's resolved hooks in checkpoint
+    /// shape. `None` when the session has no Frida state.
+    pub fn snapshot_resolved_hooks(
+        &self,
+        session_id: &str,
+    ) -> Option<Vec<crate::db::HookCheckpoint>> {
+        let sessions = self.sessions.read().unwrap();
+        let session = sessions.get(session_id)?;
+        let mut hooks = Vec::new();
+        for (pattern, entries) in &session.resolved_hooks {
+            for (target, full_mode) in entries {
+                hooks.push(crate::db::HookCheckpoint {
+                    pattern: pattern.clone(),
+                    address: target.address,
+                    name: target.name.clone(),
+                    name_raw: target.name_raw.clone(),
+                    source_file: target.source_file.clone(),
+                    line_number: target.line_number,
+                    full_mode: *full_mode,
+                    predicate: target.predicate.clone(),
+                });
+            }
+        }
+        Some(hooks)
+    }
+
+    /// Re-install a checkpointed hook set by address in one batched agent
+    /// round-trip, skipping pattern resolution entirely. Used on session
+    /// resume when the binary fingerprint is unchanged, so a daemon restart
+    /// doesn't pay the DWARF wait again.
+    pub async fn replay_hooks(
+        &self,
+        session_id: &str,
+        hooks: &[crate::db::HookCheckpoint],
+        serialization_depth: Option<u32>,
+    ) -> Result<HookResult> {
+        let mut full_funcs: Vec<FunctionTarget> = Vec::new();
+        let mut light_funcs: Vec<FunctionTarget> = Vec::new();
+        let mut by_pattern: HashMap<String, Vec<(FunctionTarget, bool)>> = HashMap::new();
+        for hook in hooks {
+            let target = FunctionTarget {
+                address: hook.address,
+                name: hook.name.clone(),
+                name_raw: hook.name_raw.clone(),
+                source_file: hook.source_file.clone(),
+                line_number: hook.line_number,
+                predicate: hook.predicate.clone(),
+            };
+            by_pattern
+                .entry(hook.pattern.clone())
+                .or_default()
+                .push((target.clone(), hook.full_mode));
+            if hook.full_mode {
+                full_funcs.push(target);
+            } else {
+                light_funcs.push(target);
+            }
+        }
+        let matched = (full_funcs.len() + light_funcs.len()) as u32;
+
+        // Same cap as add_patterns — checkpoints record pre-cap resolution
+        let mut warnings: Vec<String> = Vec::new();
+        let total = full_funcs.len() + light_funcs.len();
+        if total > MAX_HOOKS_PER_CALL {
+            let excess = total - MAX_HOOKS_PER_CALL;
+            let light_trim = excess.min(light_funcs.len());
+            light_funcs.truncate(light_funcs.len() - light_trim);
+            let remaining_excess = excess - light_trim;
+            if remaining_excess > 0 {
+                full_funcs.truncate(full_funcs.len() - remaining_excess);
+            }
+            warnings.push(format!(
+                "Checkpoint contains {} hooks (limit: {}). Only {} were replayed.",
+                matched,
+                MAX_HOOKS_PER_CALL,
+                full_funcs.len() + light_funcs.len()
+            ));
+        }
+
+        // Brief write lock: restore pattern/resolution state, grab image_base
+        let image_base = {
+            let mut sessions = self.sessions.write().unwrap();
+            let session = sessions
+                .get_mut(session_id)
+                .ok_or_else(|| crate::Error::SessionNotFound(session_id.to_string()))?;
+            let patterns: Vec<String> = by_pattern.keys().cloned().collect();
+            session.hook_manager.add_patterns(&patterns);
+            session.resolved_hooks.extend(by_pattern);
+            session.image_base
+        };
+
+        let installed = match self
+            .send_add_bulk(
+                session_id,
+                full_funcs,
+                light_funcs,
+                image_base,
+                serialization_depth,
+            )
+            .await
+        {
+            Ok(count) => count,
+            Err(e) => {
+                warnings.push(format!("Hook installation error: {}", e));
+                0
+            }
+        };
+
+        Ok(HookResult {
+            installed,
+            matched,
+            warnings,
+        })
+    }
+
     pub async fn remove_patterns(
         &self,
         session_id: &str,
@@ -3283,7 +4189,10 @@ impl FridaSpawner {
             // For interpreted languages (Python, etc.) — use SymbolResolver
             use std::path::Path;
             for pattern in patterns {
-                let targets = resolver.resolve_pattern(pattern, Path::new(&project_root))?;
+                // Removal resolves the base pattern; the predicate suffix
+                // only affects what the hook records, not what it targets.
+                let (base, _) = super::hooks::split_pattern_predicate(pattern)?;
+                let targets = resolver.resolve_pattern(&base, Path::new(&project_root))?;
                 for target in targets {
                     match target {
                         crate::symbols::ResolvedTarget::SourceLocation { file, line, name } => {
@@ -3293,6 +4202,7 @@ impl FridaSpawner {
                                 name_raw: Some(name.clone()),
                                 source_file: Some(file),
                                 line_number: Some(line),
+                                predicate: None,
                             });
                         }
                         crate::symbols::ResolvedTarget::Address {
@@ -3308,6 +4218,7 @@ impl FridaSpawner {
                                 name_raw: name_raw.clone(),
                                 source_file: file.clone(),
                                 line_number: line,
+                                predicate: None,
                             });
                         }
                     }
@@ -3317,17 +4228,21 @@ impl FridaSpawner {
             // For native binaries — use DWARF
             let dwarf = dwarf_handle.get().await?;
             for pattern in patterns {
-                for func in resolve_pattern(&dwarf, pattern, &project_root) {
+                let (base, _) = super::hooks::split_pattern_predicate(pattern)?;
+                for func in resolve_pattern(&dwarf, &base, &project_root) {
                     functions.push(FunctionTarget::from(func));
                 }
             }
         }
 
-        // Brief write lock to update hook_manager
+        // Brief write lock to update hook_manager and drop checkpoint state
         {
             let mut sessions = self.sessions.write().unwrap();
             if let Some(session) = sessions.get_mut(session_id) {
                 session.hook_manager.remove_patterns(patterns);
+                for pattern in patterns {
+                    session.resolved_hooks.remove(pattern);
+                }
             }
         }
 
@@ -3863,6 +4778,31 @@ mod tests {
         assert_eq!(rx.recv().unwrap(), 100);
     }
 
+    #[test]
+    fn test_sharded_event_tx_routes_by_pid() {
+        let (tx_a, mut rx_a) = mpsc::channel(10);
+        let (tx_b, mut rx_b) = mpsc::channel(10);
+        let shards = ShardedEventTx::new(vec![tx_a, tx_b]);
+
+        // Same PID always lands on the same shard; adjacent PIDs alternate.
+        shards.sender_for(100).try_send(Event::default()).unwrap();
+        shards.sender_for(101).try_send(Event::default()).unwrap();
+        shards.sender_for(100).try_send(Event::default()).unwrap();
+
+        assert!(rx_a.try_recv().is_ok());
+        assert!(rx_a.try_recv().is_ok());
+        assert!(rx_a.try_recv().is_err());
+        assert!(rx_b.try_recv().is_ok());
+
+        // A single-shard wrapper routes everything to its one channel.
+        let (tx, mut rx) = mpsc::channel(10);
+        let single = ShardedEventTx::single(tx);
+        single.sender_for(7).try_send(Event::default()).unwrap();
+        single.sender_for(8).try_send(Event::default()).unwrap();
+        assert!(rx.try_recv().is_ok());
+        assert!(rx.try_recv().is_ok());
+    }
+
     // --- AgentMessageHandler tests ---
 
     fn make_handler() -> (AgentMessageHandler, mpsc::Receiver<Event>, HooksReadySignal) {
@@ -3879,6 +4819,10 @@ mod tests {
             crash_reported: Arc::new(AtomicBool::new(false)),
             pause_notify_tx: None,
             start_ns: 1_000_000_000, // 1s offset for test determinism
+            pid: 1234,
+            shm_reader: Mutex::new(None),
+            aslr_slide: Arc::new(AtomicU64::new(0)),
+            read_chunks: Mutex::new(HashMap::new()),
         };
         (handler, event_rx, hooks_ready)
     }
@@ -3905,6 +4849,36 @@ mod tests {
         assert_eq!(count, 512);
     }
 
+    #[test]
+    fn test_merge_read_chunks_fills_placeholder() {
+        let (handler, _event_rx, _hooks_ready) = make_handler();
+        handler
+            .read_chunks
+            .lock()
+            .unwrap()
+            .insert("buf".to_string(), vec![0xde, 0xad, 0xbe, 0xef]);
+
+        let payload = json!({
+            "type": "read_response",
+            "results": [
+                { "label": "buf", "chunked": true, "totalSize": 4, "isBytes": true },
+                { "label": "x", "value": 7 }
+            ]
+        });
+        let merged = handler.merge_read_chunks(&payload);
+
+        assert_eq!(merged["results"][0]["value"], "deadbeef");
+        assert_eq!(merged["results"][1]["value"], 7);
+        // Buffers are drained; nothing leaks across reads
+        assert!(handler.read_chunks.lock().unwrap().is_empty());
+    }
+
+    #[test]
+    fn test_hex_encode_matches_agent_format() {
+        assert_eq!(hex_encode(&[]), "");
+        assert_eq!(hex_encode(&[0x00, 0x0f, 0xa5, 0xff]), "000fa5ff");
+    }
+
     #[test]
     fn test_handler_hooks_updated_no_signal_armed() {
         let (handler, _event_rx, _hooks_ready) = make_handler();
@@ -3972,6 +4946,10 @@ mod tests {
             crash_reported: Arc::new(AtomicBool::new(false)),
             pause_notify_tx: Some(pause_tx),
             start_ns: 1_000_000_000,
+            pid: 1234,
+            shm_reader: Mutex::new(None),
+            aslr_slide: Arc::new(AtomicU64::new(0)),
+            read_chunks: Mutex::new(HashMap::new()),
         };
 
         // Simulate a "paused" message from agent
@@ -4038,6 +5016,10 @@ mod tests {
             crash_reported: Arc::new(AtomicBool::new(false)),
             pause_notify_tx: Some(pause_tx),
             start_ns: 1_000_000_000,
+            pid: 1234,
+            shm_reader: Mutex::new(None),
+            aslr_slide: Arc::new(AtomicU64::new(0)),
+            read_chunks: Mutex::new(HashMap::new()),
         };
 
         let payload = json!({
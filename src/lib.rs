@@ -7,6 +7,7 @@ pub mod error;
 pub mod frida_collector;
 pub mod install;
 pub mod mcp;
+pub mod profiler;
 pub mod setup_vision;
 pub mod symbols;
 pub mod test;
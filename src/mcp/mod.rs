@@ -49,6 +49,7 @@ mod tests {
             offset: None,
             verbose: Some(true),
             after_event_id: None,
+            before_event_id: None,
         };
 
         let json = serde_json::to_string(&req).unwrap();
@@ -76,6 +77,7 @@ mod tests {
             label: None,
             expr: None,
             on: Some(vec!["NoteOn".to_string()]),
+            sample_hz: None,
         };
         let json = serde_json::to_string(&target).unwrap();
         assert!(json.contains("gClock->counter"));
@@ -137,6 +139,7 @@ mod tests {
             label: Some("counter".to_string()),
             expr: None,
             on: Some(vec!["audio::process".to_string(), "midi::*".to_string()]),
+            sample_hz: None,
         };
 
         assert_eq!(watch_with_on.on.as_ref().unwrap().len(), 2);
@@ -149,6 +152,7 @@ mod tests {
             label: Some("tempo".to_string()),
             expr: None,
             on: None,
+            sample_hz: None,
         };
         assert!(global_watch.on.is_none());
 
@@ -170,6 +174,7 @@ mod tests {
                 label: None,
                 expr: None,
                 on: None,
+                sample_hz: None,
             })
             .collect();
 
@@ -206,6 +211,7 @@ mod tests {
                     label: Some("test".to_string()),
                     expr: Some(long_expr),
                     on: None,
+                    sample_hz: None,
                 }]),
                 remove: None,
             }),
@@ -234,6 +240,7 @@ mod tests {
                     label: Some("test".to_string()),
                     expr: Some(deep_expr.to_string()),
                     on: None,
+                    sample_hz: None,
                 }]),
                 remove: None,
             }),
@@ -246,6 +253,34 @@ mod tests {
         assert!(result.unwrap_err().to_string().contains("depth"));
     }
 
+    #[test]
+    fn test_watch_sample_hz_validation() {
+        let make = |hz| DebugTraceRequest {
+            session_id: Some("test".to_string()),
+            add: None,
+            remove: None,
+            watches: Some(WatchUpdate {
+                add: Some(vec![WatchTarget {
+                    variable: Some("gPhase".to_string()),
+                    address: None,
+                    type_hint: None,
+                    label: None,
+                    expr: None,
+                    on: None,
+                    sample_hz: hz,
+                }]),
+                remove: None,
+            }),
+            project_root: None,
+            serialization_depth: None,
+        };
+
+        assert!(make(None).validate().is_ok());
+        assert!(make(Some(10_000)).validate().is_ok());
+        assert!(make(Some(0)).validate().is_err());
+        assert!(make(Some(1_000_000)).validate().is_err());
+    }
+
     #[test]
     fn test_valid_trace_request() {
         let req = DebugTraceRequest {
@@ -260,6 +295,7 @@ mod tests {
                     label: Some("counter".to_string()),
                     expr: None,
                     on: Some(vec!["process::*".to_string()]),
+                    sample_hz: None,
                 }]),
                 remove: None,
             }),
@@ -148,6 +148,12 @@ pub struct WatchTarget {
     /// If omitted, watch is global (captured on all traced functions).
     #[serde(skip_serializing_if = "Option::is_none")]
     pub on: Option<Vec<String>>,
+    /// Optional time-driven sampling rate in Hz. The agent's native sampler
+    /// thread re-reads the watched memory at this rate and records the values
+    /// as variable_snapshot events, independent of traced calls. Only applies
+    /// to variable/address watches (not JS expression watches).
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub sample_hz: Option<u32>,
 }
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -187,6 +193,9 @@ pub struct DebugTraceResponse {
 // Validation limits
 pub const MAX_WATCHES_PER_SESSION: usize = 32;
 pub const MAX_WATCH_EXPRESSION_LENGTH: usize = 256;
+/// Sampler granularity bottoms out around 20µs of usleep + read overhead,
+/// so rates past 50kHz only burn CPU without adding samples.
+pub const MAX_WATCH_SAMPLE_HZ: u32 = 50_000;
 pub const MAX_WATCH_EXPRESSION_DEPTH: usize = 4;
 pub const MAX_BREAKPOINTS_PER_SESSION: usize = 50;
 pub const MAX_LOGPOINTS_PER_SESSION: usize = 100;
@@ -242,6 +251,14 @@ impl DebugTraceRequest {
                     if let Some(ref var) = watch.variable {
                         validate_watch_field(var, "variable")?;
                     }
+                    if let Some(hz) = watch.sample_hz {
+                        if hz == 0 || hz > MAX_WATCH_SAMPLE_HZ {
+                            return Err(crate::Error::ValidationError(format!(
+                                "sampleHz must be between 1 and {}",
+                                MAX_WATCH_SAMPLE_HZ
+                            )));
+                        }
+                    }
                 }
             }
         }
@@ -264,6 +281,7 @@ pub enum EventTypeFilter {
     Pause,
     Logpoint,
     ConditionError,
+    AggregateSummary,
 }
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -333,6 +351,11 @@ pub struct DebugQueryRequest {
     /// Cursor: return only events with rowid > after_event_id (for incremental polling)
     #[serde(skip_serializing_if = "Option::is_none")]
     pub after_event_id: Option<i64>,
+    /// Keyset cursor: return only events with rowid < before_event_id.
+    /// Pass the previous page's firstEventId to page newest→oldest at
+    /// constant cost; offset degrades linearly with depth.
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub before_event_id: Option<i64>,
 }
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -347,6 +370,9 @@ pub struct DebugQueryResponse {
     /// Highest event rowid in this response (use as next cursor)
     #[serde(skip_serializing_if = "Option::is_none")]
     pub last_event_id: Option<i64>,
+    /// Lowest event rowid in this response (use as beforeEventId for the next older page)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub first_event_id: Option<i64>,
     /// True if FIFO eviction happened since the cursor position
     #[serde(skip_serializing_if = "Option::is_none")]
     pub events_dropped: Option<bool>,
@@ -597,8 +623,16 @@ pub struct DebugTestRequest {
     /// Use when automatic symbol resolution fails in complex projects.
     #[serde(skip_serializing_if = "Option::is_none")]
     pub symbols_path: Option<String>,
+    /// Split the suite into N shards run as parallel processes (2-16).
+    /// Requires a framework that can enumerate tests (catch2, gtest) and
+    /// a test binary via 'command'.
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub shards: Option<u32>,
 }
 
+// Validation limit for debug_test sharding
+pub const MAX_TEST_SHARDS: u32 = 16;
+
 impl DebugTestRequest {
     pub fn validate(&self) -> crate::Result<()> {
         match self.action.as_ref().unwrap_or(&TestAction::Run) {
@@ -615,6 +649,24 @@ impl DebugTestRequest {
                         "projectRoot is required for action: 'run'".to_string(),
                     ));
                 }
+                if let Some(shards) = self.shards {
+                    if shards < 2 || shards > MAX_TEST_SHARDS {
+                        return Err(crate::Error::ValidationError(format!(
+                            "shards must be between 2 and {}",
+                            MAX_TEST_SHARDS
+                        )));
+                    }
+                    if self.command.is_none() {
+                        return Err(crate::Error::ValidationError(
+                            "shards requires 'command' (test binary path) so tests can be enumerated".to_string(),
+                        ));
+                    }
+                    if self.test.is_some() {
+                        return Err(crate::Error::ValidationError(
+                            "shards cannot be combined with 'test' (single-test run)".to_string(),
+                        ));
+                    }
+                }
             }
         }
         Ok(())
@@ -1301,6 +1353,7 @@ pub enum SessionAction {
     Stop,
     List,
     Delete,
+    Resume,
 }
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -1316,7 +1369,10 @@ pub struct DebugSessionRequest {
 impl DebugSessionRequest {
     pub fn validate(&self) -> crate::Result<()> {
         match self.action {
-            SessionAction::Status | SessionAction::Stop | SessionAction::Delete => {
+            SessionAction::Status
+            | SessionAction::Stop
+            | SessionAction::Delete
+            | SessionAction::Resume => {
                 if self.session_id.as_ref().map_or(true, |s| s.is_empty()) {
                     return Err(crate::Error::ValidationError(format!(
                         "sessionId is required for action: {:?}",
@@ -1403,6 +1459,63 @@ pub struct CrashSummary {
     pub throw_top_frame: Option<String>,
 }
 
+// ============ debug_profile ============
+
+// Validation limits for debug_profile
+pub const MIN_PROFILE_DURATION_MS: u32 = 100;
+pub const MAX_PROFILE_DURATION_MS: u32 = 60000;
+pub const DEFAULT_PROFILE_DURATION_MS: u32 = 5000;
+pub const MIN_PROFILE_FREQUENCY_HZ: u32 = 1;
+pub const MAX_PROFILE_FREQUENCY_HZ: u32 = 1000;
+pub const DEFAULT_PROFILE_FREQUENCY_HZ: u32 = 99;
+
+#[derive(Debug, Clone, Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+pub struct DebugProfileRequest {
+    pub session_id: String,
+    /// How long to sample, in milliseconds (default 5000)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub duration_ms: Option<u32>,
+    /// Target sampling frequency in Hz (default 99 — avoids lockstep with timers)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub frequency_hz: Option<u32>,
+}
+
+impl DebugProfileRequest {
+    pub fn validate(&self) -> crate::Result<()> {
+        if let Some(duration) = self.duration_ms {
+            if duration < MIN_PROFILE_DURATION_MS || duration > MAX_PROFILE_DURATION_MS {
+                return Err(crate::Error::ValidationError(format!(
+                    "durationMs must be between {} and {}",
+                    MIN_PROFILE_DURATION_MS, MAX_PROFILE_DURATION_MS
+                )));
+            }
+        }
+        if let Some(hz) = self.frequency_hz {
+            if hz < MIN_PROFILE_FREQUENCY_HZ || hz > MAX_PROFILE_FREQUENCY_HZ {
+                return Err(crate::Error::ValidationError(format!(
+                    "frequencyHz must be between {} and {}",
+                    MIN_PROFILE_FREQUENCY_HZ, MAX_PROFILE_FREQUENCY_HZ
+                )));
+            }
+        }
+        Ok(())
+    }
+}
+
+#[derive(Debug, Clone, Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+pub struct DebugProfileResponse {
+    /// Number of completed sampling rounds (each round captures all threads)
+    pub samples: u64,
+    pub duration_ms: u32,
+    pub frequency_hz: u32,
+    /// Folded stack lines ("root;mid;leaf count"), hottest first —
+    /// paste directly into flamegraph.pl or speedscope
+    pub folded: Vec<String>,
+    pub next_steps: String,
+}
+
 // ============ debug_ui ============
 
 #[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
@@ -1431,6 +1544,10 @@ pub struct DebugUiRequest {
     pub vision: Option<bool>,
     #[serde(skip_serializing_if = "Option::is_none")]
     pub verbose: Option<bool>,
+    /// When true, return only subtrees changed since the previous capture
+    /// of this session (unchanged subtrees are elided via subtree hashes)
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub delta: Option<bool>,
 }
 
 impl DebugUiRequest {
@@ -1451,6 +1568,9 @@ pub struct UiStats {
     pub vision_nodes: usize,
     pub merged_nodes: usize,
     pub latency_ms: u64,
+    /// Nodes elided from a delta capture because their subtree was unchanged
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub unchanged_nodes: Option<usize>,
 }
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -1683,6 +1803,7 @@ mod write_tests {
             id: None,
             vision: None,
             verbose: None,
+            delta: None,
         };
         assert!(req.validate().is_err());
     }
@@ -1696,6 +1817,7 @@ mod write_tests {
                 vision_nodes: 0,
                 merged_nodes: 0,
                 latency_ms: 12,
+                unchanged_nodes: None,
             }),
         };
         let json = serde_json::to_value(&resp).unwrap();
@@ -2410,6 +2532,13 @@ mod event_type_filter_tests {
         let filter: EventTypeFilter = serde_json::from_value(json).unwrap();
         assert!(matches!(filter, EventTypeFilter::ConditionError));
     }
+
+    #[test]
+    fn test_event_type_filter_aggregate_summary() {
+        let json = serde_json::json!("aggregate_summary");
+        let filter: EventTypeFilter = serde_json::from_value(json).unwrap();
+        assert!(matches!(filter, EventTypeFilter::AggregateSummary));
+    }
 }
 
 #[cfg(test)]
@@ -2426,6 +2555,16 @@ mod query_pagination_tests {
         assert_eq!(req.after_event_id, Some(42));
     }
 
+    #[test]
+    fn test_query_request_with_before_event_id() {
+        let json = serde_json::json!({
+            "sessionId": "s1",
+            "beforeEventId": 42
+        });
+        let req: DebugQueryRequest = serde_json::from_value(json).unwrap();
+        assert_eq!(req.before_event_id, Some(42));
+    }
+
     #[test]
     fn test_query_response_has_cursor_fields() {
         let resp = DebugQueryResponse {
@@ -2434,11 +2573,13 @@ mod query_pagination_tests {
             has_more: false,
             pids: None,
             last_event_id: Some(99),
+            first_event_id: Some(7),
             events_dropped: Some(false),
             crash: None,
         };
         let json = serde_json::to_value(&resp).unwrap();
         assert_eq!(json["lastEventId"], 99);
+        assert_eq!(json["firstEventId"], 7);
         assert_eq!(json["eventsDropped"], false);
     }
 }
@@ -2606,6 +2747,18 @@ mod session_consolidation_tests {
         assert!(req.validate().is_err());
     }
 
+    #[test]
+    fn test_session_resume_requires_session_id() {
+        let json = serde_json::json!({ "action": "resume" });
+        let req: DebugSessionRequest = serde_json::from_value(json).unwrap();
+        assert_eq!(req.action, SessionAction::Resume);
+        assert!(req.validate().is_err());
+
+        let json = serde_json::json!({ "action": "resume", "sessionId": "s1" });
+        let req: DebugSessionRequest = serde_json::from_value(json).unwrap();
+        assert!(req.validate().is_ok());
+    }
+
     #[test]
     fn test_session_stop_with_retain() {
         let json = serde_json::json!({ "action": "stop", "sessionId": "s1", "retain": true });
@@ -2656,4 +2809,43 @@ mod session_consolidation_tests {
         // file/line should be omitted (skip_serializing_if)
         assert!(json.get("file").is_none());
     }
+
+    #[test]
+    fn test_debug_profile_request_validation() {
+        let valid = DebugProfileRequest {
+            session_id: "test".to_string(),
+            duration_ms: Some(5000),
+            frequency_hz: Some(99),
+        };
+        assert!(valid.validate().is_ok());
+
+        // Defaults (both None) are always valid
+        let defaults = DebugProfileRequest {
+            session_id: "test".to_string(),
+            duration_ms: None,
+            frequency_hz: None,
+        };
+        assert!(defaults.validate().is_ok());
+
+        let too_long = DebugProfileRequest {
+            session_id: "test".to_string(),
+            duration_ms: Some(MAX_PROFILE_DURATION_MS + 1),
+            frequency_hz: None,
+        };
+        assert!(too_long.validate().is_err());
+
+        let too_fast = DebugProfileRequest {
+            session_id: "test".to_string(),
+            duration_ms: None,
+            frequency_hz: Some(MAX_PROFILE_FREQUENCY_HZ + 1),
+        };
+        assert!(too_fast.validate().is_err());
+
+        let zero_hz = DebugProfileRequest {
+            session_id: "test".to_string(),
+            duration_ms: None,
+            frequency_hz: Some(0),
+        };
+        assert!(zero_hz.validate().is_err());
+    }
 }
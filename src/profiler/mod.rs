@@ -0,0 +1,311 @@
+//! Wall-clock sampling profiler with folded-stack (flame graph) output.
+//!
+//! Samples a process's thread stacks at a configurable frequency, aggregates
+//! identical stacks daemon-side, and emits folded-stack lines
+//! (`frame;frame;frame count`) that paste directly into flamegraph.pl or
+//! speedscope. Used by the `debug_profile` MCP tool to find hot functions
+//! *before* choosing trace patterns, instead of burning the event budget on
+//! guess-trace-refine loops.
+//!
+//! On Linux, sampling goes through `perf_event_open` ([`perf_linux`]):
+//! user-space-only task-clock sampling of the daemon's own (same-uid) spawned
+//! process, which works unprivileged up to `perf_event_paranoid = 2`. When
+//! even that is locked down (paranoid 3, hardened kernels) the error says so
+//! explicitly instead of returning an empty report. On macOS the `sample`
+//! tool path from the stuck detector is reused. Frames that come back as raw
+//! hex addresses are runtime addresses — [`symbolize_report`] subtracts the
+//! ASLR slide before resolving them through the session's DWARF index.
+
+use std::collections::HashMap;
+use std::time::{Duration, Instant};
+
+use crate::dwarf::DwarfParser;
+use crate::test::stacks;
+
+#[cfg(target_os = "linux")]
+mod perf_linux;
+
+/// Aggregated result of one profiling run.
+#[derive(Debug, Clone)]
+pub struct ProfileReport {
+    /// Number of sampling rounds that completed (each round captures all threads).
+    pub samples: u64,
+    /// Folded stacks with sample counts, hottest first.
+    pub folded: Vec<(String, u64)>,
+}
+
+/// Sample `pid` for `duration_ms` at `frequency_hz` via `perf_event_open`
+/// and aggregate the captured user-space callchains. Stops early if the
+/// process exits. Fails with an actionable error when the kernel refuses
+/// unprivileged perf (see the module docs) — callers should surface that
+/// message rather than an empty report.
+#[cfg(target_os = "linux")]
+pub async fn profile_process(
+    pid: u32,
+    duration_ms: u32,
+    frequency_hz: u32,
+) -> crate::Result<ProfileReport> {
+    let mut sampler =
+        perf_linux::PerfSampler::start(pid, frequency_hz).map_err(|e| perf_start_error(e, pid))?;
+    let deadline = Instant::now() + Duration::from_millis(u64::from(duration_ms));
+
+    let mut counts: HashMap<String, u64> = HashMap::new();
+    let mut samples = 0u64;
+    let mut aggregate = |frames: &[u64]| {
+        samples += 1;
+        if frames.is_empty() {
+            return;
+        }
+        let stack: Vec<String> = frames.iter().map(|a| format!("{a:#x}")).collect();
+        *counts.entry(fold_stack(&stack)).or_insert(0) += 1;
+    };
+
+    loop {
+        let remaining = deadline.saturating_duration_since(Instant::now());
+        if remaining.is_zero() {
+            break;
+        }
+        tokio::time::sleep(remaining.min(Duration::from_millis(50))).await;
+        sampler.drain(&mut aggregate);
+        if !stacks::is_process_alive(pid) {
+            break;
+        }
+    }
+    sampler.drain(&mut aggregate);
+    drop(aggregate);
+
+    let mut folded: Vec<(String, u64)> = counts.into_iter().collect();
+    folded.sort_by(|a, b| b.1.cmp(&a.1).then_with(|| a.0.cmp(&b.0)));
+
+    Ok(ProfileReport { samples, folded })
+}
+
+/// Map a perf_event_open failure to guidance the user can act on.
+#[cfg(target_os = "linux")]
+fn perf_start_error(e: std::io::Error, pid: u32) -> crate::Error {
+    match e.raw_os_error() {
+        Some(libc::ESRCH) => crate::Error::Frida(format!(
+            "Process {} exited before profiling could start. Check status with debug_session.",
+            pid
+        )),
+        Some(libc::EACCES) | Some(libc::EPERM) => crate::Error::Frida(
+            "perf_event_open denied by the kernel. Unprivileged profiling needs \
+             /proc/sys/kernel/perf_event_paranoid <= 2 (sysctl kernel.perf_event_paranoid=2) \
+             or CAP_PERFMON on the daemon."
+                .to_string(),
+        ),
+        _ => crate::Error::Frida(format!("perf_event_open failed: {}", e)),
+    }
+}
+
+/// Sample `pid` for `duration_ms` at (up to) `frequency_hz` and aggregate the
+/// captured stacks. Stops early if the process exits. The effective rate is
+/// bounded by how fast the platform's stack capture runs — on macOS the
+/// `sample` tool takes ~1s per invocation, so the requested frequency is a
+/// ceiling, not a guarantee.
+#[cfg(not(target_os = "linux"))]
+pub async fn profile_process(
+    pid: u32,
+    duration_ms: u32,
+    frequency_hz: u32,
+) -> crate::Result<ProfileReport> {
+    let interval = Duration::from_micros(1_000_000 / u64::from(frequency_hz.max(1)))
+        .max(Duration::from_millis(1));
+    let deadline = Instant::now() + Duration::from_millis(u64::from(duration_ms));
+
+    let mut counts: HashMap<String, u64> = HashMap::new();
+    let mut samples = 0u64;
+
+    while Instant::now() < deadline {
+        let round_start = Instant::now();
+        let thread_stacks = tokio::task::spawn_blocking(move || stacks::capture_native_stacks(pid))
+            .await
+            .unwrap_or_default();
+
+        if thread_stacks.is_empty() && !stacks::is_process_alive(pid) {
+            break;
+        }
+
+        for thread in &thread_stacks {
+            if thread.stack.is_empty() {
+                continue;
+            }
+            *counts.entry(fold_stack(&thread.stack)).or_insert(0) += 1;
+        }
+        samples += 1;
+
+        let elapsed = round_start.elapsed();
+        if elapsed < interval {
+            tokio::time::sleep(interval - elapsed).await;
+        }
+    }
+
+    let mut folded: Vec<(String, u64)> = counts.into_iter().collect();
+    folded.sort_by(|a, b| b.1.cmp(&a.1).then_with(|| a.0.cmp(&b.0)));
+
+    Ok(ProfileReport { samples, folded })
+}
+
+/// ASLR slide for `pid`'s main binary: lowest mapped address of `binary_path`
+/// in /proc/<pid>/maps minus the binary's static image base. Returns 0 when
+/// either side is unavailable (non-PIE binaries, process gone, non-Linux),
+/// which leaves runtime addresses unadjusted — the safe no-op.
+#[cfg(target_os = "linux")]
+pub fn runtime_slide(pid: u32, binary_path: &std::path::Path) -> u64 {
+    let maps = match std::fs::read_to_string(format!("/proc/{}/maps", pid)) {
+        Ok(m) => m,
+        Err(_) => return 0,
+    };
+    let want = binary_path.to_string_lossy();
+    let mut lowest: Option<u64> = None;
+    for line in maps.lines() {
+        if line.split_whitespace().nth(5) != Some(want.as_ref()) {
+            continue;
+        }
+        let start = line
+            .split('-')
+            .next()
+            .and_then(|s| u64::from_str_radix(s, 16).ok());
+        if let Some(start) = start {
+            lowest = Some(lowest.map_or(start, |l| l.min(start)));
+        }
+    }
+    match lowest {
+        Some(load_base) => {
+            let static_base = DwarfParser::extract_image_base(binary_path).unwrap_or(0);
+            load_base.wrapping_sub(static_base)
+        }
+        None => 0,
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+pub fn runtime_slide(_pid: u32, _binary_path: &std::path::Path) -> u64 {
+    0
+}
+
+/// Resolve raw hex address frames (`0x...`) in a report to function names via
+/// the DWARF index. Sampled addresses are runtime addresses, so `slide` is
+/// subtracted before lookup (see [`runtime_slide`]). Frames that are already
+/// symbolic, or that fall outside any known function, pass through unchanged.
+pub fn symbolize_report(report: &mut ProfileReport, dwarf: &DwarfParser, slide: u64) {
+    for (stack, _count) in &mut report.folded {
+        if !stack.contains("0x") {
+            continue;
+        }
+        let symbolized: Vec<String> = stack
+            .split(';')
+            .map(|frame| {
+                parse_hex_frame(frame)
+                    .and_then(|addr| dwarf.function_at_address(addr.wrapping_sub(slide)))
+                    .map(|f| f.name.clone())
+                    .unwrap_or_else(|| frame.to_string())
+            })
+            .collect();
+        *stack = symbolized.join(";");
+    }
+}
+
+/// Join a captured stack into a folded line. Capture order is leaf-first;
+/// folded-stack format wants root-first, so the frames are reversed.
+fn fold_stack(frames: &[String]) -> String {
+    frames
+        .iter()
+        .rev()
+        .map(|f| clean_frame(f))
+        .collect::<Vec<_>>()
+        .join(";")
+}
+
+/// Normalize one frame for folding: strip the `[<hex>] ` prefix that
+/// /proc/<pid>/task/<tid>/stack emits, and replace `;` (the fold separator)
+/// so a pathological frame can't split the line.
+fn clean_frame(frame: &str) -> String {
+    let frame = frame.trim();
+    let frame = match frame.strip_prefix("[<") {
+        Some(rest) => rest.split_once(">] ").map(|(_, f)| f).unwrap_or(frame),
+        None => frame,
+    };
+    frame.replace(';', ":")
+}
+
+/// Parse a frame that is a bare hex address (`0x1234`). Anything else — symbol
+/// names, `func+0x10/0x20` kernel frames — returns None.
+fn parse_hex_frame(frame: &str) -> Option<u64> {
+    let hex = frame.strip_prefix("0x")?;
+    u64::from_str_radix(hex, 16).ok()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_fold_stack_reverses_to_root_first() {
+        let frames = vec![
+            "leaf_fn".to_string(),
+            "mid_fn".to_string(),
+            "main".to_string(),
+        ];
+        assert_eq!(fold_stack(&frames), "main;mid_fn;leaf_fn");
+    }
+
+    #[test]
+    fn test_clean_frame_strips_proc_stack_prefix() {
+        assert_eq!(
+            clean_frame("[<0>] futex_wait+0x91/0x170"),
+            "futex_wait+0x91/0x170"
+        );
+        assert_eq!(clean_frame("  do_work  "), "do_work");
+    }
+
+    #[test]
+    fn test_clean_frame_escapes_fold_separator() {
+        assert_eq!(clean_frame("ns;evil"), "ns:evil");
+    }
+
+    #[test]
+    fn test_parse_hex_frame() {
+        assert_eq!(parse_hex_frame("0x1f40"), Some(0x1f40));
+        assert_eq!(parse_hex_frame("futex_wait+0x91/0x170"), None);
+        assert_eq!(parse_hex_frame("main"), None);
+    }
+
+    #[tokio::test]
+    async fn test_profile_dead_process_fails_fast() {
+        // A PID above the kernel's pid_max never exists. On Linux
+        // perf_event_open reports ESRCH immediately; elsewhere the sampler
+        // bails out with an empty report instead of spinning.
+        let result = profile_process(i32::MAX as u32, 5_000, 100).await;
+        #[cfg(target_os = "linux")]
+        assert!(result.unwrap_err().to_string().contains("exited"));
+        #[cfg(not(target_os = "linux"))]
+        {
+            let report = result.unwrap();
+            assert_eq!(report.samples, 0);
+            assert!(report.folded.is_empty());
+        }
+    }
+
+    #[cfg(target_os = "linux")]
+    #[tokio::test]
+    async fn test_profile_busy_child_captures_userspace_samples() {
+        let mut child = std::process::Command::new("sh")
+            .arg("-c")
+            .arg("while :; do :; done")
+            .spawn()
+            .unwrap();
+
+        let result = profile_process(child.id(), 400, 499).await;
+        child.kill().ok();
+        child.wait().ok();
+
+        let report = result.unwrap();
+        assert!(report.samples > 0, "busy loop produced no samples");
+        // exclude_kernel is set: every frame must be a user-space address,
+        // never a `func+0x..` kernel-text frame.
+        for (stack, _) in &report.folded {
+            assert!(stack.starts_with("0x"), "unexpected frame in {stack}");
+        }
+    }
+}
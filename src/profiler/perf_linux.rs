@@ -0,0 +1,246 @@
+//! perf_event_open-based user-space CPU sampler (Linux).
+//!
+//! One software task-clock counter per CPU, attached to the target pid with
+//! `inherit` set so threads spawned after attach are sampled too. Kernel
+//! samples are excluded, which keeps the whole setup inside the unprivileged
+//! `perf_event_paranoid <= 2` envelope — the daemon spawned the target, so
+//! it is same-uid. Callchains come from the kernel's user frame-pointer
+//! walk; binaries built without frame pointers yield truncated chains, the
+//! same limit every fp-based profiler has.
+
+use std::io;
+
+const PERF_TYPE_SOFTWARE: u32 = 1;
+const PERF_COUNT_SW_TASK_CLOCK: u64 = 1;
+
+const PERF_SAMPLE_IP: u64 = 1 << 0;
+const PERF_SAMPLE_TID: u64 = 1 << 1;
+const PERF_SAMPLE_CALLCHAIN: u64 = 1 << 5;
+
+const PERF_RECORD_SAMPLE: u32 = 9;
+
+/// Callchain entries at or above this value are context markers
+/// (PERF_CONTEXT_USER etc.), not addresses.
+const PERF_CONTEXT_MAX: u64 = -4095i64 as u64;
+
+const PERF_FLAG_FD_CLOEXEC: u64 = 8;
+const PERF_ATTR_SIZE_VER5: u32 = 112;
+
+/// attr.flags bits (perf_event_attr bitfield, LSB first).
+const ATTR_INHERIT: u64 = 1 << 1;
+const ATTR_EXCLUDE_KERNEL: u64 = 1 << 5;
+const ATTR_EXCLUDE_HV: u64 = 1 << 6;
+const ATTR_FREQ: u64 = 1 << 10;
+
+/// Data pages per ring (must be a power of two). 16 × 4KiB absorbs several
+/// seconds of callchain samples at the default 99Hz between drains.
+const DATA_PAGES: usize = 16;
+
+/// Offsets into `struct perf_event_mmap_page` (stable ABI).
+const MMAP_DATA_HEAD: usize = 1024;
+const MMAP_DATA_TAIL: usize = 1032;
+
+/// perf_event_attr up through PERF_ATTR_SIZE_VER5. The bitfield word is a
+/// plain u64 (`flags`); only whole-bit flags from the constants above are
+/// used, so no cross-field packing concerns.
+#[repr(C)]
+struct PerfEventAttr {
+    type_: u32,
+    size: u32,
+    config: u64,
+    /// union with sample_period; ATTR_FREQ selects the frequency meaning.
+    sample_freq: u64,
+    sample_type: u64,
+    read_format: u64,
+    flags: u64,
+    /// union with wakeup_watermark.
+    wakeup_events: u32,
+    bp_type: u32,
+    bp_addr: u64,
+    bp_len: u64,
+    branch_sample_type: u64,
+    sample_regs_user: u64,
+    sample_stack_user: u32,
+    clockid: i32,
+    sample_regs_intr: u64,
+    aux_watermark: u32,
+    sample_max_stack: u16,
+    __reserved_2: u16,
+}
+
+fn perf_event_open(attr: &PerfEventAttr, pid: i32, cpu: i32) -> io::Result<i32> {
+    let fd = unsafe {
+        libc::syscall(
+            libc::SYS_perf_event_open,
+            attr as *const PerfEventAttr,
+            pid,
+            cpu,
+            -1i32,
+            PERF_FLAG_FD_CLOEXEC,
+        )
+    };
+    if fd < 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(fd as i32)
+    }
+}
+
+/// One per-CPU counter with its mmap'd sample ring.
+struct CpuRing {
+    fd: i32,
+    map: *mut u8,
+    map_len: usize,
+}
+
+// The mapping is only touched from the owning drain calls.
+unsafe impl Send for CpuRing {}
+
+impl Drop for CpuRing {
+    fn drop(&mut self) {
+        unsafe {
+            libc::munmap(self.map as *mut libc::c_void, self.map_len);
+            libc::close(self.fd);
+        }
+    }
+}
+
+pub struct PerfSampler {
+    rings: Vec<CpuRing>,
+    page_size: usize,
+}
+
+impl PerfSampler {
+    /// Attach frequency-based callchain sampling to every CPU for `pid`.
+    /// Offline CPUs are skipped; failing to open on all of them is an error.
+    pub fn start(pid: u32, frequency_hz: u32) -> io::Result<PerfSampler> {
+        let page_size = unsafe { libc::sysconf(libc::_SC_PAGESIZE) } as usize;
+        let ncpu = unsafe { libc::sysconf(libc::_SC_NPROCESSORS_CONF) }.max(1) as i32;
+
+        let mut attr: PerfEventAttr = unsafe { std::mem::zeroed() };
+        attr.type_ = PERF_TYPE_SOFTWARE;
+        attr.size = PERF_ATTR_SIZE_VER5;
+        attr.config = PERF_COUNT_SW_TASK_CLOCK;
+        attr.sample_freq = u64::from(frequency_hz.max(1));
+        attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_CALLCHAIN;
+        attr.flags = ATTR_INHERIT | ATTR_EXCLUDE_KERNEL | ATTR_EXCLUDE_HV | ATTR_FREQ;
+        attr.sample_max_stack = 64;
+
+        let map_len = (1 + DATA_PAGES) * page_size;
+        let mut rings = Vec::new();
+        let mut last_err = io::Error::from_raw_os_error(libc::ENODEV);
+
+        for cpu in 0..ncpu {
+            let fd = match perf_event_open(&attr, pid as i32, cpu) {
+                Ok(fd) => fd,
+                Err(e) => {
+                    last_err = e;
+                    continue;
+                }
+            };
+            let map = unsafe {
+                libc::mmap(
+                    std::ptr::null_mut(),
+                    map_len,
+                    libc::PROT_READ | libc::PROT_WRITE,
+                    libc::MAP_SHARED,
+                    fd,
+                    0,
+                )
+            };
+            if map == libc::MAP_FAILED {
+                last_err = io::Error::last_os_error();
+                unsafe { libc::close(fd) };
+                continue;
+            }
+            rings.push(CpuRing {
+                fd,
+                map: map as *mut u8,
+                map_len,
+            });
+        }
+
+        if rings.is_empty() {
+            return Err(last_err);
+        }
+        Ok(PerfSampler { rings, page_size })
+    }
+
+    /// Consume every pending PERF_RECORD_SAMPLE, invoking `on_sample` with the
+    /// user-space callchain (leaf first; may be empty when the frame-pointer
+    /// walk found nothing beyond context markers — the sample IP still counts).
+    pub fn drain(&mut self, mut on_sample: impl FnMut(&[u64])) {
+        let data_size = (DATA_PAGES * self.page_size) as u64;
+        let mut frames: Vec<u64> = Vec::with_capacity(64);
+        let mut record: Vec<u8> = Vec::new();
+
+        for ring in &self.rings {
+            let data = unsafe { ring.map.add(self.page_size) };
+            let head =
+                unsafe { std::ptr::read_volatile(ring.map.add(MMAP_DATA_HEAD) as *const u64) };
+            std::sync::atomic::fence(std::sync::atomic::Ordering::Acquire);
+            let mut tail =
+                unsafe { std::ptr::read_volatile(ring.map.add(MMAP_DATA_TAIL) as *const u64) };
+
+            while tail < head {
+                let mut header = [0u8; 8];
+                copy_wrapped(data, data_size, tail, &mut header);
+                let rec_type = u32::from_ne_bytes(header[0..4].try_into().unwrap());
+                let rec_size = u16::from_ne_bytes(header[6..8].try_into().unwrap()) as u64;
+                if rec_size < 8 {
+                    // Corrupt header — drop the rest of this ring's backlog.
+                    tail = head;
+                    break;
+                }
+                if rec_type == PERF_RECORD_SAMPLE {
+                    record.resize((rec_size - 8) as usize, 0);
+                    copy_wrapped(data, data_size, tail + 8, &mut record);
+                    if let Some(()) = parse_sample(&record, &mut frames) {
+                        on_sample(&frames);
+                    }
+                }
+                tail += rec_size;
+            }
+
+            std::sync::atomic::fence(std::sync::atomic::Ordering::Release);
+            unsafe { std::ptr::write_volatile(ring.map.add(MMAP_DATA_TAIL) as *mut u64, tail) };
+        }
+    }
+}
+
+/// Copy `out.len()` bytes starting at ring offset `from`, handling wraparound.
+fn copy_wrapped(data: *const u8, data_size: u64, from: u64, out: &mut [u8]) {
+    let start = (from % data_size) as usize;
+    let first = out.len().min(data_size as usize - start);
+    unsafe {
+        std::ptr::copy_nonoverlapping(data.add(start), out.as_mut_ptr(), first);
+        if first < out.len() {
+            std::ptr::copy_nonoverlapping(data, out.as_mut_ptr().add(first), out.len() - first);
+        }
+    }
+}
+
+/// Decode a PERF_RECORD_SAMPLE payload for sample_type IP|TID|CALLCHAIN:
+/// `{ u64 ip; u32 pid, tid; u64 nr; u64 ips[nr]; }`. Fills `frames` with the
+/// user-space addresses (context markers filtered), falling back to the
+/// sample IP when the chain is empty. None means a malformed record.
+fn parse_sample(payload: &[u8], frames: &mut Vec<u64>) -> Option<()> {
+    let ip = u64::from_ne_bytes(payload.get(0..8)?.try_into().ok()?);
+    let nr = u64::from_ne_bytes(payload.get(16..24)?.try_into().ok()?);
+    if nr > 512 || payload.len() < 24 + (nr as usize) * 8 {
+        return None;
+    }
+    frames.clear();
+    for i in 0..nr as usize {
+        let off = 24 + i * 8;
+        let addr = u64::from_ne_bytes(payload[off..off + 8].try_into().ok()?);
+        if addr >= PERF_CONTEXT_MAX || addr < 0x1000 {
+            continue;
+        }
+        frames.push(addr);
+    }
+    if frames.is_empty() && ip >= 0x1000 && ip < PERF_CONTEXT_MAX {
+        frames.push(ip);
+    }
+    Some(())
+}
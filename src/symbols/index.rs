@@ -0,0 +1,300 @@
+//! Persistent incremental symbol index for interpreted-language resolvers.
+//!
+//! `JsResolver` and `PythonResolver` used to re-scan every source file on
+//! each construction — 20+ seconds in a large monorepo, repeated from
+//! scratch for every session. This module keeps a per-project, per-language
+//! index of extracted function tables keyed by file mtime + size, stored
+//! under `~/.strobe/symbol-index/` next to the daemon's other state.
+//! Building a resolver becomes: walk the tree, stat each file, re-extract
+//! only files whose identity changed, persist the refreshed index. A stat
+//! pass over 12k files is milliseconds; the extraction (regex scan or
+//! rustpython parse) is what the index avoids.
+//!
+//! Everything here is best-effort: any I/O or format problem is a cache
+//! miss, never an error.
+
+use serde::{Deserialize, Serialize};
+use std::collections::hash_map::DefaultHasher;
+use std::collections::{HashMap, HashSet};
+use std::hash::{Hash, Hasher};
+use std::path::{Path, PathBuf};
+
+/// Bump when the on-disk layout or the cached entries change shape.
+/// Old-version files are treated as misses and overwritten.
+const INDEX_FORMAT_VERSION: u32 = 1;
+
+/// Cached extraction result for one source file.
+///
+/// `functions` holds (name, def_line, body_first_line) as produced by the
+/// language's extractor, unqualified — module/path qualification is cheap
+/// and is re-applied by the resolver on assembly. JS stores body_first_line
+/// equal to def_line.
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct FileEntry {
+    mtime_secs: u64,
+    size: u64,
+    pub functions: Vec<(String, u32, u32)>,
+}
+
+#[derive(Serialize, Deserialize)]
+struct IndexFile {
+    version: u32,
+    language: String,
+    project_root: String,
+    files: HashMap<PathBuf, FileEntry>,
+}
+
+/// Per-project, per-language symbol index with mtime-based invalidation.
+pub struct SymbolIndex {
+    path: Option<PathBuf>,
+    files: HashMap<PathBuf, FileEntry>,
+    /// Files confirmed fresh or re-extracted in this build pass — entries
+    /// not in this set belong to deleted files and are dropped on save.
+    seen: HashSet<PathBuf>,
+    dirty: bool,
+}
+
+/// (mtime seconds, size) of a file, or None if it can't be stat'd.
+pub fn file_identity(path: &Path) -> Option<(u64, u64)> {
+    let meta = std::fs::metadata(path).ok()?;
+    let mtime = meta
+        .modified()
+        .ok()?
+        .duration_since(std::time::UNIX_EPOCH)
+        .ok()?
+        .as_secs();
+    Some((mtime, meta.len()))
+}
+
+fn default_index_dir() -> Option<PathBuf> {
+    dirs::home_dir().map(|h| h.join(".strobe").join("symbol-index"))
+}
+
+/// Index file path for a project root. The name combines the root's
+/// directory name (for human inspection of the index dir) with a hash of
+/// the full path, so distinct projects with the same name don't collide.
+fn index_path(dir: &Path, project_root: &Path, language: &str) -> PathBuf {
+    let mut hasher = DefaultHasher::new();
+    project_root.hash(&mut hasher);
+    let stem = project_root
+        .file_name()
+        .map(|s| s.to_string_lossy().into_owned())
+        .unwrap_or_else(|| "project".to_string());
+    dir.join(format!(
+        "{}-{:016x}.{}.json",
+        stem,
+        hasher.finish(),
+        language
+    ))
+}
+
+impl SymbolIndex {
+    /// Load the index for a project root, or start empty on any miss.
+    pub fn open(project_root: &Path, language: &str) -> Self {
+        let path = default_index_dir().map(|dir| index_path(&dir, project_root, language));
+        let files = path
+            .as_deref()
+            .and_then(|p| Self::load_files(p, project_root, language))
+            .unwrap_or_default();
+        Self {
+            path,
+            files,
+            seen: HashSet::new(),
+            dirty: false,
+        }
+    }
+
+    /// In-memory index without persistence (for testing).
+    #[cfg(test)]
+    pub fn ephemeral() -> Self {
+        Self {
+            path: None,
+            files: HashMap::new(),
+            seen: HashSet::new(),
+            dirty: false,
+        }
+    }
+
+    fn load_files(
+        path: &Path,
+        project_root: &Path,
+        language: &str,
+    ) -> Option<HashMap<PathBuf, FileEntry>> {
+        let bytes = std::fs::read(path).ok()?;
+        let index: IndexFile = serde_json::from_slice(&bytes).ok()?;
+        if index.version != INDEX_FORMAT_VERSION
+            || index.language != language
+            || index.project_root != project_root.to_string_lossy()
+        {
+            return None;
+        }
+        Some(index.files)
+    }
+
+    /// Return the cached extraction for `path` if its identity still matches,
+    /// marking it as seen. A changed, missing, or unknown file returns None
+    /// and the caller re-extracts.
+    pub fn get_if_fresh(&mut self, path: &Path) -> Option<&FileEntry> {
+        let (mtime_secs, size) = file_identity(path)?;
+        let entry = self.files.get(path)?;
+        if entry.mtime_secs != mtime_secs || entry.size != size {
+            return None;
+        }
+        self.seen.insert(path.to_path_buf());
+        self.files.get(path)
+    }
+
+    /// Record a fresh extraction for `path`.
+    pub fn update(&mut self, path: &Path, functions: Vec<(String, u32, u32)>) {
+        let Some((mtime_secs, size)) = file_identity(path) else {
+            return;
+        };
+        self.seen.insert(path.to_path_buf());
+        self.files.insert(
+            path.to_path_buf(),
+            FileEntry {
+                mtime_secs,
+                size,
+                functions,
+            },
+        );
+        self.dirty = true;
+    }
+
+    /// Persist the index, dropping entries for files that no longer exist
+    /// (anything not touched during this build pass). No-op when nothing
+    /// changed, so warm rebuilds don't rewrite the file.
+    pub fn save(mut self, project_root: &Path, language: &str) {
+        let before = self.files.len();
+        self.files.retain(|path, _| self.seen.contains(path));
+        if !self.dirty && self.files.len() == before {
+            return;
+        }
+        let Some(path) = self.path else {
+            return;
+        };
+        let Some(dir) = path.parent() else {
+            return;
+        };
+        if std::fs::create_dir_all(dir).is_err() {
+            return;
+        }
+
+        let index = IndexFile {
+            version: INDEX_FORMAT_VERSION,
+            language: language.to_string(),
+            project_root: project_root.to_string_lossy().into_owned(),
+            files: self.files,
+        };
+        let Ok(bytes) = serde_json::to_vec(&index) else {
+            return;
+        };
+        // Write to a temp file and rename so a crashed daemon never leaves a
+        // truncated index behind.
+        let tmp = path.with_extension("json.tmp");
+        if std::fs::write(&tmp, bytes).is_ok() {
+            let _ = std::fs::rename(&tmp, &path);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn touch(path: &Path, contents: &str) {
+        std::fs::write(path, contents).unwrap();
+    }
+
+    #[test]
+    fn test_fresh_entry_roundtrip() {
+        let dir = tempfile::tempdir().unwrap();
+        let file = dir.path().join("a.js");
+        touch(&file, "function foo() {}");
+
+        let mut index = SymbolIndex::ephemeral();
+        assert!(index.get_if_fresh(&file).is_none(), "cold index misses");
+
+        index.update(&file, vec![("foo".to_string(), 1, 1)]);
+        let entry = index.get_if_fresh(&file).expect("warm index hits");
+        assert_eq!(entry.functions, vec![("foo".to_string(), 1, 1)]);
+    }
+
+    #[test]
+    fn test_changed_file_invalidates() {
+        let dir = tempfile::tempdir().unwrap();
+        let file = dir.path().join("a.js");
+        touch(&file, "function foo() {}");
+
+        let mut index = SymbolIndex::ephemeral();
+        index.update(&file, vec![("foo".to_string(), 1, 1)]);
+
+        // Same mtime granularity is seconds — change the size too.
+        touch(&file, "function foo() {}\nfunction bar() {}");
+        assert!(
+            index.get_if_fresh(&file).is_none(),
+            "size change must invalidate"
+        );
+    }
+
+    #[test]
+    fn test_persistence_roundtrip_and_deleted_file_pruning() {
+        let home = tempfile::tempdir().unwrap();
+        let root = tempfile::tempdir().unwrap();
+        let kept = root.path().join("kept.js");
+        let deleted = root.path().join("deleted.js");
+        touch(&kept, "function a() {}");
+        touch(&deleted, "function b() {}");
+
+        let index_file = index_path(home.path(), root.path(), "js");
+
+        let mut index = SymbolIndex {
+            path: Some(index_file.clone()),
+            files: HashMap::new(),
+            seen: HashSet::new(),
+            dirty: false,
+        };
+        index.update(&kept, vec![("a".to_string(), 1, 1)]);
+        index.update(&deleted, vec![("b".to_string(), 1, 1)]);
+        index.save(root.path(), "js");
+        assert!(index_file.exists());
+
+        std::fs::remove_file(&deleted).unwrap();
+
+        // Second pass: kept is fresh, deleted is never seen → pruned on save.
+        let mut index = SymbolIndex {
+            path: Some(index_file.clone()),
+            files: SymbolIndex::load_files(&index_file, root.path(), "js").unwrap(),
+            seen: HashSet::new(),
+            dirty: false,
+        };
+        assert!(index.get_if_fresh(&kept).is_some(), "reloaded entry hits");
+        index.save(root.path(), "js");
+
+        let files = SymbolIndex::load_files(&index_file, root.path(), "js").unwrap();
+        assert!(files.contains_key(&kept));
+        assert!(!files.contains_key(&deleted), "deleted file pruned");
+    }
+
+    #[test]
+    fn test_wrong_language_or_root_misses() {
+        let home = tempfile::tempdir().unwrap();
+        let root = tempfile::tempdir().unwrap();
+        let file = root.path().join("a.py");
+        touch(&file, "def f():\n    pass\n");
+
+        let index_file = index_path(home.path(), root.path(), "py");
+        let mut index = SymbolIndex {
+            path: Some(index_file.clone()),
+            files: HashMap::new(),
+            seen: HashSet::new(),
+            dirty: false,
+        };
+        index.update(&file, vec![("f".to_string(), 1, 2)]);
+        index.save(root.path(), "py");
+
+        assert!(SymbolIndex::load_files(&index_file, root.path(), "js").is_none());
+        assert!(SymbolIndex::load_files(&index_file, Path::new("/elsewhere"), "py").is_none());
+        assert!(SymbolIndex::load_files(&index_file, root.path(), "py").is_some());
+    }
+}
@@ -1,3 +1,4 @@
+use super::index::SymbolIndex;
 use super::resolver::*;
 use regex::Regex;
 use std::collections::HashMap;
@@ -193,6 +194,10 @@ pub struct JsResolver {
 
 impl JsResolver {
     pub fn from_project(root: &Path) -> crate::Result<Self> {
+        // Persistent index: unchanged files (by mtime + size) reuse their
+        // cached function tables instead of being re-scanned. In a large
+        // monorepo this turns a multi-second regex pass into a stat pass.
+        let mut index = SymbolIndex::open(root, "js");
         let mut functions = FunctionTable::new();
         let mut source_maps = HashMap::new();
 
@@ -213,8 +218,18 @@ impl JsResolver {
             let path = entry.path();
             let ext = path.extension().and_then(|e| e.to_str()).unwrap_or("");
             if JS_EXTENSIONS.contains(&ext) {
-                if let Ok(src) = std::fs::read_to_string(path) {
+                if let Some(cached) = index.get_if_fresh(path) {
+                    for (name, line, _) in &cached.functions {
+                        functions.insert(name.clone(), (path.to_path_buf(), *line));
+                    }
+                } else if let Ok(src) = std::fs::read_to_string(path) {
                     let fns = extract_functions_from_source(&src, path)?;
+                    index.update(
+                        path,
+                        fns.iter()
+                            .map(|(name, (_, line))| (name.clone(), *line, *line))
+                            .collect(),
+                    );
                     functions.extend(fns);
                 }
             }
@@ -228,6 +243,8 @@ impl JsResolver {
             }
         }
 
+        index.save(root, "js");
+
         Ok(Self {
             functions,
             source_maps,
@@ -519,6 +536,25 @@ const typed = <T>(x: T): T => x;
         assert_eq!(util_fns.len(), 1);
     }
 
+    // ── Unit: incremental index ───────────────────────────────────────
+    #[test]
+    fn test_rebuild_picks_up_changed_files() {
+        let dir = tempfile::tempdir().unwrap();
+        let file = dir.path().join("app.js");
+        std::fs::write(&file, "function first() {}\n").unwrap();
+
+        let resolver = JsResolver::from_project(dir.path()).unwrap();
+        assert_eq!(resolver.function_count(), 1);
+
+        // Second build goes through the persistent index; the changed file
+        // must be re-extracted, not served stale.
+        std::fs::write(&file, "function first() {}\nfunction second() {}\n").unwrap();
+        let resolver = JsResolver::from_project(dir.path()).unwrap();
+        assert_eq!(resolver.function_count(), 2);
+        let hits = resolver.resolve_pattern("second", dir.path()).unwrap();
+        assert_eq!(hits.len(), 1);
+    }
+
     // ── Unit: source map resolution ───────────────────────────────────
     #[test]
     fn test_sourcemap_resolution() {
@@ -1,5 +1,6 @@
 mod demangle;
 pub mod dwarf_resolver;
+pub mod index;
 pub mod js_resolver;
 pub mod python_resolver;
 pub mod resolver;
@@ -3,6 +3,7 @@ use std::collections::HashMap;
 use std::path::{Path, PathBuf};
 use walkdir::WalkDir;
 
+use super::index::SymbolIndex;
 use super::resolver::*;
 
 pub struct PythonResolver {
@@ -191,7 +192,13 @@ fn extract_from_stmt(
 
 impl PythonResolver {
     /// Parse all .py files in project_root.
+    ///
+    /// Extraction results are cached per file (mtime + size) in the shared
+    /// symbol index, so only changed files pay the rustpython parse cost on
+    /// repeat builds. The index stores unqualified names; module
+    /// qualification derives from the relative path and is re-applied here.
     pub fn parse(project_root: &Path) -> crate::Result<Self> {
+        let mut index = SymbolIndex::open(project_root, "py");
         let mut all_functions = HashMap::new();
 
         for entry in WalkDir::new(project_root)
@@ -204,27 +211,39 @@ impl PythonResolver {
         {
             let path = entry.path();
             if path.extension().and_then(|e| e.to_str()) == Some("py") {
-                match std::fs::read_to_string(path) {
-                    Ok(source) => {
-                        if let Ok(fns) = extract_functions_from_source(&source, path) {
-                            // Qualify with module path relative to project_root
-                            let rel = path.strip_prefix(project_root).unwrap_or(path);
-                            let module_path = python_module_path(rel);
-                            for (name, (file, def_line, body_line)) in fns {
-                                let qualified = if module_path.is_empty() {
-                                    name
-                                } else {
-                                    format!("{}.{}", module_path, name)
-                                };
-                                all_functions.insert(qualified, (file, def_line, body_line));
-                            }
-                        }
-                    }
-                    Err(_) => continue,
+                let fns: Vec<(String, u32, u32)> = if let Some(cached) = index.get_if_fresh(path) {
+                    cached.functions.clone()
+                } else {
+                    let Ok(source) = std::fs::read_to_string(path) else {
+                        continue;
+                    };
+                    let Ok(extracted) = extract_functions_from_source(&source, path) else {
+                        continue;
+                    };
+                    let fns: Vec<_> = extracted
+                        .into_iter()
+                        .map(|(name, (_, def_line, body_line))| (name, def_line, body_line))
+                        .collect();
+                    index.update(path, fns.clone());
+                    fns
+                };
+
+                // Qualify with module path relative to project_root
+                let rel = path.strip_prefix(project_root).unwrap_or(path);
+                let module_path = python_module_path(rel);
+                for (name, def_line, body_line) in fns {
+                    let qualified = if module_path.is_empty() {
+                        name
+                    } else {
+                        format!("{}.{}", module_path, name)
+                    };
+                    all_functions.insert(qualified, (path.to_path_buf(), def_line, body_line));
                 }
             }
         }
 
+        index.save(project_root, "py");
+
         Ok(Self {
             functions: all_functions,
         })
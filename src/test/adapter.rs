@@ -181,6 +181,23 @@ pub trait TestAdapter: Send + Sync {
         )))
     }
 
+    /// Enumerate individual test names from a test binary, for sharded execution.
+    /// Override for binary-based adapters that can list tests (Catch2, GTest).
+    fn list_tests(&self, _cmd: &str) -> crate::Result<Vec<String>> {
+        Err(crate::Error::ValidationError(format!(
+            "{} does not support test enumeration (required for sharding)",
+            self.name()
+        )))
+    }
+
+    /// Build a command that runs exactly the given subset of tests (one shard).
+    fn shard_command(&self, _cmd: &str, _tests: &[String]) -> crate::Result<TestCommand> {
+        Err(crate::Error::ValidationError(format!(
+            "{} does not support sharded execution",
+            self.name()
+        )))
+    }
+
     /// Safety-net timeout — per-test tracking via stuck detector is the primary mechanism.
     /// This only fires if something goes catastrophically wrong.
     fn default_timeout(&self, _level: Option<TestLevel>) -> u64 {
@@ -212,6 +212,42 @@ impl TestAdapter for Catch2Adapter {
             remove_env: vec![],
         })
     }
+
+    fn list_tests(&self, cmd: &str) -> crate::Result<Vec<String>> {
+        let output = std::process::Command::new(cmd)
+            .arg("--list-test-names-only")
+            .output()
+            .map_err(|e| {
+                crate::Error::Frida(format!("Failed to list tests from '{}': {}", cmd, e))
+            })?;
+        // Catch2 v2 reports the test count via the exit code, so don't check
+        // status — any non-empty stdout is a valid listing.
+        Ok(String::from_utf8_lossy(&output.stdout)
+            .lines()
+            .map(|l| l.trim())
+            .filter(|l| !l.is_empty())
+            .map(String::from)
+            .collect())
+    }
+
+    fn shard_command(&self, cmd: &str, tests: &[String]) -> crate::Result<TestCommand> {
+        let mut args = vec!["--reporter".to_string(), "xml".to_string()];
+        // Each name is its own quoted test spec — Catch2 ORs multiple specs,
+        // and quoting keeps names containing ',' or '[' from being parsed as
+        // spec syntax.
+        args.extend(
+            tests
+                .iter()
+                .map(|name| format!("\"{}\"", name.replace('"', "\\\""))),
+        );
+        Ok(TestCommand {
+            program: cmd.to_string(),
+            args,
+            env: HashMap::new(),
+            cwd: None,
+            remove_env: vec![],
+        })
+    }
 }
 
 /// Parse Catch2 XML reporter output into TestResult.
@@ -487,4 +523,20 @@ mod tests {
         assert_eq!(f.line, Some(18));
         assert!(f.message.contains("nullptr == 0x42"));
     }
+
+    #[test]
+    fn test_shard_command_quotes_specs() {
+        let adapter = Catch2Adapter;
+        let tests = vec![
+            "Addition works".to_string(),
+            "Parser handles [brackets], commas".to_string(),
+        ];
+        let cmd = adapter.shard_command("/path/to/tests", &tests).unwrap();
+        assert_eq!(cmd.program, "/path/to/tests");
+        assert_eq!(cmd.args[0], "--reporter");
+        assert_eq!(cmd.args[1], "xml");
+        // Names are quoted so ',' and '[' aren't parsed as spec syntax
+        assert_eq!(cmd.args[2], "\"Addition works\"");
+        assert_eq!(cmd.args[3], "\"Parser handles [brackets], commas\"");
+    }
 }
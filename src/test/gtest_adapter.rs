@@ -184,6 +184,26 @@ impl TestAdapter for GTestAdapter {
     fn single_test_for_binary(&self, cmd: &str, test_name: &str) -> crate::Result<TestCommand> {
         Ok(GTestAdapter::single_test_for_binary(cmd, test_name))
     }
+
+    fn list_tests(&self, cmd: &str) -> crate::Result<Vec<String>> {
+        let output = std::process::Command::new(cmd)
+            .arg("--gtest_list_tests")
+            .output()
+            .map_err(|e| {
+                crate::Error::Frida(format!("Failed to list tests from '{}': {}", cmd, e))
+            })?;
+        Ok(parse_gtest_test_list(&String::from_utf8_lossy(
+            &output.stdout,
+        )))
+    }
+
+    fn shard_command(&self, cmd: &str, tests: &[String]) -> crate::Result<TestCommand> {
+        let mut command = GTestAdapter::command_for_binary(cmd, None);
+        command
+            .args
+            .push(format!("--gtest_filter={}", tests.join(":")));
+        Ok(command)
+    }
 }
 
 impl GTestAdapter {
@@ -213,6 +233,33 @@ impl GTestAdapter {
     }
 }
 
+/// Parse `--gtest_list_tests` output into fully-qualified test names.
+///
+/// Format: suite lines are unindented and end with '.' (possibly followed by
+/// a `# TypeParam = ...` comment); test lines are indented (possibly followed
+/// by a `# GetParam() = ...` comment). Preamble lines like "Running main()
+/// from gmock_main.cc" have no trailing '.' and are skipped.
+fn parse_gtest_test_list(output: &str) -> Vec<String> {
+    let mut tests = Vec::new();
+    let mut current_suite: Option<String> = None;
+
+    for line in output.lines() {
+        let without_comment = line.split('#').next().unwrap_or("").trim_end();
+        if without_comment.trim().is_empty() {
+            continue;
+        }
+        if line.starts_with(' ') {
+            if let Some(suite) = &current_suite {
+                tests.push(format!("{}{}", suite, without_comment.trim()));
+            }
+        } else if without_comment.ends_with('.') {
+            current_suite = Some(without_comment.trim().to_string());
+        }
+    }
+
+    tests
+}
+
 /// Parse GTest JSON output (from --gtest_output=json) into TestResult.
 /// Returns None if the output is not valid GTest JSON.
 fn parse_gtest_json(stdout: &str) -> Option<TestResult> {
@@ -653,6 +700,40 @@ mod tests {
             .contains(&"--gtest_filter=MathTest.Addition".to_string()));
     }
 
+    #[test]
+    fn test_parse_gtest_test_list() {
+        let output = "Running main() from gmock_main.cc\n\
+                      MathTest.\n\
+                      \x20\x20Addition\n\
+                      \x20\x20Subtraction\n\
+                      Params/ValueTest.\n\
+                      \x20\x20Works/0  # GetParam() = 4\n\
+                      TypedTest/0.  # TypeParam = int\n\
+                      \x20\x20DoesBlah\n";
+        let tests = parse_gtest_test_list(output);
+        assert_eq!(
+            tests,
+            vec![
+                "MathTest.Addition",
+                "MathTest.Subtraction",
+                "Params/ValueTest.Works/0",
+                "TypedTest/0.DoesBlah",
+            ]
+        );
+    }
+
+    #[test]
+    fn test_shard_command_joins_filter() {
+        let adapter = GTestAdapter;
+        let tests = vec!["MathTest.Addition".to_string(), "MathTest.Sub".to_string()];
+        let cmd = adapter
+            .shard_command("/path/to/test_binary", &tests)
+            .unwrap();
+        assert!(cmd
+            .args
+            .contains(&"--gtest_filter=MathTest.Addition:MathTest.Sub".to_string()));
+    }
+
     #[test]
     fn test_text_fallback() {
         let adapter = GTestAdapter;
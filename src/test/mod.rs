@@ -698,6 +698,398 @@ impl TestRunner {
             raw_stderr: stderr_buf,
         })
     }
+
+    /// Run a test suite split into N shards as parallel Frida-spawned processes.
+    ///
+    /// Tests are enumerated through the adapter (Catch2 and GTest can list),
+    /// distributed round-robin, and each shard runs under its own Strobe
+    /// session — shard 0 keeps `base_session_id`, shard i gets
+    /// `{base_session_id}-s{i}` — so events stay tagged by shard PID. Each
+    /// shard gets its own stuck detector; one hung shard reports without
+    /// masking progress in the rest. Results are merged after all shards
+    /// finish, with raw output concatenated under per-shard headers.
+    pub async fn run_sharded(
+        &self,
+        project_root: &Path,
+        framework: Option<&str>,
+        level: Option<TestLevel>,
+        command: Option<&str>,
+        env: &HashMap<String, String>,
+        timeout: Option<u64>,
+        session_manager: &Arc<crate::daemon::SessionManager>,
+        trace_patterns: &[String],
+        shards: u32,
+        base_session_id: &str,
+        progress: Arc<Mutex<TestProgress>>,
+    ) -> crate::Result<TestRunResult> {
+        let adapter = self.detect_adapter(project_root, framework, command)?;
+        let framework_name = adapter.name().to_string();
+
+        let cmd = command.ok_or_else(|| {
+            crate::Error::ValidationError(
+                "Sharded execution requires 'command' (test binary path)".to_string(),
+            )
+        })?;
+
+        let tests = adapter.list_tests(cmd)?;
+        if tests.is_empty() {
+            return Err(crate::Error::ValidationError(format!(
+                "'{}' listed no tests — cannot shard",
+                cmd
+            )));
+        }
+
+        let shard_count = (shards as usize).min(tests.len()).max(1);
+        let shard_tests = partition_round_robin(&tests, shard_count);
+
+        // Timeout priority: explicit param > settings.json > adapter default
+        let settings = crate::config::resolve(Some(project_root));
+        let hard_timeout = timeout
+            .or(settings.test_timeout_ms)
+            .unwrap_or_else(|| adapter.default_timeout(level));
+
+        let program = resolve_program(cmd);
+
+        // Inherit parent environment, then overlay user-provided vars.
+        // Per-shard command env is overlaid inside run_shard.
+        let mut base_env: HashMap<String, String> = std::env::vars().collect();
+        base_env.extend(env.clone());
+
+        // Only binary-based adapters reach this point — select their updaters.
+        let progress_fn: Option<fn(&str, &Arc<Mutex<TestProgress>>)> = match framework_name.as_str()
+        {
+            "catch2" => Some(catch2_adapter::update_progress),
+            "gtest" => Some(gtest_adapter::update_progress),
+            _ => None,
+        };
+
+        tracing::info!(
+            "Sharding {} tests across {} processes ({})",
+            tests.len(),
+            shard_count,
+            framework_name
+        );
+
+        let mut join_set = tokio::task::JoinSet::new();
+        for (shard_index, shard) in shard_tests.into_iter().enumerate() {
+            let shard_cmd = adapter.shard_command(cmd, &shard)?;
+            let session_id = if shard_index == 0 {
+                base_session_id.to_string()
+            } else {
+                format!("{}-s{}", base_session_id, shard_index)
+            };
+            join_set.spawn(run_shard(
+                Arc::clone(session_manager),
+                shard_index,
+                session_id,
+                program.clone(),
+                shard_cmd,
+                project_root.to_path_buf(),
+                base_env.clone(),
+                trace_patterns.to_vec(),
+                hard_timeout,
+                progress_fn,
+                Arc::clone(&progress),
+            ));
+        }
+
+        // Wait for ALL shards before propagating any error — aborting early
+        // would leave sibling processes running unsupervised.
+        let mut shard_outputs: Vec<ShardOutput> = Vec::new();
+        let mut first_error: Option<crate::Error> = None;
+        while let Some(joined) = join_set.join_next().await {
+            match joined {
+                Ok(Ok(output)) => shard_outputs.push(output),
+                Ok(Err(e)) => {
+                    if first_error.is_none() {
+                        first_error = Some(e);
+                    }
+                }
+                Err(e) => {
+                    if first_error.is_none() {
+                        first_error =
+                            Some(crate::Error::Frida(format!("Shard task panicked: {}", e)));
+                    }
+                }
+            }
+        }
+        if let Some(e) = first_error {
+            return Err(e);
+        }
+        shard_outputs.sort_by_key(|s| s.index);
+
+        // Mark suites finished in progress
+        {
+            let mut p = progress.lock().unwrap();
+            if p.phase != TestPhase::SuitesFinished {
+                p.phase = TestPhase::SuitesFinished;
+            }
+        }
+
+        let mut result: Option<TestResult> = None;
+        let mut raw_stdout = String::new();
+        let mut raw_stderr = String::new();
+        for output in &shard_outputs {
+            let shard_result =
+                adapter.parse_output(&output.stdout, &output.stderr, output.exit_code);
+            let header = format!("\n=== shard {} (pid {}) ===\n", output.index, output.pid);
+            raw_stdout.push_str(&header);
+            raw_stdout.push_str(&output.stdout);
+            raw_stderr.push_str(&header);
+            raw_stderr.push_str(&output.stderr);
+            result = Some(match result {
+                None => shard_result,
+                Some(mut acc) => {
+                    merge_shard_results(&mut acc, shard_result);
+                    acc
+                }
+            });
+        }
+        let mut result = result.expect("at least one shard ran");
+
+        for failure in &mut result.failures {
+            if failure.suggested_traces.is_empty() {
+                failure.suggested_traces = adapter.suggest_traces(failure);
+            }
+        }
+
+        Ok(TestRunResult {
+            framework: framework_name,
+            result,
+            session_id: Some(base_session_id.to_string()),
+            raw_stdout,
+            raw_stderr,
+        })
+    }
+}
+
+/// Output of one completed shard, parsed and merged by `run_sharded`.
+struct ShardOutput {
+    index: usize,
+    pid: u32,
+    stdout: String,
+    stderr: String,
+    exit_code: i32,
+}
+
+/// Distribute tests across shards round-robin, so long suites that enumerate
+/// related tests consecutively don't all land in the same shard.
+fn partition_round_robin(tests: &[String], shard_count: usize) -> Vec<Vec<String>> {
+    let n = shard_count.max(1);
+    let mut shards: Vec<Vec<String>> = vec![Vec::new(); n];
+    for (i, test) in tests.iter().enumerate() {
+        shards[i % n].push(test.clone());
+    }
+    shards
+}
+
+/// Fold one shard's parsed results into the accumulated totals.
+fn merge_shard_results(acc: &mut TestResult, other: TestResult) {
+    acc.summary.passed += other.summary.passed;
+    acc.summary.failed += other.summary.failed;
+    acc.summary.skipped += other.summary.skipped;
+    acc.summary.duration_ms += other.summary.duration_ms;
+    acc.summary.stuck = match (acc.summary.stuck, other.summary.stuck) {
+        (None, None) => None,
+        (a, b) => Some(a.unwrap_or(0) + b.unwrap_or(0)),
+    };
+    acc.failures.extend(other.failures);
+    acc.stuck.extend(other.stuck);
+    acc.all_tests.extend(other.all_tests);
+}
+
+/// Decode a waitpid status into the exit-code convention used by parse_output
+/// (signal deaths map to 128 + signo).
+fn decode_wait_status(status: i32) -> i32 {
+    if libc::WIFEXITED(status) {
+        libc::WEXITSTATUS(status)
+    } else if libc::WIFSIGNALED(status) {
+        128 + libc::WTERMSIG(status)
+    } else {
+        -1
+    }
+}
+
+/// Spawn and supervise a single shard: own session, own stuck detector, own
+/// DB polling loop feeding the shared progress tracker.
+async fn run_shard(
+    session_manager: Arc<crate::daemon::SessionManager>,
+    index: usize,
+    session_id: String,
+    program: String,
+    cmd: TestCommand,
+    project_root: std::path::PathBuf,
+    mut env: HashMap<String, String>,
+    trace_patterns: Vec<String>,
+    hard_timeout: u64,
+    progress_fn: Option<fn(&str, &Arc<Mutex<TestProgress>>)>,
+    progress: Arc<Mutex<TestProgress>>,
+) -> crate::Result<ShardOutput> {
+    for key in &cmd.remove_env {
+        env.remove(key);
+    }
+    env.extend(cmd.env.clone());
+
+    let root = project_root.to_str().unwrap_or(".");
+    session_manager.create_session(&session_id, &cmd.program, root, 0)?;
+
+    let has_trace_patterns = !trace_patterns.is_empty();
+    let spawn_cwd = cmd.cwd.as_deref().unwrap_or(root);
+    let pid = session_manager
+        .spawn_with_frida(
+            &session_id,
+            &program,
+            &cmd.args,
+            Some(spawn_cwd),
+            root,
+            Some(&env),
+            has_trace_patterns, // defer_resume: install hooks before running
+            None,
+        )
+        .await?;
+
+    if has_trace_patterns {
+        session_manager.add_patterns(&session_id, &trace_patterns)?;
+        match session_manager
+            .update_frida_patterns(&session_id, Some(&trace_patterns), None, None)
+            .await
+        {
+            Ok(result) => {
+                session_manager.set_hook_count(&session_id, result.installed);
+            }
+            Err(e) => {
+                tracing::warn!("Failed to apply trace patterns for shard {}: {}", index, e);
+            }
+        }
+        session_manager.resume_process(pid).await?;
+    }
+
+    // Per-shard stuck detector — shares the progress tracker so warnings merge
+    let detector_progress = Arc::clone(&progress);
+    let mut detector = StuckDetector::new(pid, hard_timeout, detector_progress);
+    {
+        let paused = session_manager.paused_threads_ref();
+        let sid = session_id.clone();
+        detector = detector.with_pause_check(Arc::new(move || {
+            paused
+                .read()
+                .unwrap_or_else(|e| e.into_inner())
+                .get(&sid)
+                .map_or(false, |m| !m.is_empty())
+        }));
+    }
+    let detector_handle = tokio::spawn(async move { detector.run().await });
+
+    let mut last_seen_timestamp_ns: i64 = 0;
+    let poll_interval = std::time::Duration::from_millis(500);
+    let kill_timeout = std::time::Duration::from_millis(hard_timeout + 5_000);
+    let start = std::time::Instant::now();
+    let mut reaped_status: Option<i32> = None;
+
+    loop {
+        let process_alive = stacks::is_process_alive(pid);
+
+        let mut reaped = false;
+        {
+            let mut status: i32 = 0;
+            let wp = unsafe { libc::waitpid(pid as i32, &mut status, libc::WNOHANG) };
+            if wp > 0 {
+                reaped_status = Some(status);
+                reaped = true;
+            }
+        }
+
+        if start.elapsed() > kill_timeout {
+            stacks::kill_process_tree(pid);
+            tokio::time::sleep(std::time::Duration::from_millis(100)).await;
+            break;
+        }
+
+        if let Some(update_fn) = progress_fn {
+            let mut new_events = session_manager
+                .db()
+                .query_events(&session_id, |q| {
+                    let mut q = q.text_output().limit(500);
+                    if last_seen_timestamp_ns > 0 {
+                        q.timestamp_from_ns = Some(last_seen_timestamp_ns + 1);
+                    }
+                    q
+                })
+                .unwrap_or_default();
+            new_events.reverse();
+            for event in &new_events {
+                if event.timestamp_ns > last_seen_timestamp_ns {
+                    last_seen_timestamp_ns = event.timestamp_ns;
+                }
+                if let Some(text) = &event.text {
+                    update_fn(text, &progress);
+                }
+            }
+        }
+
+        // Exit check AFTER the progress poll so the last events aren't missed
+        if !process_alive || reaped {
+            break;
+        }
+
+        tokio::time::sleep(poll_interval).await;
+    }
+
+    detector_handle.abort();
+
+    // Let the DB writer flush, then drain remaining text events
+    tokio::time::sleep(std::time::Duration::from_millis(200)).await;
+    if let Some(update_fn) = progress_fn {
+        let mut remaining = session_manager
+            .db()
+            .query_events(&session_id, |q| {
+                let mut q = q.text_output().limit_uncapped(5000);
+                if last_seen_timestamp_ns > 0 {
+                    q.timestamp_from_ns = Some(last_seen_timestamp_ns + 1);
+                }
+                q
+            })
+            .unwrap_or_default();
+        remaining.reverse();
+        for event in &remaining {
+            if let Some(text) = &event.text {
+                update_fn(text, &progress);
+            }
+        }
+    }
+
+    let stdout = collect_output(
+        session_manager.db(),
+        &session_id,
+        crate::db::EventType::Stdout,
+    );
+    let stderr = collect_output(
+        session_manager.db(),
+        &session_id,
+        crate::db::EventType::Stderr,
+    );
+
+    let exit_code = match reaped_status {
+        Some(status) => decode_wait_status(status),
+        None => {
+            let mut s: i32 = 0;
+            let r = unsafe { libc::waitpid(pid as i32, &mut s, libc::WNOHANG) };
+            if r > 0 {
+                decode_wait_status(s)
+            } else {
+                // Not our child or already reaped — let parse_output decide from results
+                0
+            }
+        }
+    };
+
+    Ok(ShardOutput {
+        index,
+        pid,
+        stdout,
+        stderr,
+        exit_code,
+    })
 }
 
 /// Resolve a program name to an absolute path via PATH lookup.
@@ -994,6 +1386,57 @@ mod tests {
         assert_eq!(run.session_id.as_deref(), Some("session-xyz"));
     }
 
+    #[test]
+    fn test_partition_round_robin() {
+        let tests: Vec<String> = (0..5).map(|i| format!("test_{}", i)).collect();
+        let shards = partition_round_robin(&tests, 2);
+        assert_eq!(shards.len(), 2);
+        assert_eq!(shards[0], vec!["test_0", "test_2", "test_4"]);
+        assert_eq!(shards[1], vec!["test_1", "test_3"]);
+    }
+
+    #[test]
+    fn test_merge_shard_results() {
+        let mut acc = TestResult {
+            summary: TestSummary {
+                passed: 3,
+                failed: 1,
+                skipped: 0,
+                stuck: None,
+                duration_ms: 100,
+            },
+            failures: vec![TestFailure {
+                name: "a".to_string(),
+                file: None,
+                line: None,
+                message: "boom".to_string(),
+                rerun: None,
+                suggested_traces: vec![],
+            }],
+            stuck: vec![],
+            all_tests: vec![],
+        };
+        let other = TestResult {
+            summary: TestSummary {
+                passed: 2,
+                failed: 0,
+                skipped: 1,
+                stuck: Some(1),
+                duration_ms: 50,
+            },
+            failures: vec![],
+            stuck: vec![],
+            all_tests: vec![],
+        };
+        merge_shard_results(&mut acc, other);
+        assert_eq!(acc.summary.passed, 5);
+        assert_eq!(acc.summary.failed, 1);
+        assert_eq!(acc.summary.skipped, 1);
+        assert_eq!(acc.summary.stuck, Some(1));
+        assert_eq!(acc.summary.duration_ms, 150);
+        assert_eq!(acc.failures.len(), 1);
+    }
+
     #[test]
     fn test_progress_warnings() {
         let mut progress = TestProgress::new();
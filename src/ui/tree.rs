@@ -1,4 +1,5 @@
 use serde::{Deserialize, Serialize};
+use std::collections::HashMap;
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
 #[serde(rename_all = "camelCase")]
@@ -164,6 +165,63 @@ pub fn count_nodes(nodes: &[UiNode]) -> usize {
     nodes.iter().map(|n| 1 + count_nodes(&n.children)).sum()
 }
 
+fn fnv1a(hash: &mut u64, bytes: &[u8]) {
+    for byte in bytes {
+        *hash ^= *byte as u64;
+        *hash = hash.wrapping_mul(0x100000001b3);
+    }
+}
+
+/// Stable hash over a node's observable fields and its entire subtree.
+/// Two captures of an unchanged subtree produce the same hash, so delta
+/// captures can skip re-emitting it. Bounds are excluded — they jitter by
+/// a pixel on some toolkits without any semantic change (same rationale
+/// as `diff_nodes`).
+pub fn subtree_hash(node: &UiNode) -> u64 {
+    let mut hash: u64 = 0xcbf29ce484222325;
+    fnv1a(&mut hash, node.id.as_bytes());
+    fnv1a(&mut hash, node.role.as_bytes());
+    fnv1a(&mut hash, node.title.as_deref().unwrap_or("").as_bytes());
+    fnv1a(&mut hash, node.value.as_deref().unwrap_or("").as_bytes());
+    fnv1a(&mut hash, &[node.enabled as u8, node.focused as u8]);
+    for child in &node.children {
+        fnv1a(&mut hash, &subtree_hash(child).to_le_bytes());
+    }
+    hash
+}
+
+/// Record the subtree hash of every node in the forest, keyed by node ID.
+pub fn collect_subtree_hashes(nodes: &[UiNode], out: &mut HashMap<String, u64>) {
+    for node in nodes {
+        out.insert(node.id.clone(), subtree_hash(node));
+        collect_subtree_hashes(&node.children, out);
+    }
+}
+
+/// Prune subtrees whose hash matches the previous capture, keeping only
+/// changed nodes and the ancestors needed to locate them. Returns the
+/// delta forest and the number of unchanged nodes elided.
+pub fn prune_unchanged(
+    nodes: &[UiNode],
+    prev_hashes: &HashMap<String, u64>,
+) -> (Vec<UiNode>, usize) {
+    let mut kept = Vec::new();
+    let mut elided = 0;
+    for node in nodes {
+        if prev_hashes.get(&node.id) == Some(&subtree_hash(node)) {
+            elided += 1 + count_nodes(&node.children);
+            continue;
+        }
+        let (children, child_elided) = prune_unchanged(&node.children, prev_hashes);
+        elided += child_elided;
+        kept.push(UiNode {
+            children,
+            ..node.clone()
+        });
+    }
+    (kept, elided)
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -374,6 +432,73 @@ mod tests {
         assert!(diff_nodes(&before, &after));
     }
 
+    #[test]
+    fn test_subtree_hash_stable_and_ignores_bounds() {
+        let tree = sample_tree();
+        let h1 = subtree_hash(&tree[0]);
+        let h2 = subtree_hash(&tree[0].clone());
+        assert_eq!(h1, h2, "same tree → same hash");
+
+        let mut moved = tree[0].clone();
+        moved.children[0].bounds = Some(Rect {
+            x: 11.0,
+            y: 5.0,
+            w: 80.0,
+            h: 30.0,
+        });
+        assert_eq!(h1, subtree_hash(&moved), "bounds jitter must not dirty");
+
+        let mut changed = tree[0].clone();
+        changed.children[1].value = Some("0.9".to_string());
+        assert_ne!(h1, subtree_hash(&changed), "child value change propagates");
+    }
+
+    #[test]
+    fn test_prune_unchanged_returns_delta() {
+        let before = sample_tree();
+        let mut prev = HashMap::new();
+        collect_subtree_hashes(&before, &mut prev);
+
+        // Identical capture: everything elided
+        let (delta, elided) = prune_unchanged(&before, &prev);
+        assert!(delta.is_empty());
+        assert_eq!(elided, 3);
+
+        // Knob value changes: window kept as ancestor, button elided
+        let mut after = before.clone();
+        after[0].children[1].value = Some("0.9".to_string());
+        let (delta, elided) = prune_unchanged(&after, &prev);
+        assert_eq!(delta.len(), 1);
+        assert_eq!(delta[0].id, "w_0001");
+        assert_eq!(delta[0].children.len(), 1);
+        assert_eq!(delta[0].children[0].id, "knb_c3d4");
+        assert_eq!(elided, 1, "only the unchanged button is elided");
+    }
+
+    #[test]
+    fn test_prune_unchanged_keeps_new_nodes() {
+        let before = sample_tree();
+        let mut prev = HashMap::new();
+        collect_subtree_hashes(&before, &mut prev);
+
+        let mut after = before.clone();
+        after[0].children.push(UiNode {
+            id: "lbl_9999".to_string(),
+            role: "staticText".to_string(),
+            title: Some("New".to_string()),
+            value: None,
+            enabled: true,
+            focused: false,
+            bounds: None,
+            actions: vec![],
+            source: NodeSource::Ax,
+            children: vec![],
+        });
+        let (delta, _) = prune_unchanged(&after, &prev);
+        assert_eq!(delta[0].children.len(), 1);
+        assert_eq!(delta[0].children[0].id, "lbl_9999");
+    }
+
     #[test]
     fn test_find_node_by_id_root() {
         let tree = sample_tree();
@@ -862,6 +862,7 @@ async fn scenario_watch_variables(
         type_name: recipe.type_name.clone(),
         on_patterns: None,
         no_slide: false,
+        sample_hz: None,
     }];
 
     sm.update_frida_watches(session_id, watch_targets, vec![])
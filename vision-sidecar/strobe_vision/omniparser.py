@@ -91,14 +91,20 @@ class OmniParser:
             # Filter overlapping boxes: keep smaller box when IoU > threshold
             filtered = self._remove_overlap(boxes, iou_threshold)
 
+            # Crop and resize to 64x64 for captioning (matches OmniParser
+            # reference), then caption all crops in batched generate calls —
+            # one crop per call left the GPU mostly idle on busy screens.
+            crops = []
             for box_data in filtered:
                 x1, y1, x2, y2 = box_data['xyxy']
-                conf = box_data['conf']
-
-                # Crop and resize to 64x64 for captioning (matches OmniParser reference)
                 crop = image.crop((int(x1), int(y1), int(x2), int(y2)))
-                crop = crop.resize((64, 64))
-                label, description = self._caption_crop(crop)
+                crops.append(crop.resize((64, 64)))
+
+            captions = self._caption_crops(crops)
+
+            for box_data, (label, description) in zip(filtered, captions):
+                x1, y1, x2, y2 = box_data['xyxy']
+                conf = box_data['conf']
 
                 elements.append(DetectedElement(
                     label=label or "icon",
@@ -153,19 +159,50 @@ class OmniParser:
         ratio2 = intersection / (area2 + 1e-6)
         return max(iou, ratio1, ratio2)
 
-    def _caption_crop(self, crop: Image.Image) -> tuple[str, str]:
-        """Use Florence-2 to caption a cropped UI element."""
+    # Crops per Florence-2 generate call: bounds peak device memory while
+    # keeping the GPU saturated (the crops are only 64x64).
+    CAPTION_BATCH_SIZE = 32
+
+    def _caption_crops(self, crops: list) -> list[tuple[str, str]]:
+        """Caption a list of crops, batched and de-duplicated.
+
+        Toolbars and lists repeat the same icon many times; identical crops
+        are captioned once and the result fanned back out, so icon-heavy
+        screens skip most of the generate work entirely.
+        """
+        if not crops:
+            return []
+
+        unique_index = {}  # crop bytes -> position in unique_crops
+        unique_crops = []
+        positions = []  # for each input crop, its position in results
+        for crop in crops:
+            key = crop.tobytes()
+            if key not in unique_index:
+                unique_index[key] = len(unique_crops)
+                unique_crops.append(crop)
+            positions.append(unique_index[key])
+
+        results = []
+        for start in range(0, len(unique_crops), self.CAPTION_BATCH_SIZE):
+            batch = unique_crops[start:start + self.CAPTION_BATCH_SIZE]
+            results.extend(self._caption_batch(batch))
+
+        return [results[i] for i in positions]
+
+    def _caption_batch(self, crops: list) -> list[tuple[str, str]]:
+        """One Florence-2 generate call over a batch of crops."""
         try:
             import torch
-            prompt = "<CAPTION>"
+            prompts = ["<CAPTION>"] * len(crops)
 
             if self.device != "cpu":
                 inputs = self.caption_processor(
-                    images=crop, text=prompt, return_tensors="pt", do_resize=False
+                    images=crops, text=prompts, return_tensors="pt", do_resize=False
                 ).to(device=self.device, dtype=torch.float16)
             else:
                 inputs = self.caption_processor(
-                    images=crop, text=prompt, return_tensors="pt"
+                    images=crops, text=prompts, return_tensors="pt"
                 ).to(device=self.device)
 
             with torch.no_grad():
@@ -174,18 +211,22 @@ class OmniParser:
                     pixel_values=inputs["pixel_values"],
                     max_new_tokens=20, num_beams=1, do_sample=False
                 )
-            caption = self.caption_processor.batch_decode(
+            captions = self.caption_processor.batch_decode(
                 generated, skip_special_tokens=True
-            )[0].strip()
+            )
 
-            # Extract label (first word) and description (full caption)
-            parts = caption.split()
-            label = parts[0].lower() if parts else "icon"
-            return label, caption
+            results = []
+            for caption in captions:
+                caption = caption.strip()
+                # Extract label (first word) and description (full caption)
+                parts = caption.split()
+                label = parts[0].lower() if parts else "icon"
+                results.append((label, caption))
+            return results
         except Exception as e:
             import sys
             print(f"Caption error: {e}", file=sys.stderr)
-            return "icon", ""
+            return [("icon", "")] * len(crops)
 
     @property
     def is_loaded(self) -> bool: